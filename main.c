@@ -9,56 +9,101 @@
 #endif
 #include "src/core/core.h"
 #include "src/parser/parser.h"
+#include "src/parser/formula_cache.h"
 #include "src/solver/solver.h"
+#include "src/trace/trace.h"
+#include "src/perf/perf_counters.h"
+#include "src/benchmark/cnf_benchmark.h"
 #include "src/percent_sudoku/percent_sudoku.h"
 #include "src/display/gui_display.h"
 
 // 全局变量
 static volatile int timeout_flag = 0;
 static double timeout_seconds = 300.0; // 默认5分钟超时
+static const char* trace_filename = NULL; // --trace 指定的追踪输出文件
 
 // 函数声明
 void print_usage(const char* program_name);
 void print_solution_summary(const Formula* formula, int* assignments, int result, double time_spent);
 void save_solution_to_file(const char* filename, const Formula* formula, int* assignments, int result, double time_spent);
+void build_output_filename(const char* filename, const char* extension, char* output, size_t size);
+void save_statistics_to_file(const char* filename, const Formula* formula, int result, const SolverStatistics* stats,
+                             const PerfReport* perf);
 void print_formula_details(const Formula* formula);
 void timeout_handler(int sig);
 int check_timeout(double start_time);
+int extract_trace_option(int argc, char* argv[]);
+void write_trace_at_exit(void);
 
 // 百分号数独相关函数声明
 void run_percent_sudoku_mode(int argc, char* argv[]);
+int run_cnf_benchmark_mode(int argc, char* argv[]);
 void run_percent_sudoku_generate_mode(int difficulty, double timeout);
 void run_percent_sudoku_solve_mode(const char* puzzle_file, double timeout);
 void run_percent_sudoku_test_mode(void);
 void run_percent_sudoku_demo_mode(void);
 void run_percent_sudoku_gui_mode(int difficulty);
+void run_percent_sudoku_encodings_mode(int difficulty, double timeout);
+void run_percent_sudoku_batch_mode(int argc, char* argv[]);
+void run_percent_sudoku_generate_file_mode(int argc, char* argv[]);
+void run_percent_sudoku_grid_stats_mode(int argc, char* argv[]);
+void run_percent_sudoku_multiply_mode(int argc, char* argv[]);
+void run_percent_sudoku_benchmark_mode(int argc, char* argv[]);
+void run_percent_sudoku_database_mode(int argc, char* argv[]);
 
 int main(int argc, char* argv[]) {
+    // 谜题生成使用的随机数种子只在启动时设置一次
+    srand((unsigned int)time(NULL));
+    
+    // --trace <file> 对所有模式有效：从参数中取出并开始记录，退出时写出追踪文件
+    argc = extract_trace_option(argc, argv);
+    if (trace_filename != NULL) {
+        trace_start();
+        atexit(write_trace_at_exit);
+    }
+    
     // 检查命令行参数
     if (argc < 2) {
         print_usage(argv[0]);
         return 1;
     }
-
+    
     // 检查是否为百分号数独模式
     if (strcmp(argv[1], "--percent-sudoku") == 0) {
         run_percent_sudoku_mode(argc, argv);
         return 0;
     }
-
-    // 原有的CNF求解模式
-    if (argc > 3) {
-        print_usage(argv[0]);
-        return 1;
+    
+    // CNF基准测试模式：有错误结果或性能回退时返回非0
+    if (strcmp(argv[1], "--bench") == 0) {
+        return run_cnf_benchmark_mode(argc, argv) ? 0 : 1;
     }
-
+    
+    // 原有的CNF求解模式
     const char* cnf_filename = argv[1];
+    int use_formula_cache = 1;
+    int show_progress = 0;
+    int use_perf_counters = 0;
+    int positional = 0;
     
-    // 设置超时时间（如果提供）
-    if (argc == 3) {
-        timeout_seconds = atof(argv[2]);
-        if (timeout_seconds <= 0) {
-            fprintf(stderr, "Error: Invalid timeout value\n");
+    // 设置超时时间（如果提供）；--no-cache 关闭预解析公式缓存，--progress 在求解中定期输出进度，
+    // --perf 按阶段统计硬件性能计数器
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--no-cache") == 0) {
+            use_formula_cache = 0;
+        } else if (strcmp(argv[i], "--progress") == 0) {
+            show_progress = 1;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            use_perf_counters = 1;
+        } else if (positional == 0) {
+            timeout_seconds = atof(argv[i]);
+            if (timeout_seconds <= 0) {
+                fprintf(stderr, "Error: Invalid timeout value\n");
+                return 1;
+            }
+            positional++;
+        } else {
+            print_usage(argv[0]);
             return 1;
         }
     }
@@ -76,12 +121,22 @@ int main(int argc, char* argv[]) {
     
     // ⑴ 输入输出功能：读取CNF文件
     printf("Reading CNF file: %s\n", cnf_filename);
-    Formula* formula = parse_cnf_file(cnf_filename);
+    double parse_start = get_monotonic_time_ms();
+    FormulaCacheStatus cache_status;
+    if (use_perf_counters) {
+        perf_counters_start();
+    }
+    TRACE_BEGIN("cnf", "parse");
+    PERF_PHASE(PERF_PHASE_PARSE);
+    Formula* formula = parse_cnf_file_cached(cnf_filename, use_formula_cache, &cache_status);
+    PERF_PHASE(PERF_PHASE_NONE);
+    TRACE_END("cnf", "parse");
     if (formula == NULL) {
         fprintf(stderr, "Error: Cannot parse CNF file %s\n", cnf_filename);
         return 1;
     }
-    printf("✓ CNF file parsed successfully\n");
+    printf("✓ CNF file parsed successfully (%.2f ms, formula cache: %s)\n",
+           get_monotonic_time_ms() - parse_start, formula_cache_status_name(cache_status));
     
     // ⑵ 公式解析与验证：显示解析结果
     printf("\n=== Formula Parsing Results ===\n");
@@ -89,7 +144,9 @@ int main(int argc, char* argv[]) {
     printf("Number of clauses: %d\n", formula->num_clauses);
     
     printf("\n=== Clause Details ===\n");
+    TRACE_BEGIN("cnf", "print_formula");
     print_formula_details(formula);
+    TRACE_END("cnf", "print_formula");
     
     // 创建变量赋值数组
     int* assignments = (int*)calloc(formula->num_vars, sizeof(int));
@@ -111,11 +168,21 @@ int main(int argc, char* argv[]) {
     clock_t begin = clock();
     double start_time = (double)begin / CLOCKS_PER_SEC;
     
-    // ⑶ DPLL过程：调用DPLL算法求解
+    // ⑶ DPLL过程：调用DPLL算法求解（显示进度时关闭逐节点的详细输出）
+    if (show_progress) {
+        set_solver_verbose(0);
+        set_solver_progress(SOLVER_PROGRESS_DEFAULT_CONFLICTS, SOLVER_PROGRESS_DEFAULT_SECONDS);
+    }
+    reset_solver_statistics();
+    set_solver_timeout(timeout_seconds);
     int result = DPLL(formula, assignments);
+    SolverStatistics solver_statistics;
+    get_solver_statistics(&solver_statistics);
+    PerfReport perf_report;
+    perf_counters_stop(&perf_report);
     
-    // 检查是否超时
-    if (check_timeout(start_time)) {
+    // 检查是否超时（到达时限时DPLL直接返回TIMEOUT）
+    if (result == TIMEOUT || check_timeout(start_time)) {
         result = TIMEOUT;
         printf("Solving timed out after %.1f seconds\n", timeout_seconds);
     }
@@ -126,26 +193,95 @@ int main(int argc, char* argv[]) {
     
     printf("\n=== Solving Completed ===\n");
     
-    // 输出求解结果
+    // 输出求解结果（含解的验证）
+    TRACE_BEGIN("cnf", "verify_and_print");
     print_solution_summary(formula, assignments, result, time_spent_ms);
+    TRACE_END("cnf", "verify_and_print");
     
-    // 保存结果到文件
+    printf("\n=== Solver Statistics ===\n");
+    print_solver_statistics(stdout, &solver_statistics);
+    if (use_perf_counters) {
+        printf("\n=== Performance Counters ===\n");
+        print_perf_report(stdout, &perf_report);
+    }
+    
+    // 保存结果与统计到文件
+    TRACE_BEGIN("cnf", "write_result");
     save_solution_to_file(cnf_filename, formula, assignments, result, time_spent_ms);
+    save_statistics_to_file(cnf_filename, formula, result, &solver_statistics,
+                            use_perf_counters ? &perf_report : NULL);
+    TRACE_END("cnf", "write_result");
     
     // 清理内存
     free(assignments);
     free_formula(formula);
     
+    printf("\n=== Memory Usage ===\n");
+    print_memory_report(stdout);
+    
     printf("\nProgram execution completed!\n");
     return 0;
 }
 
+// 运行CNF基准测试模式，全部通过且没有回退时返回1
+int run_cnf_benchmark_mode(int argc, char* argv[]) {
+    CnfBenchmarkOptions options;
+    init_cnf_benchmark_options(&options);
+    const char** inputs = (const char**)safe_malloc(argc * sizeof(const char*));
+    
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            options.output_dir = argv[++i];
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            options.timeout_seconds = atof(argv[++i]);
+            if (options.timeout_seconds <= 0) {
+                printf("Error: Invalid timeout value\n");
+                safe_free(inputs);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            options.repeat = atoi(argv[++i]);
+            if (options.repeat <= 0) {
+                printf("Error: Number of repetitions must be greater than 0\n");
+                safe_free(inputs);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.json_file = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            options.baseline_file = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            options.regression_threshold = atof(argv[++i]) / 100.0;
+            if (options.regression_threshold <= 0) {
+                printf("Error: Regression threshold must be greater than 0 percent\n");
+                safe_free(inputs);
+                return 0;
+            }
+        } else if (argv[i][0] != '-') {
+            inputs[options.num_inputs++] = argv[i];
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            safe_free(inputs);
+            return 0;
+        }
+    }
+    options.inputs = inputs;
+    
+    printf("========================================\n");
+    printf("        SAT Solver - CNF Benchmark\n");
+    printf("========================================\n");
+    
+    int ok = run_cnf_benchmark(&options);
+    safe_free(inputs);
+    return ok;
+}
+
 // 运行百分号数独模式
 void run_percent_sudoku_mode(int argc, char* argv[]) {
     if (argc < 3) {
         printf("Error: Percent Sudoku mode requires a command\n");
         printf("Usage: %s --percent-sudoku <command> [options]\n", argv[0]);
-        printf("Commands: generate, solve, test, demo\n");
+        printf("Commands: generate, generate-file, multiply, grid-stats, solve, batch, benchmark, db-pack, db-unpack, db-get, db-info, encodings, decisions, test, demo\n");
         return;
     }
     
@@ -193,12 +329,52 @@ void run_percent_sudoku_mode(int argc, char* argv[]) {
         
         run_percent_sudoku_solve_mode(puzzle_file, timeout);
         
+    } else if (strcmp(command, "generate-file") == 0) {
+        run_percent_sudoku_generate_file_mode(argc, argv);
+        
+    } else if (strcmp(command, "multiply") == 0) {
+        run_percent_sudoku_multiply_mode(argc, argv);
+        
+    } else if (strcmp(command, "grid-stats") == 0) {
+        run_percent_sudoku_grid_stats_mode(argc, argv);
+        
+    } else if (strcmp(command, "batch") == 0) {
+        run_percent_sudoku_batch_mode(argc, argv);
+        
+    } else if (strncmp(command, "db-", 3) == 0) {
+        run_percent_sudoku_database_mode(argc, argv);
+        
+    } else if (strcmp(command, "benchmark") == 0) {
+        run_percent_sudoku_benchmark_mode(argc, argv);
+        
     } else if (strcmp(command, "test") == 0) {
         run_percent_sudoku_test_mode();
         
     } else if (strcmp(command, "demo") == 0) {
         run_percent_sudoku_demo_mode();
         
+    } else if (strcmp(command, "encodings") == 0) {
+        int difficulty = 3;  // 默认难度
+        if (argc >= 4) {
+            difficulty = atoi(argv[3]);
+            if (difficulty < 1 || difficulty > 5) {
+                printf("Error: Difficulty must be between 1-5\n");
+                return;
+            }
+        }
+        run_percent_sudoku_encodings_mode(difficulty, 60.0);
+        
+    } else if (strcmp(command, "decisions") == 0) {
+        int puzzles = 5;  // 每个难度的谜题数量
+        if (argc >= 4) {
+            puzzles = atoi(argv[3]);
+            if (puzzles <= 0) {
+                printf("Error: Number of puzzles must be greater than 0\n");
+                return;
+            }
+        }
+        measure_extended_encoding_decisions(puzzles, 60.0);
+        
     } else if (strcmp(command, "gui") == 0) {
         int difficulty = 2; // 默认难度
         if (argc > 3) {
@@ -212,7 +388,7 @@ void run_percent_sudoku_mode(int argc, char* argv[]) {
         
     } else {
         printf("Error: Unknown command '%s'\n", command);
-        printf("Available commands: generate, solve, gui, test, demo\n");
+        printf("Available commands: generate, generate-file, multiply, grid-stats, solve, batch, benchmark, db-pack, db-unpack, db-get, db-info, encodings, decisions, gui, test, demo\n");
     }
 }
 
@@ -389,6 +565,403 @@ void run_percent_sudoku_demo_mode(void) {
     printf("\n=== Demo Completed ===\n");
 }
 
+// 运行CNF编码比较模式
+void run_percent_sudoku_encodings_mode(int difficulty, double timeout) {
+    printf("========================================\n");
+    printf("     Percent Sudoku Encoding Benchmark\n");
+    printf("========================================\n\n");
+    
+    PercentSudokuGame* game = generate_percent_sudoku_puzzle(difficulty);
+    if (game == NULL) {
+        printf("Error: Failed to generate Percent Sudoku puzzle\n");
+        return;
+    }
+    
+    printf("Difficulty Level: %d\n", difficulty);
+    printf("Given Numbers: %d\n", game->num_givens);
+    
+    benchmark_cnf_encodings(&game->puzzle, timeout);
+    
+    free_percent_sudoku_game(game);
+}
+
+// 运行谜题文件生成模式（单行格式，每行谜题后附解答）
+// 用法: --percent-sudoku generate-file <count> <difficulty> <output_file> [--threads n] [--seed s] [--variants n]
+void run_percent_sudoku_generate_file_mode(int argc, char* argv[]) {
+    if (argc < 6) {
+        printf("Error: generate-file requires a count, a difficulty and an output file\n");
+        printf("Usage: %s --percent-sudoku generate-file <count> <difficulty> <output_file> [--threads n] [--seed s] [--variants n]\n", argv[0]);
+        return;
+    }
+    
+    GeneratorOptions options;
+    init_generator_options(&options);
+    options.count = atoi(argv[3]);
+    options.difficulty = atoi(argv[4]);
+    options.seed = (uint64_t)time(NULL);
+    const char* output_file = argv[5];
+    
+    if (options.count <= 0) {
+        printf("Error: Number of puzzles must be greater than 0\n");
+        return;
+    }
+    if (options.difficulty < 1 || options.difficulty > 5) {
+        printf("Error: Difficulty must be between 1-5\n");
+        return;
+    }
+    
+    for (int i = 6; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--variants") == 0 && i + 1 < argc) {
+            options.variants = atoi(argv[++i]);
+            if (options.variants <= 0) {
+                printf("Error: Number of variants must be greater than 0\n");
+                return;
+            }
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            return;
+        }
+    }
+    
+    printf("========================================\n");
+    printf("     Percent Sudoku Puzzle File Generator\n");
+    printf("========================================\n\n");
+    
+    GeneratorReport report;
+    int written = generate_puzzle_file(output_file, &options, &report);
+    if (written <= 0) {
+        printf("Error: Failed to write puzzle file %s\n", output_file);
+        return;
+    }
+    
+    print_generator_report(&report, &options);
+    printf("Puzzles saved to: %s\n", output_file);
+}
+
+// 运行谜题扩增模式
+// 用法: --percent-sudoku multiply <input_file> <output_file> <copies> [--seed s]
+void run_percent_sudoku_multiply_mode(int argc, char* argv[]) {
+    if (argc < 6) {
+        printf("Usage: %s --percent-sudoku multiply <input_file> <output_file> <copies> [--seed s]\n", argv[0]);
+        return;
+    }
+    
+    int copies = atoi(argv[5]);
+    uint64_t seed = (uint64_t)time(NULL);
+    if (copies <= 0) {
+        printf("Error: Number of copies must be greater than 0\n");
+        return;
+    }
+    
+    for (int i = 6; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            return;
+        }
+    }
+    
+    MultiplyReport report;
+    if (multiply_puzzle_file(argv[3], argv[4], copies, seed, &report) < 0) {
+        printf("Error: Failed to multiply puzzles\n");
+        return;
+    }
+    print_multiply_report(&report);
+    printf("Puzzles saved to: %s\n", argv[4]);
+}
+
+// 运行完整解答统计模式
+// 用法: --percent-sudoku grid-stats <count> [--seed s]
+void run_percent_sudoku_grid_stats_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        printf("Usage: %s --percent-sudoku grid-stats <count> [--seed s]\n", argv[0]);
+        return;
+    }
+    
+    GeneratorOptions options;
+    init_generator_options(&options);
+    options.count = atoi(argv[3]);
+    options.seed = (uint64_t)time(NULL);
+    
+    if (options.count <= 0) {
+        printf("Error: Number of grids must be greater than 0\n");
+        return;
+    }
+    
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            return;
+        }
+    }
+    
+    GridStatsReport report;
+    if (run_complete_grid_stats(&options, &report) > 0) {
+        print_grid_stats_report(&report, &options);
+    }
+}
+
+// 运行批量求解模式
+// 用法: --percent-sudoku batch <input> [result_file] [--engine name] [--threads n] [--timeout seconds]
+//                                                    [--cache file] [--cache-size n]
+void run_percent_sudoku_batch_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        printf("Error: Batch mode requires a puzzle directory or puzzle file\n");
+        printf("Usage: %s --percent-sudoku batch <input> [result_file] [--engine name] [--threads n] [--timeout seconds] [--cache file] [--cache-size n]\n", argv[0]);
+        return;
+    }
+    
+    const char* input_path = argv[3];
+    const char* result_file = NULL;
+    const char* cache_file = NULL;
+    int cache_size = PUZZLE_CACHE_DEFAULT_CAPACITY;
+    BatchOptions options;
+    init_batch_options(&options);
+    
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            if (!parse_percent_sudoku_engine(argv[++i], &options.engine)) {
+                printf("Error: Unknown engine '%s' (bitmask, dlx, sat, backtrack, simd)\n", argv[i]);
+                return;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.num_threads = atoi(argv[++i]);
+            if (options.num_threads <= 0) {
+                printf("Error: Number of threads must be greater than 0\n");
+                return;
+            }
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            options.timeout_seconds = atof(argv[++i]);
+            if (options.timeout_seconds <= 0) {
+                printf("Error: Timeout must be greater than 0\n");
+                return;
+            }
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_file = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            cache_size = atoi(argv[++i]);
+            if (cache_size <= 0) {
+                printf("Error: Cache size must be greater than 0\n");
+                return;
+            }
+        } else if (argv[i][0] != '-' && result_file == NULL) {
+            result_file = argv[i];
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            return;
+        }
+    }
+    
+    printf("========================================\n");
+    printf("      Percent Sudoku Batch Solver\n");
+    printf("========================================\n\n");
+    
+    // 已解谜题缓存：先加载上次保存的条目，结束后写回
+    if (cache_file != NULL) {
+        options.cache = create_puzzle_cache(cache_size);
+        int loaded = load_puzzle_cache(options.cache, cache_file);
+        if (loaded < 0) {
+            free_puzzle_cache(options.cache);
+            return;
+        }
+        printf("Loaded %d cached puzzles from %s\n", loaded, cache_file);
+    }
+    
+    BatchReport report;
+    if (!run_percent_sudoku_batch(input_path, result_file, &options, &report)) {
+        printf("Error: Batch solving failed\n");
+        free_puzzle_cache(options.cache);
+        return;
+    }
+    
+    print_batch_report(&report, &options);
+    if (result_file != NULL) {
+        printf("Results saved to: %s\n", result_file);
+    }
+    
+    if (options.cache != NULL) {
+        int saved = save_puzzle_cache(options.cache, cache_file);
+        if (saved >= 0) {
+            printf("Saved %d cached puzzles to %s\n", saved, cache_file);
+        }
+        free_puzzle_cache(options.cache);
+    }
+}
+
+// 运行二进制谜题库模式
+// 用法: --percent-sudoku db-pack <input> <output.psdb> [--difficulty d] [--no-solutions]
+//       --percent-sudoku db-unpack <database.psdb> <output_file|output_dir/>
+//       --percent-sudoku db-get <database.psdb> <index> [output.percent_sudoku] [--difficulty d]
+//       --percent-sudoku db-info <database.psdb>
+void run_percent_sudoku_database_mode(int argc, char* argv[]) {
+    const char* command = argv[2];
+    
+    if (strcmp(command, "db-pack") == 0) {
+        if (argc < 5) {
+            printf("Usage: %s --percent-sudoku db-pack <input> <output.psdb> [--difficulty d] [--no-solutions]\n", argv[0]);
+            return;
+        }
+        
+        int include_solutions = 1;
+        int difficulty = 0;
+        for (int i = 5; i < argc; i++) {
+            if (strcmp(argv[i], "--no-solutions") == 0) {
+                include_solutions = 0;
+            } else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) {
+                difficulty = atoi(argv[++i]);
+                if (difficulty < 0 || difficulty > 5) {
+                    printf("Error: Difficulty must be between 1-5 (0 for unknown)\n");
+                    return;
+                }
+            } else {
+                printf("Error: Unknown option '%s'\n", argv[i]);
+                return;
+            }
+        }
+        
+        double start_time = get_monotonic_time_ms();
+        int packed = pack_puzzle_database(argv[3], argv[4], include_solutions, difficulty);
+        if (packed < 0) {
+            printf("Error: Failed to pack puzzle database\n");
+            return;
+        }
+        printf("Packed %d puzzles into %s in %.2f ms\n", packed, argv[4], get_monotonic_time_ms() - start_time);
+        
+    } else if (strcmp(command, "db-unpack") == 0) {
+        if (argc < 5) {
+            printf("Usage: %s --percent-sudoku db-unpack <database.psdb> <output_file|output_dir/>\n", argv[0]);
+            return;
+        }
+        
+        int unpacked = unpack_puzzle_database(argv[3], argv[4]);
+        if (unpacked < 0) {
+            printf("Error: Failed to unpack puzzle database\n");
+            return;
+        }
+        printf("Unpacked %d puzzles into %s\n", unpacked, argv[4]);
+        
+    } else if (strcmp(command, "db-get") == 0) {
+        if (argc < 5) {
+            printf("Usage: %s --percent-sudoku db-get <database.psdb> <index> [output.percent_sudoku] [--difficulty d]\n", argv[0]);
+            return;
+        }
+        
+        unsigned int index = (unsigned int)strtoul(argv[4], NULL, 10);
+        const char* output_file = NULL;
+        int difficulty = -1;
+        for (int i = 5; i < argc; i++) {
+            if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) {
+                difficulty = atoi(argv[++i]);
+            } else if (argv[i][0] != '-' && output_file == NULL) {
+                output_file = argv[i];
+            } else {
+                printf("Error: Unknown option '%s'\n", argv[i]);
+                return;
+            }
+        }
+        
+        PuzzleDatabase db;
+        if (!open_puzzle_database(argv[3], &db)) {
+            return;
+        }
+        
+        PercentSudokuGame game;
+        int found = difficulty >= 0 ? get_database_puzzle_by_difficulty(&db, difficulty, index, &game)
+                                    : get_database_puzzle(&db, index, &game);
+        int has_solution = (db.flags & PSDB_FLAG_SOLUTIONS) != 0;
+        close_puzzle_database(&db);
+        
+        if (!found) {
+            printf("Error: Puzzle %u not found\n", index);
+            return;
+        }
+        
+        print_percent_sudoku_game_console(&game, has_solution, 0);
+        if (output_file != NULL) {
+            save_percent_sudoku_to_file(&game, output_file);
+        }
+        
+    } else if (strcmp(command, "db-info") == 0) {
+        if (argc < 4) {
+            printf("Usage: %s --percent-sudoku db-info <database.psdb>\n", argv[0]);
+            return;
+        }
+        
+        PuzzleDatabase db;
+        if (!open_puzzle_database(argv[3], &db)) {
+            return;
+        }
+        print_database_info(&db);
+        close_puzzle_database(&db);
+        
+    } else {
+        printf("Error: Unknown command '%s'\n", command);
+        printf("Database commands: db-pack, db-unpack, db-get, db-info\n");
+    }
+}
+
+// 运行基准测试模式
+// 用法: --percent-sudoku benchmark [puzzles] [difficulty] [--seed n] [--warmup n] [--engines list]
+//                                   [--corpus file] [--csv file] [--json file]
+void run_percent_sudoku_benchmark_mode(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    init_benchmark_options(&options);
+    int positional = 0;
+    
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.warmup_runs = atoi(argv[++i]);
+            if (options.warmup_runs < 0) {
+                printf("Error: Number of warm-up runs cannot be negative\n");
+                return;
+            }
+        } else if (strcmp(argv[i], "--engines") == 0 && i + 1 < argc) {
+            if (!parse_engine_list(argv[++i], &options.engine_mask)) {
+                printf("Error: Invalid engine list '%s' (bitmask, dlx, sat, backtrack, simd)\n", argv[i]);
+                return;
+            }
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            options.corpus_file = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            options.csv_file = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.json_file = argv[++i];
+        } else if (argv[i][0] != '-' && positional == 0) {
+            options.num_puzzles = atoi(argv[i]);
+            positional++;
+            if (options.num_puzzles <= 0) {
+                printf("Error: Number of puzzles must be greater than 0\n");
+                return;
+            }
+        } else if (argv[i][0] != '-' && positional == 1) {
+            options.difficulty = atoi(argv[i]);
+            positional++;
+            if (options.difficulty < 0 || options.difficulty > 5) {
+                printf("Error: Difficulty must be between 1-5 (0 for all)\n");
+                return;
+            }
+        } else {
+            printf("Error: Unknown option '%s'\n", argv[i]);
+            return;
+        }
+    }
+    
+    printf("========================================\n");
+    printf("      Percent Sudoku Solver Benchmark\n");
+    printf("========================================\n");
+    
+    run_percent_sudoku_benchmark(&options);
+}
+
 // 运行百分号数独GUI模式
 void run_percent_sudoku_gui_mode(int difficulty) {
     printf("========================================\n");
@@ -431,27 +1004,68 @@ void print_usage(const char* program_name) {
     printf("=====================================================\n\n");
     
     printf("Usage 1 - CNF solving mode:\n");
-    printf("  %s <cnf_file_path> [timeout_seconds]\n", program_name);
+    printf("  %s <cnf_file_path> [timeout_seconds] [--no-cache] [--progress] [--perf]\n", program_name);
     printf("\n  Examples:\n");
     printf("    %s tests/cases/small/small_sat_1.cnf\n", program_name);
     printf("    %s tests/cases/medium/medium_sat_1.cnf 60\n", program_name);
     printf("    %s tests/cases/large/large_sat_1.cnf 300\n", program_name);
+    printf("  gzip/xz/bzip2-compressed files are decompressed while parsing; use - to read from stdin\n");
+    printf("    xzcat instance.cnf.xz | %s -\n", program_name);
+    printf("  Files of 1 MB or more are cached pre-parsed next to the source (<file>.fcache) and reloaded on later runs\n");
+    printf("  --trace <file> (any mode) writes a Chrome trace-event JSON of the pipeline phases\n");
+    printf("  --progress prints a status line to stderr every %d conflicts or %.0f second(s) instead of per-node output\n",
+           SOLVER_PROGRESS_DEFAULT_CONFLICTS, SOLVER_PROGRESS_DEFAULT_SECONDS);
+    printf("  --perf counts cycles, instructions, cache and branch misses per phase (parse, propagation, branching; Linux)\n");
     
     printf("\nUsage 2 - Percent Sudoku mode:\n");
     printf("  %s --percent-sudoku <command> [options]\n", program_name);
     printf("\n  Commands:\n");
     printf("    generate <difficulty> [timeout]  - Generate Percent Sudoku puzzle\n");
+    printf("    generate-file <count> <difficulty> <output_file>\n");
+    printf("                                     - Generate puzzles in the one-line format\n");
+    printf("          [--threads n] [--seed s] [--variants n]\n");
+    printf("    grid-stats <count> [--seed s]    - Measure random solution grid generation and distinctness\n");
+    printf("    multiply <input> <output> <copies> [--seed s]\n");
+    printf("                                     - Derive new puzzles by symmetry transforms\n");
     printf("    solve <puzzle_file> [timeout]    - Solve Percent Sudoku file\n");
+    printf("    batch <input> [result_file]      - Solve a puzzle directory or one-puzzle-per-line file\n");
+    printf("          [--engine name] [--threads n] [--timeout seconds]\n");
+    printf("          [--cache file] [--cache-size n]\n");
+    printf("    db-pack <input> <output.psdb>    - Pack puzzles into a binary database\n");
+    printf("          [--difficulty d] [--no-solutions]\n");
+    printf("    db-unpack <db.psdb> <output>     - Unpack to the one-line format or a directory (output/)\n");
+    printf("    db-get <db.psdb> <index> [file]  - Fetch one puzzle by index [--difficulty d]\n");
+    printf("    db-info <db.psdb>                - Show database header and difficulty index\n");
+    printf("    benchmark [puzzles] [difficulty] - Benchmark solver engines on a seeded corpus\n");
+    printf("          [--seed n] [--warmup n] [--engines list] [--corpus file] [--csv file] [--json file]\n");
+    printf("    encodings [difficulty]           - Compare CNF at-most-one encodings\n");
+    printf("    decisions [puzzles]              - Measure decisions saved by the extended encoding\n");
     printf("    gui [difficulty]                 - Run interactive GUI\n");
     printf("    test                             - Run tests\n");
     printf("    demo                             - Run demo\n");
     printf("\n  Examples:\n");
     printf("    %s --percent-sudoku generate 3 60\n", program_name);
     printf("    %s --percent-sudoku solve puzzle.percent_sudoku 30\n", program_name);
+    printf("    %s --percent-sudoku generate-file 10000 3 puzzles.txt --threads 8 --seed 42\n", program_name);
+    printf("    %s --percent-sudoku batch puzzles.txt results.txt --threads 8\n", program_name);
+    printf("    %s --percent-sudoku db-pack puzzles.txt puzzles.psdb --difficulty 3\n", program_name);
+    printf("    %s --percent-sudoku db-get puzzles.psdb 42\n", program_name);
+    printf("    %s --percent-sudoku benchmark 50 0 --csv bench.csv --json bench.json\n", program_name);
+    printf("    %s --percent-sudoku encodings 4\n", program_name);
     printf("    %s --percent-sudoku gui 2\n", program_name);
     printf("    %s --percent-sudoku test\n", program_name);
     printf("    %s --percent-sudoku demo\n", program_name);
     
+    printf("\nUsage 3 - CNF benchmark mode:\n");
+    printf("  %s --bench [file|directory|glob ...] [options]\n", program_name);
+    printf("    Solves every CNF (default: %s), writes .res files to the output directory,\n", CNF_BENCH_DEFAULT_INPUT);
+    printf("    checks SAT/UNSAT against the .res next to each input and verifies every model\n");
+    printf("          [--out dir] [--timeout seconds] [--repeat n] [--json file]\n");
+    printf("          [--baseline file] [--threshold percent]\n");
+    printf("\n  Examples:\n");
+    printf("    %s --bench --json baseline.json\n", program_name);
+    printf("    %s --bench tests/cases/small --baseline baseline.json --threshold 25\n", program_name);
+    
     printf("\nParameter Description:\n");
     printf("  cnf_file_path: CNF file path\n");
     printf("  timeout_seconds: Timeout time (seconds, default 300)\n");
@@ -497,59 +1111,71 @@ void print_solution_summary(const Formula* formula, int* assignments, int result
     }
 }
 
-// 保存结果到文件
-void save_solution_to_file(const char* filename, const Formula* formula, int* assignments, int result, double time_spent) {
-    // 构造.res文件名
-    char res_filename[512];
-    strcpy(res_filename, filename);
+// 构造与CNF文件同名、扩展名为extension的输出文件名（从标准输入读取时为stdin + extension）
+void build_output_filename(const char* filename, const char* extension, char* output, size_t size) {
+    size_t extension_size = strlen(extension);
+    snprintf(output, size - extension_size, "%s", strcmp(filename, "-") == 0 ? "stdin" : filename);
+    
+    // 压缩文件先去掉压缩扩展名（x.cnf.gz -> x.cnf）
+    const char* compressed_extensions[] = {".gz", ".xz", ".bz2"};
+    for (int i = 0; i < 3; i++) {
+        size_t length = strlen(output);
+        size_t extension_length = strlen(compressed_extensions[i]);
+        if (length > extension_length && strcmp(output + length - extension_length, compressed_extensions[i]) == 0) {
+            output[length - extension_length] = '\0';
+            break;
+        }
+    }
     
-    // 找到最后一个点号，替换扩展名为.res
-    char* last_dot = strrchr(res_filename, '.');
+    // 找到最后一个点号，替换扩展名
+    char* last_dot = strrchr(output, '.');
     if (last_dot != NULL) {
-        strcpy(last_dot, ".res");
+        strcpy(last_dot, extension);
     } else {
-        strcat(res_filename, ".res");
+        strcat(output, extension);
     }
+}
+
+// 保存结果到文件
+void save_solution_to_file(const char* filename, const Formula* formula, int* assignments, int result, double time_spent) {
+    // 构造.res文件名（从标准输入读取时写入stdin.res）
+    char res_filename[512];
+    build_output_filename(filename, ".res", res_filename, sizeof(res_filename));
     
-    FILE* file = fopen(res_filename, "w");
-    if (file == NULL) {
+    if (!write_cnf_result_file(res_filename, formula, assignments, result, time_spent)) {
         fprintf(stderr, "Warning: Cannot create result file %s\n", res_filename);
         return;
     }
+    printf("Results saved to: %s\n", res_filename);
+}
+
+// 把求解统计写成JSON，与.res文件放在一起（x.cnf -> x.stats.json）；perf 不为NULL时附带各阶段性能计数
+void save_statistics_to_file(const char* filename, const Formula* formula, int result, const SolverStatistics* stats,
+                             const PerfReport* perf) {
+    char json_filename[512];
+    build_output_filename(filename, ".stats.json", json_filename, sizeof(json_filename));
     
-    // 按照新规范输出
-    // s求解结果//1表示满足，0表示不满足，-1表示在限定时间内未完成求解
-    if (result == SAT) {
-        fprintf(file, "s 1\n");
-    } else if (result == UNSAT) {
-        fprintf(file, "s 0\n");
-    } else if (result == TIMEOUT) {
-        fprintf(file, "s -1\n");
-    } else {
-        fprintf(file, "s -1\n");  // 其他未知情况也标记为超时
+    FILE* file = fopen(json_filename, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Warning: Cannot create statistics file %s\n", json_filename);
+        return;
     }
     
-    // v -1 2 -3 … //满足时，每个变元的赋值序列
-    if (result == SAT) {
-        fprintf(file, "v");
-        for (int i = 0; i < formula->num_vars; i++) {
-            if (assignments[i] == TRUE) {
-                fprintf(file, " %d", i + 1);  // 正数表示取真
-            } else if (assignments[i] == FALSE) {
-                fprintf(file, " %d", -(i + 1));  // 负数表示取假
-            } else {
-                // 根据规范，未赋值的变量应该默认为假（负数）
-                fprintf(file, " %d", -(i + 1));  // 负数表示取假
-            }
-        }
-        fprintf(file, "\n");
+    fprintf(file, "{\n  \"file\": ");
+    write_json_string(file, filename);
+    fprintf(file, ",\n  \"result\": \"%s\",\n", result == SAT ? "SAT" : (result == UNSAT ? "UNSAT" : "TIMEOUT"));
+    fprintf(file, "  \"num_vars\": %d,\n", formula->num_vars);
+    fprintf(file, "  \"num_clauses\": %d,\n", formula->num_clauses);
+    fprintf(file, "  \"solver\": ");
+    write_solver_statistics_json(file, stats, 4);
+    if (perf != NULL) {
+        fprintf(file, ",\n  \"perf_counters\": ");
+        write_perf_report_json(file, perf, 4);
     }
-    
-    // t 17     //以毫秒为单位的DPLL执行时间
-    fprintf(file, "t %.0f\n", time_spent);
+    fprintf(file, "\n}\n");
     
     fclose(file);
-    printf("Results saved to: %s\n", res_filename);
+    printf("Statistics saved to: %s\n", json_filename);
 }
 
 // 打印公式详细内容（用于验证解析正确性）
@@ -574,6 +1200,27 @@ void print_formula_details(const Formula* formula) {
     }
 }
 
+// 从参数中移除 --trace <file> 并记下文件名，返回剩余参数个数
+int extract_trace_option(int argc, char* argv[]) {
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_filename = argv[++i];
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argv[kept] = NULL;
+    return kept;
+}
+
+// 程序退出时写出追踪文件
+void write_trace_at_exit(void) {
+    if (trace_filename != NULL && trace_write_file(trace_filename)) {
+        fprintf(stderr, "Trace written to: %s\n", trace_filename);
+    }
+}
+
 // 超时信号处理函数（Unix/Linux）
 #ifndef _WIN32
 void timeout_handler(int sig) {
@@ -0,0 +1,601 @@
+#include "cnf_benchmark.h"
+#include "../parser/parser.h"
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#else
+#include <glob.h>
+#endif
+
+// 输入文件列表
+typedef struct {
+    char** paths;
+    int count;
+    int capacity;
+} PathList;
+
+// 基线中的一个用例
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    double wall_ms;
+} BaselineEntry;
+
+// 初始化基准测试选项
+void init_cnf_benchmark_options(CnfBenchmarkOptions* options) {
+    if (options == NULL) {
+        return;
+    }
+    
+    options->inputs = NULL;
+    options->num_inputs = 0;
+    options->output_dir = CNF_BENCH_DEFAULT_OUTPUT_DIR;
+    options->json_file = NULL;
+    options->baseline_file = NULL;
+    options->timeout_seconds = CNF_BENCH_DEFAULT_TIMEOUT;
+    options->regression_threshold = CNF_BENCH_DEFAULT_THRESHOLD;
+    options->repeat = 1;
+}
+
+const char* cnf_check_result_name(CnfCheckResult check) {
+    switch (check) {
+        case CNF_CHECK_OK: return "ok";
+        case CNF_CHECK_UNCHECKED: return "unchecked";
+        case CNF_CHECK_TIMEOUT: return "timeout";
+        case CNF_CHECK_WRONG_STATUS: return "wrong_status";
+        case CNF_CHECK_INVALID_MODEL: return "invalid_model";
+        case CNF_CHECK_PARSE_ERROR: return "parse_error";
+        default: return "unknown";
+    }
+}
+
+static const char* result_name(int result) {
+    if (result == SAT) {
+        return "SAT";
+    }
+    if (result == UNSAT) {
+        return "UNSAT";
+    }
+    if (result == CNF_RESULT_UNKNOWN) {
+        return "-";
+    }
+    return "TIMEOUT";
+}
+
+// 读取 .res 文件中的求解结果（s 行），成功返回1；s -1 视为没有期望结果
+int read_cnf_result_status(const char* res_path, int* status) {
+    if (res_path == NULL || status == NULL) {
+        return 0;
+    }
+    
+    FILE* file = fopen(res_path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    
+    // 只需要开头的 s 行，v 行可能很长，按字符读到行尾即可
+    int found = 0;
+    int c;
+    while (!found && (c = fgetc(file)) != EOF) {
+        if (c == 's') {
+            int value;
+            if (fscanf(file, "%d", &value) == 1 && (value == SAT || value == UNSAT)) {
+                *status = value;
+                found = 1;
+            }
+            break;
+        }
+        while (c != '\n' && c != EOF) {
+            c = fgetc(file);
+        }
+    }
+    
+    fclose(file);
+    return found;
+}
+
+// 按 .res 格式写出结果，成功返回1（无法创建文件时返回0，由调用方提示）
+int write_cnf_result_file(const char* res_path, const Formula* formula, const int* assignments,
+                          int result, double time_spent_ms) {
+    FILE* file = fopen(res_path, "w");
+    if (file == NULL) {
+        return 0;
+    }
+    
+    // s求解结果//1表示满足，0表示不满足，-1表示在限定时间内未完成求解
+    if (result == SAT) {
+        fprintf(file, "s 1\n");
+    } else if (result == UNSAT) {
+        fprintf(file, "s 0\n");
+    } else {
+        fprintf(file, "s -1\n");  // 超时及其他未知情况
+    }
+    
+    // v -1 2 -3 … //满足时，每个变元的赋值序列
+    if (result == SAT) {
+        fprintf(file, "v");
+        for (int i = 0; i < formula->num_vars; i++) {
+            if (assignments[i] == TRUE) {
+                fprintf(file, " %d", i + 1);  // 正数表示取真
+            } else {
+                // 根据规范，未赋值的变量应该默认为假（负数）
+                fprintf(file, " %d", -(i + 1));  // 负数表示取假
+            }
+        }
+        fprintf(file, "\n");
+    }
+    
+    // t 17     //以毫秒为单位的DPLL执行时间
+    fprintf(file, "t %.0f\n", time_spent_ms);
+    
+    return fclose(file) == 0;
+}
+
+// 是否为CNF文件（.cnf 或压缩的 .cnf.gz/.cnf.xz/.cnf.bz2）
+static int has_cnf_extension(const char* name) {
+    const char* extensions[] = {".cnf", ".cnf.gz", ".cnf.xz", ".cnf.bz2"};
+    size_t length = strlen(name);
+    for (int i = 0; i < 4; i++) {
+        size_t extension_length = strlen(extensions[i]);
+        if (length > extension_length && strcmp(name + length - extension_length, extensions[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 去掉压缩扩展名和 .cnf，换成 extension（x.cnf.gz -> x.res）；只保留文件名部分时 basename_only 为1
+static void replace_cnf_extension(const char* path, const char* extension, int basename_only,
+                                  char* output, size_t size) {
+    const char* name = path;
+    if (basename_only) {
+        for (const char* p = path; *p != '\0'; p++) {
+            if (*p == '/' || *p == '\\') {
+                name = p + 1;
+            }
+        }
+    }
+    
+    char stem[MAX_PATH_LENGTH];
+    snprintf(stem, sizeof(stem), "%s", name);
+    const char* suffixes[] = {".gz", ".xz", ".bz2", ".cnf"};
+    for (int i = 0; i < 4; i++) {
+        size_t length = strlen(stem);
+        size_t suffix_length = strlen(suffixes[i]);
+        if (length > suffix_length && strcmp(stem + length - suffix_length, suffixes[i]) == 0) {
+            stem[length - suffix_length] = '\0';
+        }
+    }
+    snprintf(output, size, "%s%s", stem, extension);
+}
+
+static int is_directory(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static void add_path(PathList* list, const char* path) {
+    if (!is_valid_file_path(path)) {
+        print_error("add_path", COMMON_ERROR_INVALID_PARAMETER, "Benchmark input path is too long");
+        return;
+    }
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity > 0 ? list->capacity * 2 : 64;
+        list->paths = (char**)safe_realloc(list->paths, list->capacity * sizeof(char*));
+    }
+    size_t length = strlen(path);
+    list->paths[list->count] = (char*)safe_malloc(length + 1);
+    memcpy(list->paths[list->count], path, length + 1);
+    list->count++;
+}
+
+// 递归查找目录中的CNF文件
+static void collect_directory(PathList* list, const char* dir_path) {
+    DIR* dir = opendir(dir_path);
+    if (dir == NULL) {
+        print_error("collect_directory", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open benchmark directory");
+        return;
+    }
+    
+    struct dirent* entry;
+    char path[MAX_PATH_LENGTH];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        if (is_directory(path)) {
+            collect_directory(list, path);
+        } else if (has_cnf_extension(entry->d_name)) {
+            add_path(list, path);
+        }
+    }
+    closedir(dir);
+}
+
+// 展开一个输入：目录递归查找，通配符（非Windows）由 glob 展开，其余视为文件
+static void collect_input(PathList* list, const char* input) {
+#ifndef _WIN32
+    if (strpbrk(input, "*?[") != NULL) {
+        glob_t matches;
+        if (glob(input, 0, NULL, &matches) != 0) {
+            fprintf(stderr, "Warning: No files match %s\n", input);
+            return;
+        }
+        for (size_t i = 0; i < matches.gl_pathc; i++) {
+            if (is_directory(matches.gl_pathv[i])) {
+                collect_directory(list, matches.gl_pathv[i]);
+            } else {
+                add_path(list, matches.gl_pathv[i]);
+            }
+        }
+        globfree(&matches);
+        return;
+    }
+#endif
+    if (is_directory(input)) {
+        collect_directory(list, input);
+    } else {
+        add_path(list, input);
+    }
+}
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// 去掉重复列出的同一文件（list 已排序），并检查结果文件名：.res 按文件名写到输出目录，
+// 不同目录下同名的用例会互相覆盖，因此在运行前拒绝。没有冲突时返回1
+static int check_result_names(PathList* list) {
+    int count = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (count > 0 && strcmp(list->paths[i], list->paths[count - 1]) == 0) {
+            safe_free(list->paths[i]);
+            continue;
+        }
+        list->paths[count++] = list->paths[i];
+    }
+    list->count = count;
+    
+    char (*names)[MAX_PATH_LENGTH] = (char (*)[MAX_PATH_LENGTH])safe_malloc((size_t)count * MAX_PATH_LENGTH);
+    int ok = 1;
+    for (int i = 0; i < count && ok; i++) {
+        replace_cnf_extension(list->paths[i], ".res", 1, names[i], MAX_PATH_LENGTH);
+        for (int j = 0; j < i; j++) {
+            if (strcmp(names[i], names[j]) == 0) {
+                fprintf(stderr, "Error: %s and %s would both write %s; benchmark them separately\n",
+                        list->paths[j], list->paths[i], names[i]);
+                ok = 0;
+                break;
+            }
+        }
+    }
+    safe_free(names);
+    return ok;
+}
+
+static void free_path_list(PathList* list) {
+    for (int i = 0; i < list->count; i++) {
+        safe_free(list->paths[i]);
+    }
+    safe_free(list->paths);
+}
+
+// 从JSON中取出 "key": 之后的值的起始位置
+static const char* find_json_value(const char* line, const char* key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char* value = strstr(line, pattern);
+    return value != NULL ? value + strlen(pattern) : NULL;
+}
+
+// 读取基线JSON（由 write_benchmark_json 写出，每个用例一行），返回用例数量（失败返回-1）
+static int load_benchmark_baseline(const char* filename, BaselineEntry** entries) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        print_error("load_benchmark_baseline", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open baseline file");
+        return -1;
+    }
+    
+    int count = 0, capacity = 0;
+    char line[MAX_PATH_LENGTH * 2 + MAX_LINE_LENGTH];
+    *entries = NULL;
+    
+    while (fgets(line, sizeof(line), file) != NULL) {
+        const char* path = find_json_value(line, "file");
+        const char* wall = find_json_value(line, "wall_ms");
+        const char* result = find_json_value(line, "result");
+        if (path == NULL || wall == NULL || *path != '"') {
+            continue;
+        }
+        // 超时用例的耗时只是时限，不作比较
+        if (result != NULL && strncmp(result, "\"TIMEOUT\"", 9) == 0) {
+            continue;
+        }
+        
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            *entries = (BaselineEntry*)safe_realloc(*entries, capacity * sizeof(BaselineEntry));
+        }
+        BaselineEntry* entry = &(*entries)[count];
+        
+        // 还原 write_json_string 转义过的路径
+        size_t length = 0;
+        for (const char* p = path + 1; *p != '"' && *p != '\0' && length + 1 < sizeof(entry->path); p++) {
+            if (*p == '\\' && p[1] != '\0') {
+                p++;
+            }
+            entry->path[length++] = *p;
+        }
+        entry->path[length] = '\0';
+        entry->wall_ms = strtod(wall, NULL);
+        count++;
+    }
+    
+    fclose(file);
+    return count;
+}
+
+static double find_baseline_time(const BaselineEntry* entries, int count, const char* path) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].path, path) == 0) {
+            return entries[i].wall_ms;
+        }
+    }
+    return -1.0;
+}
+
+// 运行一个用例：重复 options->repeat 次，保留总耗时最短的一次，并把它的结果写到输出目录
+static void run_benchmark_case(const char* path, const CnfBenchmarkOptions* options, CnfBenchmarkCase* bench_case) {
+    memset(bench_case, 0, sizeof(CnfBenchmarkCase));
+    snprintf(bench_case->path, sizeof(bench_case->path), "%s", path);
+    bench_case->baseline_ms = -1.0;
+    
+    char expected_path[MAX_PATH_LENGTH];
+    replace_cnf_extension(path, ".res", 0, expected_path, sizeof(expected_path));
+    if (!read_cnf_result_status(expected_path, &bench_case->expected)) {
+        bench_case->expected = CNF_RESULT_UNKNOWN;
+    }
+    
+    char res_name[MAX_PATH_LENGTH];
+    char res_path[MAX_PATH_LENGTH * 2];
+    replace_cnf_extension(path, ".res", 1, res_name, sizeof(res_name));
+    snprintf(res_path, sizeof(res_path), "%s/%s", options->output_dir, res_name);
+    
+    int model_valid = 1;
+    for (int run = 0; run < options->repeat; run++) {
+        double start_time = get_monotonic_time_ms();
+        Formula* formula = parse_cnf_file(path);
+        double parse_end = get_monotonic_time_ms();
+        if (formula == NULL) {
+            bench_case->check = CNF_CHECK_PARSE_ERROR;
+            bench_case->result = CNF_RESULT_UNKNOWN;
+            return;
+        }
+        
+        int* assignments = (int*)safe_malloc((formula->num_vars > 0 ? formula->num_vars : 1) * sizeof(int));
+        for (int i = 0; i < formula->num_vars; i++) {
+            assignments[i] = UNASSIGNED;
+        }
+        
+        reset_solver_statistics();
+        int result = DPLL(formula, assignments);
+        double solve_end = get_monotonic_time_ms();
+        
+        // 按写入 .res 的模型验证：未赋值变量视为假
+        int valid = 1;
+        if (result == SAT) {
+            for (int i = 0; i < formula->num_vars; i++) {
+                if (assignments[i] == UNASSIGNED) {
+                    assignments[i] = FALSE;
+                }
+            }
+            valid = is_formula_satisfied(formula, assignments);
+        }
+        double wall_ms = get_monotonic_time_ms() - start_time;
+        
+        if (run == 0 || wall_ms < bench_case->wall_ms) {
+            bench_case->num_vars = formula->num_vars;
+            bench_case->num_clauses = formula->num_clauses;
+            bench_case->result = result;
+            bench_case->parse_ms = parse_end - start_time;
+            bench_case->solve_ms = solve_end - parse_end;
+            bench_case->wall_ms = wall_ms;
+            get_solver_statistics(&bench_case->solver);
+            model_valid = valid;
+            if (!write_cnf_result_file(res_path, formula, assignments, result, bench_case->solve_ms)) {
+                fprintf(stderr, "Warning: Cannot create result file %s\n", res_path);
+            }
+        }
+        
+        safe_free(assignments);
+        free_formula(formula);
+        
+        // 超时的用例重复运行也只会再超时
+        if (result == TIMEOUT) {
+            break;
+        }
+    }
+    
+    if (bench_case->result == TIMEOUT) {
+        bench_case->check = CNF_CHECK_TIMEOUT;
+    } else if (bench_case->result == SAT && !model_valid) {
+        bench_case->check = CNF_CHECK_INVALID_MODEL;
+    } else if (bench_case->expected == CNF_RESULT_UNKNOWN) {
+        bench_case->check = CNF_CHECK_UNCHECKED;
+    } else if (bench_case->result != bench_case->expected) {
+        bench_case->check = CNF_CHECK_WRONG_STATUS;
+    } else {
+        bench_case->check = CNF_CHECK_OK;
+    }
+}
+
+static int is_failed_check(CnfCheckResult check) {
+    return check == CNF_CHECK_WRONG_STATUS || check == CNF_CHECK_INVALID_MODEL || check == CNF_CHECK_PARSE_ERROR;
+}
+
+// 打印一行结果
+static void print_benchmark_case(const CnfBenchmarkCase* bench_case) {
+    printf("%-40s %-7s %-8s %-13s %10.3f %10.3f %10ld %10ld",
+           bench_case->path, result_name(bench_case->result), result_name(bench_case->expected),
+           cnf_check_result_name(bench_case->check), bench_case->parse_ms, bench_case->solve_ms,
+           bench_case->solver.decisions, bench_case->solver.conflicts);
+    if (bench_case->baseline_ms > 0.0) {
+        printf(" %+8.1f%%%s", (bench_case->wall_ms / bench_case->baseline_ms - 1.0) * 100.0,
+               bench_case->regression ? "  REGRESSION" : "");
+    } else {
+        printf(" %9s", "-");
+    }
+    printf("\n");
+}
+
+// 输出JSON（每个用例一行，可直接作为以后运行的基线）
+static void write_benchmark_json(const char* filename, const CnfBenchmarkCase* cases, int num_cases,
+                                 const CnfBenchmarkOptions* options, int has_baseline) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        print_error("write_benchmark_json", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open JSON file for writing");
+        return;
+    }
+    
+    int passed = 0, unchecked = 0, timeouts = 0, failed = 0, regressions = 0;
+    double total_wall_ms = 0.0;
+    
+    fprintf(file, "{\n");
+    fprintf(file, "  \"timeout_seconds\": %.1f,\n", options->timeout_seconds);
+    fprintf(file, "  \"repeat\": %d,\n", options->repeat);
+    fprintf(file, "  \"cases\": [\n");
+    for (int i = 0; i < num_cases; i++) {
+        const CnfBenchmarkCase* c = &cases[i];
+        fprintf(file, "    {\"file\": ");
+        write_json_string(file, c->path);
+        fprintf(file, ", \"result\": \"%s\", \"expected\": \"%s\", \"check\": \"%s\", "
+                "\"num_vars\": %d, \"num_clauses\": %d, "
+                "\"parse_ms\": %.3f, \"solve_ms\": %.3f, \"wall_ms\": %.3f, "
+                "\"decisions\": %ld, \"propagations\": %ld, \"conflicts\": %ld, \"max_depth\": %d, "
+                "\"peak_memory_bytes\": %llu",
+                result_name(c->result), result_name(c->expected), cnf_check_result_name(c->check),
+                c->num_vars, c->num_clauses, c->parse_ms, c->solve_ms, c->wall_ms,
+                c->solver.decisions, c->solver.propagations, c->solver.conflicts, c->solver.max_depth,
+                (unsigned long long)c->solver.peak_memory_bytes);
+        if (has_baseline && c->baseline_ms > 0.0) {
+            fprintf(file, ", \"baseline_ms\": %.3f, \"regression\": %s", c->baseline_ms, c->regression ? "true" : "false");
+        }
+        fprintf(file, "}%s\n", (i + 1 < num_cases) ? "," : "");
+        
+        passed += c->check == CNF_CHECK_OK;
+        unchecked += c->check == CNF_CHECK_UNCHECKED;
+        timeouts += c->check == CNF_CHECK_TIMEOUT;
+        failed += is_failed_check(c->check);
+        regressions += c->regression;
+        total_wall_ms += c->wall_ms;
+    }
+    fprintf(file, "  ],\n");
+    fprintf(file, "  \"summary\": {\"cases\": %d, \"passed\": %d, \"unchecked\": %d, \"timeouts\": %d, "
+            "\"failed\": %d, \"regressions\": %d, \"total_wall_ms\": %.3f}\n",
+            num_cases, passed, unchecked, timeouts, failed, regressions, total_wall_ms);
+    fprintf(file, "}\n");
+    
+    fclose(file);
+    printf("JSON results saved to: %s\n", filename);
+}
+
+// 运行基准测试，所有用例通过且没有回退时返回1
+int run_cnf_benchmark(const CnfBenchmarkOptions* options) {
+    if (options == NULL || options->output_dir == NULL || options->repeat <= 0 || options->timeout_seconds <= 0) {
+        print_error("run_cnf_benchmark", COMMON_ERROR_INVALID_PARAMETER, "Invalid benchmark options");
+        return 0;
+    }
+    
+    PathList list = {NULL, 0, 0};
+    if (options->num_inputs == 0) {
+        collect_input(&list, CNF_BENCH_DEFAULT_INPUT);
+    }
+    for (int i = 0; i < options->num_inputs; i++) {
+        collect_input(&list, options->inputs[i]);
+    }
+    if (list.count == 0) {
+        print_error("run_cnf_benchmark", COMMON_ERROR_FILE_NOT_FOUND, "No CNF files to benchmark");
+        free_path_list(&list);
+        return 0;
+    }
+    qsort(list.paths, list.count, sizeof(char*), compare_paths);
+    if (!check_result_names(&list)) {
+        print_error("run_cnf_benchmark", COMMON_ERROR_INVALID_PARAMETER, "Duplicate CNF file names");
+        free_path_list(&list);
+        return 0;
+    }
+    
+    if (mkdir(options->output_dir, 0755) != 0 && errno != EEXIST) {
+        print_error("run_cnf_benchmark", COMMON_ERROR_FILE_NOT_FOUND, "Cannot create output directory");
+        free_path_list(&list);
+        return 0;
+    }
+    
+    BaselineEntry* baseline = NULL;
+    int num_baseline = 0;
+    if (options->baseline_file != NULL) {
+        num_baseline = load_benchmark_baseline(options->baseline_file, &baseline);
+        if (num_baseline < 0) {
+            free_path_list(&list);
+            return 0;
+        }
+    }
+    
+    // 逐节点输出会淹没计时，测试期间关闭；每个用例单独计时限
+    int saved_verbose = get_solver_verbose();
+    set_solver_verbose(0);
+    set_solver_timeout(options->timeout_seconds);
+    
+    printf("\n=== CNF Benchmark ===\n");
+    printf("Cases: %d, Timeout: %.1f s, Repeat: %d, Output: %s\n",
+           list.count, options->timeout_seconds, options->repeat, options->output_dir);
+    if (options->baseline_file != NULL) {
+        printf("Baseline: %s (%d cases, threshold %.0f%%)\n", options->baseline_file, num_baseline,
+               options->regression_threshold * 100.0);
+    }
+    printf("%-40s %-7s %-8s %-13s %10s %10s %10s %10s %9s\n",
+           "File", "Result", "Expected", "Check", "Parse(ms)", "Solve(ms)", "Decisions", "Conflicts", "vs base");
+    
+    CnfBenchmarkCase* cases = (CnfBenchmarkCase*)safe_malloc(list.count * sizeof(CnfBenchmarkCase));
+    int failed = 0, timeouts = 0, unchecked = 0, regressions = 0;
+    for (int i = 0; i < list.count; i++) {
+        CnfBenchmarkCase* bench_case = &cases[i];
+        run_benchmark_case(list.paths[i], options, bench_case);
+        
+        bench_case->baseline_ms = find_baseline_time(baseline, num_baseline, bench_case->path);
+        if (bench_case->baseline_ms > 0.0 && bench_case->check != CNF_CHECK_TIMEOUT) {
+            double slowdown_ms = bench_case->wall_ms - bench_case->baseline_ms;
+            bench_case->regression = bench_case->wall_ms > bench_case->baseline_ms * (1.0 + options->regression_threshold) &&
+                                     slowdown_ms >= CNF_BENCH_MIN_REGRESSION_MS;
+        }
+        print_benchmark_case(bench_case);
+        
+        failed += is_failed_check(bench_case->check);
+        timeouts += bench_case->check == CNF_CHECK_TIMEOUT;
+        unchecked += bench_case->check == CNF_CHECK_UNCHECKED;
+        regressions += bench_case->regression;
+    }
+    
+    set_solver_timeout(0);
+    set_solver_verbose(saved_verbose);
+    printf("=====================\n");
+    printf("Passed: %d, Unchecked: %d, Timeouts: %d, Failed: %d, Regressions: %d\n",
+           list.count - failed - timeouts - unchecked, unchecked, timeouts, failed, regressions);
+    
+    char json_path[MAX_PATH_LENGTH * 2];
+    if (options->json_file != NULL) {
+        snprintf(json_path, sizeof(json_path), "%s", options->json_file);
+    } else {
+        snprintf(json_path, sizeof(json_path), "%s/%s", options->output_dir, CNF_BENCH_JSON_NAME);
+    }
+    write_benchmark_json(json_path, cases, list.count, options, options->baseline_file != NULL);
+    
+    safe_free(cases);
+    safe_free(baseline);
+    free_path_list(&list);
+    return failed == 0 && regressions == 0;
+}
@@ -0,0 +1,80 @@
+#ifndef CNF_BENCHMARK_H
+#define CNF_BENCHMARK_H
+
+#include "../common/common.h"
+#include "../core/core.h"
+#include "../solver/solver.h"
+
+// CNF端到端基准测试
+// 对一组CNF文件（文件、目录或通配符，目录递归查找 .cnf 及其压缩形式）逐个解析并用DPLL求解，
+// 结果 .res 按文件名写到单独的输出目录（不覆盖输入旁边的期望结果；不同目录下同名的用例会互相覆盖，
+// 因此在运行前拒绝），然后：
+//   - 与输入旁边同名 .res 中的期望结果（s 1 / s 0）比较可满足性；
+//   - 可满足时逐子句验证模型（未赋值变量按假处理，与 .res 中写出的模型一致）；
+//   - 记录解析、求解耗时与求解统计，写成JSON（每个用例一行）；
+//   - 指定基线JSON（之前某次运行的输出）时，逐个用例比较总耗时，变慢超过阈值的标记为回退。
+// 每个用例可重复多次，取总耗时最短的一次，以减少噪声。
+
+#define CNF_BENCH_DEFAULT_INPUT "tests/cases"
+#define CNF_BENCH_DEFAULT_OUTPUT_DIR "bench_results"
+#define CNF_BENCH_JSON_NAME "bench.json"
+#define CNF_BENCH_DEFAULT_TIMEOUT 60.0
+#define CNF_BENCH_DEFAULT_THRESHOLD 0.20        // 比基线慢20%以上视为回退
+#define CNF_BENCH_MIN_REGRESSION_MS 5.0         // 且至少慢这么多毫秒（避免毫秒以下用例的计时噪声）
+
+// 基准测试选项
+typedef struct {
+    const char** inputs;            // CNF文件、目录或通配符
+    int num_inputs;                 // 为0时使用 CNF_BENCH_DEFAULT_INPUT
+    const char* output_dir;         // .res 与JSON的输出目录
+    const char* json_file;          // 结果JSON，NULL 时为 output_dir/bench.json
+    const char* baseline_file;      // 基线JSON，NULL 不比较
+    double timeout_seconds;         // 单个用例的求解时限
+    double regression_threshold;    // 相对基线变慢的比例阈值
+    int repeat;                     // 每个用例的运行次数
+} CnfBenchmarkOptions;
+
+// 单个用例的检查结果
+typedef enum {
+    CNF_CHECK_OK,                   // 与期望一致（可满足时模型通过验证）
+    CNF_CHECK_UNCHECKED,            // 没有期望结果，仅验证了模型
+    CNF_CHECK_TIMEOUT,              // 超过时限
+    CNF_CHECK_WRONG_STATUS,         // 可满足性与期望不符
+    CNF_CHECK_INVALID_MODEL,        // 模型不满足某些子句
+    CNF_CHECK_PARSE_ERROR           // 无法解析
+} CnfCheckResult;
+
+// 单个用例的结果
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    int num_vars;
+    int num_clauses;
+    int result;                     // SAT / UNSAT / TIMEOUT，无法解析时为 CNF_RESULT_UNKNOWN
+    int expected;                   // SAT / UNSAT，没有期望结果时为 CNF_RESULT_UNKNOWN
+    CnfCheckResult check;
+    double parse_ms;
+    double solve_ms;
+    double wall_ms;                 // 解析 + 求解 + 验证
+    SolverStatistics solver;
+    double baseline_ms;             // 基线中的总耗时，没有时为负数
+    int regression;
+} CnfBenchmarkCase;
+
+#define CNF_RESULT_UNKNOWN -2     // 没有期望结果或无法解析
+
+// 函数声明
+
+void init_cnf_benchmark_options(CnfBenchmarkOptions* options);
+const char* cnf_check_result_name(CnfCheckResult check);
+
+// 读取 .res 文件中的求解结果（s 行），成功返回1；s -1 视为没有期望结果
+int read_cnf_result_status(const char* res_path, int* status);
+
+// 按 .res 格式写出结果（s 行、可满足时的 v 行、以毫秒计的 t 行），成功返回1
+int write_cnf_result_file(const char* res_path, const Formula* formula, const int* assignments,
+                          int result, double time_spent_ms);
+
+// 运行基准测试，所有用例通过且没有回退时返回1
+int run_cnf_benchmark(const CnfBenchmarkOptions* options);
+
+#endif // CNF_BENCHMARK_H
@@ -1,28 +1,399 @@
 #include "common.h"
 
-// 安全内存分配函数
-void* safe_malloc(size_t size) {
-    void* ptr = malloc(size);
-    if (ptr == NULL) {
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// ---- 带统计的内存分配 ----
+
+// 每次分配前附带16字节的头部，记录大小和子系统，释放时据此更新统计（同时保持16字节对齐）
+#define ALLOCATION_HEADER_SIZE 16
+
+typedef struct {
+    size_t size;
+    int subsystem;
+} AllocationHeader;
+
+static MemoryStats memory_stats[MEMORY_SUBSYSTEM_COUNT];
+static MemoryStats memory_total;    // 全部子系统合计
+
+static const char* const memory_subsystem_names[MEMORY_SUBSYSTEM_COUNT] = {
+    "general", "formula", "parser", "solver", "sudoku"
+};
+
+// 统计计数器可能被多个线程同时更新，使用宽松的原子操作
+static uint64_t atomic_add_u64(uint64_t* target, uint64_t value) {
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedExchangeAdd64((volatile long long*)target, (long long)value) + value;
+#else
+    return __atomic_add_fetch(target, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static uint64_t atomic_load_u64(const uint64_t* target) {
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedCompareExchange64((volatile long long*)target, 0, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+#endif
+}
+
+static void atomic_max_u64(uint64_t* target, uint64_t value) {
+    uint64_t seen = atomic_load_u64(target);
+    while (seen < value) {
+#if defined(_MSC_VER)
+        uint64_t previous = (uint64_t)_InterlockedCompareExchange64((volatile long long*)target,
+                                                                    (long long)value, (long long)seen);
+        if (previous == seen) {
+            break;
+        }
+        seen = previous;
+#else
+        if (__atomic_compare_exchange_n(target, &seen, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+#endif
+    }
+}
+
+static void add_allocation(MemoryStats* stats, size_t size) {
+    atomic_add_u64(&stats->allocations, 1);
+    atomic_add_u64(&stats->bytes_allocated, size);
+    atomic_max_u64(&stats->peak_bytes, atomic_add_u64(&stats->current_bytes, size));
+}
+
+static void add_free(MemoryStats* stats, size_t size) {
+    atomic_add_u64(&stats->frees, 1);
+    atomic_add_u64(&stats->current_bytes, (uint64_t)0 - size);
+}
+
+static void account_allocation(MemorySubsystem subsystem, size_t size) {
+    add_allocation(&memory_stats[subsystem], size);
+    add_allocation(&memory_total, size);
+}
+
+static void account_free(MemorySubsystem subsystem, size_t size) {
+    add_free(&memory_stats[subsystem], size);
+    add_free(&memory_total, size);
+}
+
+void* tracked_malloc(MemorySubsystem subsystem, size_t size) {
+    char* block = (char*)malloc(size + ALLOCATION_HEADER_SIZE);
+    if (block == NULL) {
         fprintf(stderr, "Error: Memory allocation failed (requested %zu bytes)\n", size);
         exit(COMMON_ERROR_MEMORY_ALLOCATION);
     }
-    return ptr;
+    AllocationHeader* header = (AllocationHeader*)block;
+    header->size = size;
+    header->subsystem = (int)subsystem;
+    account_allocation(subsystem, size);
+    return block + ALLOCATION_HEADER_SIZE;
 }
 
-void* safe_realloc(void* ptr, size_t size) {
-    void* new_ptr = realloc(ptr, size);
-    if (new_ptr == NULL && size > 0) {
+// ptr 为NULL时按 subsystem 新分配，否则沿用原分配的子系统
+void* tracked_realloc(MemorySubsystem subsystem, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return tracked_malloc(subsystem, size);
+    }
+    if (size == 0) {
+        safe_free(ptr);
+        return NULL;
+    }
+    
+    char* block = (char*)ptr - ALLOCATION_HEADER_SIZE;
+    AllocationHeader* header = (AllocationHeader*)block;
+    size_t old_size = header->size;
+    subsystem = (MemorySubsystem)header->subsystem;
+    
+    char* new_block = (char*)realloc(block, size + ALLOCATION_HEADER_SIZE);
+    if (new_block == NULL) {
         fprintf(stderr, "Error: Memory reallocation failed (requested %zu bytes)\n", size);
         exit(COMMON_ERROR_MEMORY_ALLOCATION);
     }
-    return new_ptr;
+    ((AllocationHeader*)new_block)->size = size;
+    account_free(subsystem, old_size);
+    account_allocation(subsystem, size);
+    return new_block + ALLOCATION_HEADER_SIZE;
+}
+
+// 安全内存分配函数
+void* safe_malloc(size_t size) {
+    return tracked_malloc(MEMORY_GENERAL, size);
+}
+
+void* safe_realloc(void* ptr, size_t size) {
+    return tracked_realloc(MEMORY_GENERAL, ptr, size);
 }
 
 void safe_free(void* ptr) {
     if (ptr != NULL) {
-        free(ptr);
+        char* block = (char*)ptr - ALLOCATION_HEADER_SIZE;
+        AllocationHeader* header = (AllocationHeader*)block;
+        account_free((MemorySubsystem)header->subsystem, header->size);
+        free(block);
+    }
+}
+
+static void load_memory_stats(const MemoryStats* source, MemoryStats* stats) {
+    stats->bytes_allocated = atomic_load_u64(&source->bytes_allocated);
+    stats->current_bytes = atomic_load_u64(&source->current_bytes);
+    stats->peak_bytes = atomic_load_u64(&source->peak_bytes);
+    stats->allocations = atomic_load_u64(&source->allocations);
+    stats->frees = atomic_load_u64(&source->frees);
+    stats->arena_allocations = atomic_load_u64(&source->arena_allocations);
+}
+
+void get_memory_stats(MemorySubsystem subsystem, MemoryStats* stats) {
+    load_memory_stats(&memory_stats[subsystem], stats);
+}
+
+void get_total_memory_stats(MemoryStats* stats) {
+    load_memory_stats(&memory_total, stats);
+}
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) {
+    if ((int)subsystem < 0 || (int)subsystem >= MEMORY_SUBSYSTEM_COUNT) {
+        return "unknown";
+    }
+    return memory_subsystem_names[subsystem];
+}
+
+// 打印各子系统的内存统计（只列出有过分配的子系统）
+void print_memory_report(FILE* out) {
+    fprintf(out, "%-10s %14s %12s %12s %12s %12s %14s\n",
+            "subsystem", "allocated KB", "peak KB", "current KB", "allocs", "frees", "arena allocs");
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++) {
+        MemoryStats stats;
+        get_memory_stats((MemorySubsystem)i, &stats);
+        if (stats.allocations == 0 && stats.arena_allocations == 0) {
+            continue;
+        }
+        fprintf(out, "%-10s %14.1f %12.1f %12.1f %12llu %12llu %14llu\n",
+                memory_subsystem_names[i], stats.bytes_allocated / 1024.0, stats.peak_bytes / 1024.0,
+                stats.current_bytes / 1024.0, (unsigned long long)stats.allocations,
+                (unsigned long long)stats.frees, (unsigned long long)stats.arena_allocations);
+    }
+    
+    MemoryStats total;
+    get_total_memory_stats(&total);
+    fprintf(out, "%-10s %14.1f %12.1f %12.1f %12llu %12llu %14llu\n",
+            "total", total.bytes_allocated / 1024.0, total.peak_bytes / 1024.0,
+            total.current_bytes / 1024.0, (unsigned long long)total.allocations,
+            (unsigned long long)total.frees, (unsigned long long)total.arena_allocations);
+}
+
+// ---- 区域分配器与对象池 ----
+
+struct ArenaChunk {
+    ArenaChunk* next;
+    size_t size;        // 可用字节数
+    size_t used;        // 已分配字节数
+    size_t mapped_size; // 由mmap申请时为映射大小，否则为0
+};
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_CHUNK_HEADER_SIZE ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static char* chunk_data(ArenaChunk* chunk) {
+    return (char*)chunk + ARENA_CHUNK_HEADER_SIZE;
+}
+
+#ifndef _WIN32
+// 申请按大页对齐的匿名映射：先尝试预留的大页（MAP_HUGETLB），失败时多映射一个大页
+// 再裁掉首尾以对齐，并建议内核使用透明大页
+static void* map_huge_pages(size_t size) {
+#ifdef MAP_HUGETLB
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+        return data;
+    }
+#endif
+    char* raw = (char*)mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == (char*)MAP_FAILED) {
+        return NULL;
+    }
+    size_t head = (HUGE_PAGE_SIZE - ((uintptr_t)raw & (HUGE_PAGE_SIZE - 1))) & (HUGE_PAGE_SIZE - 1);
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    munmap(raw + head + size, HUGE_PAGE_SIZE - head);
+#ifdef MADV_HUGEPAGE
+    madvise(raw + head, size, MADV_HUGEPAGE);
+#endif
+    return raw + head;
+}
+#endif
+
+static ArenaChunk* create_arena_chunk(const Arena* arena, size_t min_size) {
+    size_t size = min_size > arena->chunk_size ? min_size : arena->chunk_size;
+    size_t total = size + ARENA_CHUNK_HEADER_SIZE;
+    ArenaChunk* chunk = NULL;
+    size_t mapped_size = 0;
+
+#ifndef _WIN32
+    if ((arena->flags & MEMORY_HUGE_PAGES) && total >= HUGE_PAGE_SIZE) {
+        mapped_size = (total + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+        chunk = (ArenaChunk*)map_huge_pages(mapped_size);
+        if (chunk != NULL) {
+            account_allocation(arena->subsystem, mapped_size);
+            total = mapped_size;
+        } else {
+            mapped_size = 0;
+        }
+    }
+#endif
+    if (chunk == NULL) {
+        chunk = (ArenaChunk*)tracked_malloc(arena->subsystem, total);
+    }
+    
+    chunk->next = NULL;
+    chunk->size = total - ARENA_CHUNK_HEADER_SIZE;
+    chunk->used = 0;
+    chunk->mapped_size = mapped_size;
+    return chunk;
+}
+
+static void free_arena_chunk(const Arena* arena, ArenaChunk* chunk) {
+#ifndef _WIN32
+    if (chunk->mapped_size > 0) {
+        account_free(arena->subsystem, chunk->mapped_size);
+        munmap(chunk, chunk->mapped_size);
+        return;
+    }
+#else
+    (void)arena;
+#endif
+    safe_free(chunk);
+}
+
+// 把区域内的分配次数计入子系统统计
+static void flush_arena_allocations(Arena* arena) {
+    if (arena->allocations > 0) {
+        atomic_add_u64(&memory_stats[arena->subsystem].arena_allocations, arena->allocations);
+        atomic_add_u64(&memory_total.arena_allocations, arena->allocations);
+        arena->allocations = 0;
+    }
+}
+
+void arena_init(Arena* arena, MemorySubsystem subsystem, size_t chunk_size, int flags) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : 64 * 1024;
+    // 小于一个大页的块不会走大页映射，要求大页时把块大小向上取整到大页的整数倍
+    if (flags & MEMORY_HUGE_PAGES) {
+        arena->chunk_size = (arena->chunk_size + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+    }
+    arena->subsystem = subsystem;
+    arena->flags = flags;
+    arena->allocations = 0;
+}
+
+// 分配 size 字节（16字节对齐），内存不足时与 safe_malloc 一样直接退出
+void* arena_alloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    arena->allocations++;
+    
+    ArenaChunk* chunk = arena->current;
+    if (chunk != NULL && chunk->size - chunk->used >= size) {
+        void* ptr = chunk_data(chunk) + chunk->used;
+        chunk->used += size;
+        return ptr;
+    }
+    
+    // 回退或清空后留下的后续块可以直接复用，放不下时在当前块之后插入新块
+    ArenaChunk* next = chunk != NULL ? chunk->next : arena->first;
+    if (next == NULL || next->size < size) {
+        ArenaChunk* created = create_arena_chunk(arena, size);
+        created->next = next;
+        if (chunk != NULL) {
+            chunk->next = created;
+        } else {
+            arena->first = created;
+        }
+        next = created;
+    }
+    next->used = size;
+    arena->current = next;
+    return chunk_data(next);
+}
+
+ArenaMark arena_mark(const Arena* arena) {
+    ArenaMark mark;
+    mark.chunk = arena->current;
+    mark.used = arena->current != NULL ? arena->current->used : 0;
+    return mark;
+}
+
+// 回退到 mark 处，之后分配的内存全部作废
+void arena_release(Arena* arena, ArenaMark mark) {
+    if (mark.chunk == NULL) {
+        arena_reset(arena);
+        return;
+    }
+    arena->current = mark.chunk;
+    mark.chunk->used = mark.used;
+}
+
+// 清空区域但保留已申请的内存块
+void arena_reset(Arena* arena) {
+    flush_arena_allocations(arena);
+    arena->current = arena->first;
+    if (arena->first != NULL) {
+        arena->first->used = 0;
+    }
+}
+
+void arena_destroy(Arena* arena) {
+    flush_arena_allocations(arena);
+    ArenaChunk* chunk = arena->first;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+        free_arena_chunk(arena, chunk);
+        chunk = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+void pool_init(MemoryPool* pool, MemorySubsystem subsystem, size_t object_size, size_t objects_per_chunk, int flags) {
+    if (object_size < sizeof(void*)) {
+        object_size = sizeof(void*);
+    }
+    pool->object_size = (object_size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    pool->free_list = NULL;
+    pool->live_objects = 0;
+    arena_init(&pool->arena, subsystem, pool->object_size * (objects_per_chunk > 0 ? objects_per_chunk : 64), flags);
+}
+
+void* pool_alloc(MemoryPool* pool) {
+    pool->live_objects++;
+    if (pool->free_list != NULL) {
+        void* object = pool->free_list;
+        pool->free_list = *(void**)object;
+        pool->arena.allocations++;
+        return object;
     }
+    return arena_alloc(&pool->arena, pool->object_size);
+}
+
+void pool_free(MemoryPool* pool, void* object) {
+    if (object == NULL) {
+        return;
+    }
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+    pool->live_objects--;
+}
+
+void pool_destroy(MemoryPool* pool) {
+    arena_destroy(&pool->arena);
+    pool->free_list = NULL;
+    pool->live_objects = 0;
 }
 
 // 文件路径验证
@@ -38,6 +409,247 @@ double get_current_time_ms(void) {
     return (double)clock() / CLOCKS_PER_SEC * 1000.0;
 }
 
+// 获取单调时钟时间（毫秒），用于测量墙钟耗时，多线程下同样有效
+double get_monotonic_time_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#endif
+}
+
+// 获取可用的CPU核心数（至少为1）
+int get_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 计算延迟摘要（最近秩法），会对samples就地排序
+void summarize_latencies(double* samples, int count, LatencySummary* summary) {
+    if (summary == NULL) {
+        return;
+    }
+    memset(summary, 0, sizeof(LatencySummary));
+    if (samples == NULL || count <= 0) {
+        return;
+    }
+    
+    qsort(samples, (size_t)count, sizeof(double), compare_doubles);
+    
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    
+    summary->count = count;
+    summary->mean = sum / count;
+    summary->p50 = samples[(int)(0.50 * (count - 1) + 0.5)];
+    summary->p90 = samples[(int)(0.90 * (count - 1) + 0.5)];
+    summary->p99 = samples[(int)(0.99 * (count - 1) + 0.5)];
+    summary->max = samples[count - 1];
+}
+
+// 以只读方式映射整个文件，成功返回1
+// 只映射普通文件：管道、终端等的大小为0，映射会被误当作空文件，因此直接失败，由调用方改为按流读取
+int map_file_readonly(const char* path, MappedFile* file) {
+    if (path == NULL || file == NULL) {
+        return 0;
+    }
+    memset(file, 0, sizeof(MappedFile));
+#ifndef _WIN32
+    file->fd = -1;
+#endif
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    if (GetFileType(handle) != FILE_TYPE_DISK) {
+        CloseHandle(handle);
+        return 0;
+    }
+    
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return 0;
+    }
+    file->file_handle = handle;
+    file->size = (size_t)size.QuadPart;
+    if (file->size == 0) {
+        return 1;
+    }
+    
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        CloseHandle(handle);
+        file->file_handle = NULL;
+        return 0;
+    }
+    file->mapping_handle = mapping;
+    file->data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (file->data == NULL) {
+        unmap_file(file);
+        return 0;
+    }
+#else
+    file->fd = open(path, O_RDONLY);
+    if (file->fd < 0) {
+        return 0;
+    }
+    
+    struct stat st;
+    if (fstat(file->fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(file->fd);
+        file->fd = -1;
+        return 0;
+    }
+    file->size = (size_t)st.st_size;
+    if (file->size == 0) {
+        return 1;
+    }
+    
+    void* data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+    if (data == MAP_FAILED) {
+        close(file->fd);
+        file->fd = -1;
+        return 0;
+    }
+    madvise(data, file->size, MADV_SEQUENTIAL);
+    file->data = (const char*)data;
+#endif
+    
+    return 1;
+}
+
+// 解除文件映射
+void unmap_file(MappedFile* file) {
+    if (file == NULL) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (file->data != NULL) {
+        UnmapViewOfFile(file->data);
+    }
+    if (file->mapping_handle != NULL) {
+        CloseHandle((HANDLE)file->mapping_handle);
+    }
+    if (file->file_handle != NULL) {
+        CloseHandle((HANDLE)file->file_handle);
+    }
+#else
+    if (file->data != NULL) {
+        munmap((void*)file->data, file->size);
+    }
+    if (file->fd >= 0) {
+        close(file->fd);
+    }
+#endif
+    
+    memset(file, 0, sizeof(MappedFile));
+#ifndef _WIN32
+    file->fd = -1;
+#endif
+}
+
+// splitmix64：推进state并返回下一个值，用于展开种子
+uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 由主种子和流编号派生独立的子种子（相同输入总是得到相同输出）
+uint64_t derive_seed(uint64_t master_seed, uint64_t stream) {
+    uint64_t state = master_seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    splitmix64(&state);
+    return splitmix64(&state);
+}
+
+// 设置随机数生成器种子
+void rng_seed(Rng* rng, uint64_t seed) {
+    uint64_t state = seed;
+    for (int i = 0; i < 4; i++) {
+        rng->state[i] = splitmix64(&state);
+    }
+}
+
+static uint64_t rotate_left(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**：返回下一个64位随机数
+uint64_t rng_next(Rng* rng) {
+    uint64_t* s = rng->state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+    
+    return result;
+}
+
+// 返回 [0, bound) 内的随机整数（乘法映射，避免取模）
+int rng_range(Rng* rng, int bound) {
+    if (bound <= 1) {
+        return 0;
+    }
+    return (int)(((rng_next(rng) >> 32) * (uint64_t)bound) >> 32);
+}
+
+// FNV-1a 64位哈希
+uint64_t hash_fnv1a64(const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// 输出JSON字符串（含引号），转义引号、反斜杠和控制字符
+void write_json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* p = (const unsigned char*)text; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', out);
+            fputc(*p, out);
+        } else if (*p < 0x20) {
+            fprintf(out, "\\u%04x", *p);
+        } else {
+            fputc(*p, out);
+        }
+    }
+    fputc('"', out);
+}
+
 // 错误打印函数
 void print_error(const char* function_name, ErrorCode error_code, const char* message) {
     fprintf(stderr, "Error in %s: [%d] %s\n", function_name, error_code, message);
@@ -5,12 +5,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h>
 
 // 通用常量定义
 #define MAX_PATH_LENGTH 512
 #define MAX_LINE_LENGTH 1024
 
+// 线程局部存储（供需要在多线程中独立运行的模块使用）
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 // 通用错误代码
 typedef enum {
     COMMON_SUCCESS = 0,
@@ -21,12 +29,122 @@ typedef enum {
     COMMON_ERROR_UNKNOWN = -99
 } ErrorCode;
 
+// 延迟统计摘要（毫秒）
+typedef struct {
+    int count;          // 样本数量
+    double mean;        // 平均值
+    double p50;         // 中位数
+    double p90;         // 90百分位
+    double p99;         // 99百分位
+    double max;         // 最大值
+} LatencySummary;
+
+// 快速伪随机数生成器（xoshiro256**，种子经splitmix64展开）
+// 状态完全在结构体内，每个线程各持有一个实例即可并行使用，互不干扰
+typedef struct {
+    uint64_t state[4];
+} Rng;
+
+// 只读内存映射文件
+typedef struct {
+    const char* data;   // 文件内容（空文件时为NULL）
+    size_t size;        // 文件大小（字节）
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int fd;
+#endif
+} MappedFile;
+
+// 内存分配统计按子系统区分
+typedef enum {
+    MEMORY_GENERAL,     // 未指定子系统的 safe_malloc/safe_realloc
+    MEMORY_FORMULA,     // 公式、子句与文字
+    MEMORY_PARSER,      // CNF解析与输入缓冲区
+    MEMORY_SOLVER,      // DPLL求解过程
+    MEMORY_SUDOKU,      // 百分号数独
+    MEMORY_SUBSYSTEM_COUNT
+} MemorySubsystem;
+
+// 某个子系统的分配统计（向libc或mmap申请的内存）
+typedef struct {
+    uint64_t bytes_allocated;   // 累计申请字节数
+    uint64_t current_bytes;     // 当前占用字节数
+    uint64_t peak_bytes;        // 占用峰值
+    uint64_t allocations;       // 申请次数（含realloc）
+    uint64_t frees;             // 释放次数
+    uint64_t arena_allocations; // 在区域/对象池内完成、没有调用libc的分配次数
+} MemoryStats;
+
+// 区域/对象池选项：块大小向上取整到 HUGE_PAGE_SIZE，用mmap申请并按大页对齐（Linux下尽量使用大页）；
+// 每个区域至少占用一个大页，只适合大公式，小而多的区域不要设置
+#define MEMORY_HUGE_PAGES 1
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// 区域分配器：在大块内存中顺序分配（16字节对齐），不单独释放，
+// 可以回退到之前的位置（arena_mark/arena_release）或整体清空（arena_reset），已申请的内存块留作复用。
+// 区域本身不加锁，每个区域只应由一个线程使用。
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct {
+    ArenaChunk* first;          // 内存块链表
+    ArenaChunk* current;        // 当前分配所在的块
+    size_t chunk_size;          // 普通块的大小，超出的请求单独成块
+    MemorySubsystem subsystem;
+    int flags;
+    uint64_t allocations;       // 尚未计入统计的区域内分配次数
+} Arena;
+
+// 区域中的位置，用于回退
+typedef struct {
+    ArenaChunk* chunk;
+    size_t used;
+} ArenaMark;
+
+// 定长对象池：空闲对象串成链表，对象内存来自内部的区域，销毁池时一起释放（不加锁）
+typedef struct {
+    Arena arena;
+    void* free_list;
+    size_t object_size;
+    size_t live_objects;        // 已分配未归还的对象数
+} MemoryPool;
+
 // 通用工具函数声明
+// safe_* 为带统计的分配函数的简单包装；safe_realloc/safe_free 沿用指针分配时的子系统
 void* safe_malloc(size_t size);
 void* safe_realloc(void* ptr, size_t size);
 void safe_free(void* ptr);
+void* tracked_malloc(MemorySubsystem subsystem, size_t size);
+void* tracked_realloc(MemorySubsystem subsystem, void* ptr, size_t size);
+void get_memory_stats(MemorySubsystem subsystem, MemoryStats* stats);
+void get_total_memory_stats(MemoryStats* stats);
+const char* memory_subsystem_name(MemorySubsystem subsystem);
+void print_memory_report(FILE* out);
+void arena_init(Arena* arena, MemorySubsystem subsystem, size_t chunk_size, int flags);
+void* arena_alloc(Arena* arena, size_t size);
+ArenaMark arena_mark(const Arena* arena);
+void arena_release(Arena* arena, ArenaMark mark);
+void arena_reset(Arena* arena);
+void arena_destroy(Arena* arena);
+void pool_init(MemoryPool* pool, MemorySubsystem subsystem, size_t object_size, size_t objects_per_chunk, int flags);
+void* pool_alloc(MemoryPool* pool);
+void pool_free(MemoryPool* pool, void* object);
+void pool_destroy(MemoryPool* pool);
 int is_valid_file_path(const char* path);
 double get_current_time_ms(void);
+double get_monotonic_time_ms(void);
+int get_cpu_count(void);
+void summarize_latencies(double* samples, int count, LatencySummary* summary);
+int map_file_readonly(const char* path, MappedFile* file);
+void unmap_file(MappedFile* file);
+uint64_t splitmix64(uint64_t* state);
+uint64_t derive_seed(uint64_t master_seed, uint64_t stream);
+void rng_seed(Rng* rng, uint64_t seed);
+uint64_t rng_next(Rng* rng);
+int rng_range(Rng* rng, int bound);
+uint64_t hash_fnv1a64(const void* data, size_t size);
+void write_json_string(FILE* out, const char* text);
 void print_error(const char* function_name, ErrorCode error_code, const char* message);
 
 #endif // COMMON_H
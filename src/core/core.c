@@ -1,9 +1,21 @@
 #include "core.h"
+#include <pthread.h>
+
+// 单独创建的子句结构体来自对象池（文字数组会增长，仍单独分配）
+static MemoryPool clause_pool;
+static int clause_pool_ready = 0;
+static pthread_mutex_t clause_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 // 创建子句
 Clause* create_clause(int initial_capacity) {
-    Clause* clause = (Clause*)safe_malloc(sizeof(Clause));
-    clause->literals = (int*)safe_malloc(initial_capacity * sizeof(int));
+    pthread_mutex_lock(&clause_pool_mutex);
+    if (!clause_pool_ready) {
+        pool_init(&clause_pool, MEMORY_FORMULA, sizeof(Clause), 256, 0);
+        clause_pool_ready = 1;
+    }
+    Clause* clause = (Clause*)pool_alloc(&clause_pool);
+    pthread_mutex_unlock(&clause_pool_mutex);
+    clause->literals = (int*)tracked_malloc(MEMORY_FORMULA, initial_capacity * sizeof(int));
     
     clause->length = 0;
     clause->capacity = initial_capacity;
@@ -35,15 +47,17 @@ void free_clause(Clause* clause) {
         if (clause->literals != NULL) {
             safe_free(clause->literals);
         }
-        safe_free(clause);
+        pthread_mutex_lock(&clause_pool_mutex);
+        pool_free(&clause_pool, clause);
+        pthread_mutex_unlock(&clause_pool_mutex);
     }
 }
 
 // 创建公式
 Formula* create_formula(int num_vars, int num_clauses) {
-    Formula* formula = (Formula*)safe_malloc(sizeof(Formula));
-    formula->clauses = (Clause*)safe_malloc(num_clauses * sizeof(Clause));
-    formula->var_states = (int*)safe_malloc(num_vars * sizeof(int));
+    Formula* formula = (Formula*)tracked_malloc(MEMORY_FORMULA, sizeof(Formula));
+    formula->clauses = (Clause*)tracked_malloc(MEMORY_FORMULA, num_clauses * sizeof(Clause));
+    formula->var_states = (int*)tracked_malloc(MEMORY_FORMULA, num_vars * sizeof(int));
     
     // 初始化var_states为0
     for (int i = 0; i < num_vars; i++) {
@@ -52,6 +66,9 @@ Formula* create_formula(int num_vars, int num_clauses) {
     
     formula->num_clauses = 0;
     formula->num_vars = num_vars;
+    formula->clause_capacity = num_clauses;
+    // 程序内构造的公式（如每道谜题的编码）通常很小，不值得为每个公式占用一个大页
+    arena_init(&formula->literal_arena, MEMORY_FORMULA, FORMULA_ARENA_CHUNK_SIZE, 0);
     
     // 初始化所有子句
     for (int i = 0; i < num_clauses; i++) {
@@ -63,16 +80,49 @@ Formula* create_formula(int num_vars, int num_clauses) {
     return formula;
 }
 
+// 向公式追加子句（复制文字，容量不足时按倍数扩容）
+void add_clause_to_formula(Formula* formula, const int* literals, int length) {
+    if (formula == NULL || (literals == NULL && length > 0)) {
+        print_error("add_clause_to_formula", COMMON_ERROR_INVALID_PARAMETER, "Formula or literals pointer is NULL");
+        return;
+    }
+    
+    if (formula->num_clauses >= formula->clause_capacity) {
+        int new_capacity = formula->clause_capacity > 0 ? formula->clause_capacity * 2 : 16;
+        formula->clauses = (Clause*)safe_realloc(formula->clauses, new_capacity * sizeof(Clause));
+        formula->clause_capacity = new_capacity;
+    }
+    
+    Clause* clause = &formula->clauses[formula->num_clauses];
+    clause->literals = (int*)arena_alloc(&formula->literal_arena, (length > 0 ? length : 1) * sizeof(int));
+    for (int i = 0; i < length; i++) {
+        clause->literals[i] = literals[i];
+    }
+    clause->length = length;
+    clause->capacity = length;
+    formula->num_clauses++;
+}
+
+// 新增一个变量（用于辅助变量），返回其编号（从1开始）
+int add_variable_to_formula(Formula* formula) {
+    if (formula == NULL) {
+        print_error("add_variable_to_formula", COMMON_ERROR_INVALID_PARAMETER, "Formula pointer is NULL");
+        return -1;
+    }
+    
+    formula->num_vars++;
+    formula->var_states = (int*)safe_realloc(formula->var_states, formula->num_vars * sizeof(int));
+    formula->var_states[formula->num_vars - 1] = 0;
+    
+    return formula->num_vars;
+}
+
 // 释放公式内存
 void free_formula(Formula* formula) {
     if (formula != NULL) {
+        // 文字都存放在文字区中，整体释放一次
+        arena_destroy(&formula->literal_arena);
         if (formula->clauses != NULL) {
-            // 释放每个子句的文字数组
-            for (int i = 0; i < formula->num_clauses; i++) {
-                if (formula->clauses[i].literals != NULL) {
-                    safe_free(formula->clauses[i].literals);
-                }
-            }
             safe_free(formula->clauses);
         }
         
@@ -18,8 +18,12 @@ typedef struct {
     int num_clauses;    // 子句数量
     int num_vars;       // 变量数量
     int* var_states;    // 变量状态数组
+    int clause_capacity; // 子句数组容量
+    Arena literal_arena; // 文字区：所有子句的文字都从这里分配，随公式整体释放
 } Formula;
 
+#define FORMULA_ARENA_CHUNK_SIZE (64 * 1024)
+
 // 函数声明
 
 // 子句操作
@@ -29,6 +33,8 @@ void free_clause(Clause* clause);
 
 // 公式操作
 Formula* create_formula(int num_vars, int num_clauses);
+void add_clause_to_formula(Formula* formula, const int* literals, int length);
+int add_variable_to_formula(Formula* formula);
 void free_formula(Formula* formula);
 void print_formula(const Formula* formula);
 
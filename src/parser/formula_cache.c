@@ -0,0 +1,378 @@
+#include "formula_cache.h"
+#include "parser.h"
+#include "../trace/trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+// 小端序读写
+static void put_u32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void put_u64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const unsigned char* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static uint64_t get_u64(const unsigned char* in) {
+    return (uint64_t)get_u32(in) | ((uint64_t)get_u32(in + 4) << 32);
+}
+
+// 源文件的大小与修改时间（纳秒）
+static int get_source_info(const char* path, uint64_t* size, int64_t* mtime_ns) {
+#ifdef _WIN32
+    struct __stat64 st;
+    if (_stat64(path, &st) != 0) {
+        return 0;
+    }
+    *mtime_ns = (int64_t)st.st_mtime * 1000000000LL;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return 0;
+    }
+    *mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    *size = (uint64_t)st.st_size;
+    return 1;
+}
+
+// 源文件内容哈希
+static int hash_source_file(const char* path, uint64_t* hash) {
+    MappedFile file;
+    if (!map_file_readonly(path, &file)) {
+        return 0;
+    }
+    *hash = hash_fnv1a64(file.data, file.size);
+    unmap_file(&file);
+    return 1;
+}
+
+// 缓存文件路径：源文件名 + ".fcache"
+void formula_cache_path(const char* source_path, char* cache_path, size_t size) {
+    if (source_path == NULL || cache_path == NULL || size == 0) {
+        return;
+    }
+    snprintf(cache_path, size, "%s%s", source_path, FORMULA_CACHE_EXTENSION);
+}
+
+// varint 编码，返回写入的字节数
+static size_t put_varint(unsigned char* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char)value;
+    return length;
+}
+
+// 本机是否为小端序（文字区按小端序i32存放，小端主机可整块复制）
+static int host_is_little_endian(void) {
+    const uint32_t probe = 1;
+    return *(const unsigned char*)&probe == 1;
+}
+
+// 把公式写入缓存文件（先写临时文件再改名，中途失败不会留下损坏的缓存），成功返回1
+// source 为解析时取得的源文件标识
+int save_formula_cache(const Formula* formula, const FormulaCacheSource* source, const char* cache_path) {
+    if (formula == NULL || source == NULL || cache_path == NULL) {
+        print_error("save_formula_cache", COMMON_ERROR_INVALID_PARAMETER, "Formula, source or path is NULL");
+        return 0;
+    }
+    
+    // 子句长度区：每个varint至多5字节
+    uint64_t num_literals = 0;
+    unsigned char* lengths = (unsigned char*)safe_malloc((size_t)formula->num_clauses * 5 + 4);
+    size_t lengths_size = 0;
+    for (int i = 0; i < formula->num_clauses; i++) {
+        lengths_size += put_varint(lengths + lengths_size, (uint64_t)formula->clauses[i].length);
+        num_literals += (uint64_t)formula->clauses[i].length;
+    }
+    size_t padded_size = (lengths_size + 3) & ~(size_t)3;
+    memset(lengths + lengths_size, 0, padded_size - lengths_size);
+    
+    unsigned char header[FORMULA_CACHE_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, FORMULA_CACHE_MAGIC, 4);
+    put_u32(header + 4, FORMULA_CACHE_VERSION);
+    put_u64(header + 8, source->size);
+    put_u64(header + 16, (uint64_t)source->mtime_ns);
+    put_u64(header + 24, source->hash);
+    put_u32(header + 32, (uint32_t)formula->num_vars);
+    put_u32(header + 36, (uint32_t)formula->num_clauses);
+    put_u64(header + 40, num_literals);
+    put_u64(header + 48, (uint64_t)lengths_size);
+    
+    char temp_path[1024];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", cache_path);
+    FILE* file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        print_error("save_formula_cache", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open cache file for writing");
+        safe_free(lengths);
+        return 0;
+    }
+    
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+             fwrite(lengths, 1, padded_size, file) == padded_size;
+    safe_free(lengths);
+    
+    // 文字区：逐个子句写出（大端主机先转换为小端序）
+    unsigned char buffer[4096];
+    for (int i = 0; i < formula->num_clauses && ok; i++) {
+        const Clause* clause = &formula->clauses[i];
+        if (host_is_little_endian()) {
+            size_t size = (size_t)clause->length * sizeof(int);
+            ok = fwrite(clause->literals, 1, size, file) == size;
+            continue;
+        }
+        for (int j = 0; j < clause->length && ok; j += (int)(sizeof(buffer) / 4)) {
+            int count = clause->length - j < (int)(sizeof(buffer) / 4) ? clause->length - j : (int)(sizeof(buffer) / 4);
+            for (int k = 0; k < count; k++) {
+                put_u32(buffer + 4 * k, (uint32_t)clause->literals[j + k]);
+            }
+            ok = fwrite(buffer, 4, (size_t)count, file) == (size_t)count;
+        }
+    }
+    ok = (fclose(file) == 0) && ok;
+
+#ifdef _WIN32
+    remove(cache_path);
+#endif
+    if (!ok || rename(temp_path, cache_path) != 0) {
+        remove(temp_path);
+        print_error("save_formula_cache", COMMON_ERROR_UNKNOWN, "Failed to write cache file");
+        return 0;
+    }
+    return 1;
+}
+
+// 由缓存内容构造公式，数据不合法时返回NULL
+static Formula* decode_formula_cache(const unsigned char* data, size_t size) {
+    int num_vars = (int)get_u32(data + 32);
+    int num_clauses = (int)get_u32(data + 36);
+    uint64_t num_literals = get_u64(data + 40);
+    uint64_t lengths_size = get_u64(data + 48);
+    uint64_t padded_size = (lengths_size + 3) & ~(uint64_t)3;
+    
+    // 文件大小必须与头部记录的各区大小一致
+    if (num_vars < 0 || num_clauses < 0 || lengths_size > size || num_literals > size / 4 ||
+        (uint64_t)FORMULA_CACHE_HEADER_SIZE + padded_size + num_literals * 4 != (uint64_t)size) {
+        return NULL;
+    }
+    
+    Formula* formula = (Formula*)tracked_malloc(MEMORY_FORMULA, sizeof(Formula));
+    formula->num_vars = num_vars;
+    formula->num_clauses = 0;
+    formula->clause_capacity = num_clauses;
+    arena_init(&formula->literal_arena, MEMORY_FORMULA, FORMULA_ARENA_CHUNK_SIZE, MEMORY_HUGE_PAGES);
+    int* literals = (int*)arena_alloc(&formula->literal_arena, (num_literals > 0 ? (size_t)num_literals : 1) * sizeof(int));
+    formula->clauses = (Clause*)tracked_malloc(MEMORY_FORMULA, (num_clauses > 0 ? (size_t)num_clauses : 1) * sizeof(Clause));
+    formula->var_states = (int*)tracked_malloc(MEMORY_FORMULA, (num_vars > 0 ? (size_t)num_vars : 1) * sizeof(int));
+    memset(formula->var_states, 0, (size_t)num_vars * sizeof(int));
+    
+    // 文字区整块复制，再检查每个文字都在变量范围内
+    const unsigned char* literal_data = data + FORMULA_CACHE_HEADER_SIZE + padded_size;
+    if (host_is_little_endian()) {
+        memcpy(literals, literal_data, (size_t)num_literals * sizeof(int));
+    } else {
+        for (uint64_t i = 0; i < num_literals; i++) {
+            literals[i] = (int)get_u32(literal_data + 4 * i);
+        }
+    }
+    int valid = 1;
+    for (uint64_t i = 0; i < num_literals; i++) {
+        int literal = literals[i];
+        valid &= (literal != 0) & (literal <= num_vars) & (literal >= -num_vars);
+    }
+    
+    // 子句长度区
+    const unsigned char* p = data + FORMULA_CACHE_HEADER_SIZE;
+    const unsigned char* end = p + lengths_size;
+    uint64_t remaining = num_literals;
+    for (int i = 0; i < num_clauses && valid; i++) {
+        uint64_t length = 0;
+        int shift = 0;
+        for (;;) {
+            if (p == end || shift > 28) {
+                valid = 0;
+                break;
+            }
+            unsigned char byte = *p++;
+            length |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+            shift += 7;
+        }
+        if (!valid || length > remaining || length > INT_MAX) {
+            valid = 0;
+            break;
+        }
+        
+        Clause* clause = &formula->clauses[i];
+        clause->literals = literals;
+        clause->length = (int)length;
+        clause->capacity = (int)length;
+        literals += length;
+        remaining -= length;
+        formula->num_clauses = i + 1;
+    }
+    
+    if (!valid || remaining != 0 || p != end) {
+        free_formula(formula);
+        return NULL;
+    }
+    return formula;
+}
+
+// 载入缓存：缓存不存在、已过期或已损坏时返回NULL（过期时 *stale 置1）
+Formula* load_formula_cache(const char* source_path, const char* cache_path, int* stale) {
+    if (stale != NULL) {
+        *stale = 0;
+    }
+    if (source_path == NULL || cache_path == NULL) {
+        return NULL;
+    }
+    
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!get_source_info(source_path, &source_size, &source_mtime)) {
+        return NULL;
+    }
+    
+    MappedFile file;
+    if (!map_file_readonly(cache_path, &file)) {
+        return NULL;
+    }
+    
+    const unsigned char* header = (const unsigned char*)file.data;
+    if (file.size < FORMULA_CACHE_HEADER_SIZE || memcmp(header, FORMULA_CACHE_MAGIC, 4) != 0 ||
+        get_u32(header + 4) != FORMULA_CACHE_VERSION) {
+        unmap_file(&file);
+        if (stale != NULL) {
+            *stale = 1;
+        }
+        return NULL;
+    }
+    
+    // 大小不同必然过期；只有修改时间不同时比较内容哈希，内容未变则更新缓存中的修改时间
+    int fresh = get_u64(header + 8) == source_size;
+    if (fresh && (int64_t)get_u64(header + 16) != source_mtime) {
+        uint64_t source_hash;
+        fresh = hash_source_file(source_path, &source_hash) && source_hash == get_u64(header + 24);
+        if (fresh) {
+            FILE* update = fopen(cache_path, "r+b");
+            if (update != NULL) {
+                unsigned char mtime[8];
+                put_u64(mtime, (uint64_t)source_mtime);
+                if (fseek(update, 16, SEEK_SET) == 0) {
+                    fwrite(mtime, 1, sizeof(mtime), update);
+                }
+                fclose(update);
+            }
+        }
+    }
+    
+    Formula* formula = NULL;
+    if (fresh) {
+        formula = decode_formula_cache(header, file.size);
+    }
+    unmap_file(&file);
+    
+    if (formula == NULL && stale != NULL) {
+        *stale = 1;
+    }
+    return formula;
+}
+
+// 映射源文件，在同一映射上计算内容哈希并解析（与 parse_cnf_file 相同：大文件并行解析，
+// 压缩文件仍流式解压）；无法映射时照常解析，*hashed 置0
+static Formula* parse_and_hash_source(const char* filename, uint64_t* hash, int* hashed) {
+    MappedFile file;
+    if (!map_file_readonly(filename, &file)) {
+        *hashed = 0;
+        return parse_cnf_file(filename);
+    }
+    
+    *hash = hash_fnv1a64(file.data, file.size);
+    *hashed = 1;
+    
+    Formula* formula;
+    if (detect_input_compression((const unsigned char*)file.data, file.size) != INPUT_COMPRESSION_NONE) {
+        formula = parse_cnf_file(filename);
+    } else if (file.size < CNF_PARALLEL_MIN_BYTES) {
+        formula = parse_cnf_buffer(file.data, file.size);
+    } else {
+        formula = parse_cnf_buffer_parallel(file.data, file.size, 0);
+    }
+    unmap_file(&file);
+    return formula;
+}
+
+// 先查缓存，未命中时解析源文件并写入缓存
+Formula* parse_cnf_file_cached(const char* filename, int use_cache, FormulaCacheStatus* status) {
+    FormulaCacheStatus result = FORMULA_CACHE_DISABLED;
+    FormulaCacheSource source = {0, 0, 0};
+    
+    // 标准输入与小文件不缓存
+    if (!use_cache || filename == NULL || strcmp(filename, "-") == 0 ||
+        !get_source_info(filename, &source.size, &source.mtime_ns) || source.size < FORMULA_CACHE_MIN_BYTES) {
+        if (status != NULL) {
+            *status = result;
+        }
+        return parse_cnf_file(filename);
+    }
+    
+    char cache_path[1024];
+    formula_cache_path(filename, cache_path, sizeof(cache_path));
+    
+    int stale = 0;
+    TRACE_BEGIN("parser", "cache_load");
+    Formula* formula = load_formula_cache(filename, cache_path, &stale);
+    TRACE_END("parser", "cache_load");
+    if (formula != NULL) {
+        result = FORMULA_CACHE_HIT;
+    } else {
+        int hashed;
+        formula = parse_and_hash_source(filename, &source.hash, &hashed);
+        
+        // 解析期间源文件被改动时，公式与记录的标识可能不对应，不写缓存
+        uint64_t size_after;
+        int64_t mtime_after;
+        int unchanged = get_source_info(filename, &size_after, &mtime_after) &&
+                        size_after == source.size && mtime_after == source.mtime_ns;
+        
+        TRACE_BEGIN("parser", "cache_save");
+        if (formula != NULL && hashed && unchanged && save_formula_cache(formula, &source, cache_path)) {
+            result = stale ? FORMULA_CACHE_STALE : FORMULA_CACHE_MISS;
+        }
+        TRACE_END("parser", "cache_save");
+    }
+    
+    if (status != NULL) {
+        *status = result;
+    }
+    return formula;
+}
+
+// 缓存使用情况名称
+const char* formula_cache_status_name(FormulaCacheStatus status) {
+    switch (status) {
+        case FORMULA_CACHE_DISABLED: return "disabled";
+        case FORMULA_CACHE_HIT: return "hit";
+        case FORMULA_CACHE_MISS: return "miss, saved";
+        case FORMULA_CACHE_STALE: return "stale, rebuilt";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef FORMULA_CACHE_H
+#define FORMULA_CACHE_H
+
+#include "../common/common.h"
+#include "../core/core.h"
+
+// 预解析公式缓存
+// 第一次解析CNF文件后把公式写成紧凑的二进制文件（源文件名 + ".fcache"），之后再求解同一文件时
+// 直接映射缓存文件并解码，不再扫描文本。缓存记录源文件的大小、修改时间和内容哈希：
+// 大小与修改时间都未变时直接使用；只有修改时间变化时重新计算源文件哈希，相同则继续使用
+// （并更新缓存中的修改时间），否则视为过期，重新解析并覆盖缓存。
+// 写缓存时记录的大小与修改时间在解析前取得，内容哈希在解析所用的同一映射上计算，源文件不再
+// 读第二遍；解析结束后源文件的大小或修改时间已变化时不写缓存，避免把新内容记成旧公式。
+//
+// 缓存文件（小端序）：
+//   0   "FCNF"     魔数
+//   4   u32        版本号，当前为1
+//   8   u64        源文件大小
+//   16  i64        源文件修改时间（纳秒）
+//   24  u64        源文件内容的FNV-1a 64位哈希
+//   32  i32        变量数
+//   36  i32        子句数
+//   40  u64        文字总数
+//   48  u64        子句长度区字节数
+//   56  u64        保留（0）
+//   64  子句长度区：每个子句长度为一个varint（通常1字节），末尾补0对齐到4字节
+//   之后 文字区：所有文字依次为i32，载入时整块复制到公式的文字区（Formula.literal_arena）
+// 文字不做变长编码：变长解码每个文字约需10ns，远慢于整块复制，而缓存的目的正是快速载入。
+
+#define FORMULA_CACHE_MAGIC "FCNF"
+#define FORMULA_CACHE_VERSION 1
+#define FORMULA_CACHE_HEADER_SIZE 64
+#define FORMULA_CACHE_EXTENSION ".fcache"
+#define FORMULA_CACHE_MIN_BYTES (1024 * 1024)   // 小于该大小的源文件不值得缓存
+
+// 缓存使用情况
+typedef enum {
+    FORMULA_CACHE_DISABLED,     // 未使用缓存（标准输入、小文件或已关闭）
+    FORMULA_CACHE_HIT,          // 从缓存载入
+    FORMULA_CACHE_MISS,         // 无缓存，解析后已写入
+    FORMULA_CACHE_STALE         // 缓存过期，解析后已覆盖
+} FormulaCacheStatus;
+
+// 源文件标识，写入缓存头部
+typedef struct {
+    uint64_t size;              // 文件大小
+    int64_t mtime_ns;           // 修改时间（纳秒）
+    uint64_t hash;              // 内容的FNV-1a 64位哈希
+} FormulaCacheSource;
+
+// 函数声明
+
+void formula_cache_path(const char* source_path, char* cache_path, size_t size);
+int save_formula_cache(const Formula* formula, const FormulaCacheSource* source, const char* cache_path);
+Formula* load_formula_cache(const char* source_path, const char* cache_path, int* stale);
+
+// 先查缓存，未命中时解析源文件并写入缓存；use_cache 为0时只解析
+Formula* parse_cnf_file_cached(const char* filename, int use_cache, FormulaCacheStatus* status);
+const char* formula_cache_status_name(FormulaCacheStatus status);
+
+#endif // FORMULA_CACHE_H
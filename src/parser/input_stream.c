@@ -0,0 +1,392 @@
+#include "input_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+// 输入流
+struct InputStream {
+    FILE* file;
+    int owns_file;                  // 标准输入不由输入流关闭
+    InputCompression compression;
+    unsigned char* raw;             // 原始（压缩）数据缓冲
+    size_t raw_size;                // raw 中的有效字节数
+    size_t raw_pos;                 // 已消费到的位置
+    int raw_eof;                    // 原始数据已读完
+    int finished;                   // 解压后的数据已读完
+    int error;
+#ifdef HAVE_ZLIB
+    z_stream zlib;
+    int zlib_ready;
+#endif
+#ifdef HAVE_LZMA
+    lzma_stream lzma;
+    int lzma_ready;
+#endif
+#ifdef HAVE_BZIP2
+    bz_stream bzip2;
+    int bzip2_ready;
+#endif
+};
+
+// 按魔数识别压缩格式
+InputCompression detect_input_compression(const unsigned char* data, size_t size) {
+    if (data == NULL) {
+        return INPUT_COMPRESSION_NONE;
+    }
+    if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+        return INPUT_COMPRESSION_GZIP;
+    }
+    if (size >= 6 && memcmp(data, "\xfd" "7zXZ\0", 6) == 0) {
+        return INPUT_COMPRESSION_XZ;
+    }
+    if (size >= 3 && data[0] == 'B' && data[1] == 'Z' && data[2] == 'h') {
+        return INPUT_COMPRESSION_BZIP2;
+    }
+    return INPUT_COMPRESSION_NONE;
+}
+
+// 压缩格式名称
+const char* input_compression_name(InputCompression compression) {
+    switch (compression) {
+        case INPUT_COMPRESSION_NONE: return "none";
+        case INPUT_COMPRESSION_GZIP: return "gzip";
+        case INPUT_COMPRESSION_XZ: return "xz";
+        case INPUT_COMPRESSION_BZIP2: return "bzip2";
+        default: return "unknown";
+    }
+}
+
+// 构建时是否启用了该格式的解压
+int input_compression_supported(InputCompression compression) {
+    switch (compression) {
+        case INPUT_COMPRESSION_NONE: return 1;
+#ifdef HAVE_ZLIB
+        case INPUT_COMPRESSION_GZIP: return 1;
+#endif
+#ifdef HAVE_LZMA
+        case INPUT_COMPRESSION_XZ: return 1;
+#endif
+#ifdef HAVE_BZIP2
+        case INPUT_COMPRESSION_BZIP2: return 1;
+#endif
+        default: return 0;
+    }
+}
+
+// 记录读取错误
+static void stream_fail(InputStream* stream, const char* message) {
+    if (!stream->error) {
+        print_error("read_input_stream", COMMON_ERROR_UNKNOWN, message);
+    }
+    stream->error = 1;
+}
+
+// 原始缓冲为空时从文件补充，返回是否有可用的原始数据
+static int fill_raw(InputStream* stream) {
+    if (stream->raw_pos < stream->raw_size) {
+        return 1;
+    }
+    if (stream->raw_eof) {
+        return 0;
+    }
+    
+    size_t count = fread(stream->raw, 1, INPUT_STREAM_BUFFER_SIZE, stream->file);
+    stream->raw_size = count;
+    stream->raw_pos = 0;
+    if (count == 0) {
+        stream->raw_eof = 1;
+        if (ferror(stream->file)) {
+            stream_fail(stream, "Read error");
+        }
+        return 0;
+    }
+    return 1;
+}
+
+// 未压缩：先交出识别格式时预读的数据，之后直接读入调用者的缓冲
+static size_t read_plain(InputStream* stream, char* buffer, size_t size) {
+    if (stream->raw_pos < stream->raw_size) {
+        size_t count = stream->raw_size - stream->raw_pos;
+        if (count > size) {
+            count = size;
+        }
+        memcpy(buffer, stream->raw + stream->raw_pos, count);
+        stream->raw_pos += count;
+        return count;
+    }
+    if (stream->raw_eof) {
+        return 0;
+    }
+    
+    size_t count = fread(buffer, 1, size, stream->file);
+    if (count == 0) {
+        stream->raw_eof = 1;
+        if (ferror(stream->file)) {
+            stream_fail(stream, "Read error");
+        }
+    }
+    return count;
+}
+
+#ifdef HAVE_ZLIB
+// gzip：一个成员结束后若紧跟下一个成员（魔数1f）则继续解压，否则结束
+static size_t read_gzip(InputStream* stream, char* buffer, size_t size) {
+    z_stream* z = &stream->zlib;
+    z->next_out = (Bytef*)buffer;
+    z->avail_out = (uInt)(size < UINT_MAX ? size : UINT_MAX);
+    uInt capacity = z->avail_out;
+    
+    while (z->avail_out > 0 && !stream->finished && !stream->error) {
+        if (!fill_raw(stream)) {
+            if (!stream->error) {
+                stream_fail(stream, "Unexpected end of gzip data");
+            }
+            break;
+        }
+        z->next_in = stream->raw + stream->raw_pos;
+        z->avail_in = (uInt)(stream->raw_size - stream->raw_pos);
+        
+        int ret = inflate(z, Z_NO_FLUSH);
+        stream->raw_pos = stream->raw_size - z->avail_in;
+        
+        if (ret == Z_STREAM_END) {
+            if (!fill_raw(stream) || stream->raw[stream->raw_pos] != 0x1f) {
+                stream->finished = 1;
+            } else {
+                inflateReset(z);
+            }
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            stream_fail(stream, "Corrupt gzip data");
+        }
+    }
+    return capacity - z->avail_out;
+}
+#endif
+
+#ifdef HAVE_LZMA
+// xz：解码器以 LZMA_CONCATENATED 打开，原始数据读完后以 LZMA_FINISH 收尾
+static size_t read_xz(InputStream* stream, char* buffer, size_t size) {
+    lzma_stream* x = &stream->lzma;
+    x->next_out = (uint8_t*)buffer;
+    x->avail_out = size;
+    
+    while (x->avail_out > 0 && !stream->finished && !stream->error) {
+        fill_raw(stream);
+        if (stream->error) {
+            break;
+        }
+        x->next_in = stream->raw + stream->raw_pos;
+        x->avail_in = stream->raw_size - stream->raw_pos;
+        
+        lzma_ret ret = lzma_code(x, stream->raw_eof ? LZMA_FINISH : LZMA_RUN);
+        stream->raw_pos = stream->raw_size - x->avail_in;
+        
+        if (ret == LZMA_STREAM_END) {
+            stream->finished = 1;
+        } else if (ret == LZMA_BUF_ERROR && stream->raw_eof) {
+            stream_fail(stream, "Unexpected end of xz data");
+        } else if (ret != LZMA_OK && ret != LZMA_BUF_ERROR) {
+            stream_fail(stream, "Corrupt xz data");
+        }
+    }
+    return size - x->avail_out;
+}
+#endif
+
+#ifdef HAVE_BZIP2
+// bzip2：一个流结束后若紧跟下一个流（"BZh"，如pbzip2的输出）则重新初始化解码器
+static size_t read_bzip2(InputStream* stream, char* buffer, size_t size) {
+    bz_stream* b = &stream->bzip2;
+    b->next_out = buffer;
+    b->avail_out = (unsigned int)(size < UINT_MAX ? size : UINT_MAX);
+    unsigned int capacity = b->avail_out;
+    
+    while (b->avail_out > 0 && !stream->finished && !stream->error) {
+        if (!fill_raw(stream)) {
+            if (!stream->error) {
+                stream_fail(stream, "Unexpected end of bzip2 data");
+            }
+            break;
+        }
+        b->next_in = (char*)stream->raw + stream->raw_pos;
+        b->avail_in = (unsigned int)(stream->raw_size - stream->raw_pos);
+        
+        int ret = BZ2_bzDecompress(b);
+        stream->raw_pos = stream->raw_size - b->avail_in;
+        
+        if (ret == BZ_STREAM_END) {
+            char* next_out = b->next_out;
+            unsigned int avail_out = b->avail_out;
+            BZ2_bzDecompressEnd(b);
+            stream->bzip2_ready = 0;
+            if (!fill_raw(stream) || stream->raw[stream->raw_pos] != 'B') {
+                stream->finished = 1;
+            } else {
+                memset(b, 0, sizeof(bz_stream));
+                if (BZ2_bzDecompressInit(b, 0, 0) != BZ_OK) {
+                    stream_fail(stream, "Cannot initialize bzip2 decoder");
+                    break;
+                }
+                stream->bzip2_ready = 1;
+                b->next_out = next_out;
+                b->avail_out = avail_out;
+            }
+        } else if (ret != BZ_OK) {
+            stream_fail(stream, "Corrupt bzip2 data");
+        }
+    }
+    return capacity - b->avail_out;
+}
+#endif
+
+// 打开输入流并识别压缩格式
+InputStream* open_input_stream(const char* path) {
+    if (path == NULL) {
+        print_error("open_input_stream", COMMON_ERROR_INVALID_PARAMETER, "Path is NULL");
+        return NULL;
+    }
+    
+    InputStream* stream = (InputStream*)tracked_malloc(MEMORY_PARSER, sizeof(InputStream));
+    memset(stream, 0, sizeof(InputStream));
+    
+    if (strcmp(path, "-") == 0) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        stream->file = stdin;
+        stream->owns_file = 0;
+    } else {
+        stream->file = fopen(path, "rb");
+        if (stream->file == NULL) {
+            print_error("open_input_stream", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open file");
+            safe_free(stream);
+            return NULL;
+        }
+        stream->owns_file = 1;
+    }
+    
+    // 预读第一块用于识别格式，这部分数据随后交给解码器
+    stream->raw = (unsigned char*)tracked_malloc(MEMORY_PARSER, INPUT_STREAM_BUFFER_SIZE);
+    fill_raw(stream);
+    stream->compression = detect_input_compression(stream->raw, stream->raw_size);
+    
+    if (!input_compression_supported(stream->compression)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s input needs %s support, which was not enabled at build time",
+                 input_compression_name(stream->compression), input_compression_name(stream->compression));
+        print_error("open_input_stream", COMMON_ERROR_UNKNOWN, message);
+        close_input_stream(stream);
+        return NULL;
+    }
+    
+    int ready = 1;
+    switch (stream->compression) {
+#ifdef HAVE_ZLIB
+        case INPUT_COMPRESSION_GZIP:
+            // 15+16：只接受gzip头
+            ready = (inflateInit2(&stream->zlib, 15 + 16) == Z_OK);
+            stream->zlib_ready = ready;
+            break;
+#endif
+#ifdef HAVE_LZMA
+        case INPUT_COMPRESSION_XZ: {
+            lzma_stream init = LZMA_STREAM_INIT;
+            stream->lzma = init;
+            ready = (lzma_stream_decoder(&stream->lzma, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK);
+            stream->lzma_ready = ready;
+            break;
+        }
+#endif
+#ifdef HAVE_BZIP2
+        case INPUT_COMPRESSION_BZIP2:
+            ready = (BZ2_bzDecompressInit(&stream->bzip2, 0, 0) == BZ_OK);
+            stream->bzip2_ready = ready;
+            break;
+#endif
+        default:
+            break;
+    }
+    if (!ready) {
+        print_error("open_input_stream", COMMON_ERROR_MEMORY_ALLOCATION, "Cannot initialize decoder");
+        close_input_stream(stream);
+        return NULL;
+    }
+    
+    return stream;
+}
+
+// 读取解压后的数据
+size_t read_input_stream(InputStream* stream, char* buffer, size_t size) {
+    if (stream == NULL || buffer == NULL || size == 0 || stream->error) {
+        return 0;
+    }
+    
+    switch (stream->compression) {
+        case INPUT_COMPRESSION_NONE:
+            return read_plain(stream, buffer, size);
+#ifdef HAVE_ZLIB
+        case INPUT_COMPRESSION_GZIP:
+            return read_gzip(stream, buffer, size);
+#endif
+#ifdef HAVE_LZMA
+        case INPUT_COMPRESSION_XZ:
+            return read_xz(stream, buffer, size);
+#endif
+#ifdef HAVE_BZIP2
+        case INPUT_COMPRESSION_BZIP2:
+            return read_bzip2(stream, buffer, size);
+#endif
+        default:
+            return 0;
+    }
+}
+
+int input_stream_error(const InputStream* stream) {
+    return stream == NULL || stream->error;
+}
+
+InputCompression input_stream_compression(const InputStream* stream) {
+    return stream != NULL ? stream->compression : INPUT_COMPRESSION_NONE;
+}
+
+// 关闭输入流
+void close_input_stream(InputStream* stream) {
+    if (stream == NULL) {
+        return;
+    }
+
+#ifdef HAVE_ZLIB
+    if (stream->zlib_ready) {
+        inflateEnd(&stream->zlib);
+    }
+#endif
+#ifdef HAVE_LZMA
+    if (stream->lzma_ready) {
+        lzma_end(&stream->lzma);
+    }
+#endif
+#ifdef HAVE_BZIP2
+    if (stream->bzip2_ready) {
+        BZ2_bzDecompressEnd(&stream->bzip2);
+    }
+#endif
+    if (stream->owns_file && stream->file != NULL) {
+        fclose(stream->file);
+    }
+    safe_free(stream->raw);
+    safe_free(stream);
+}
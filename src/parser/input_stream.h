@@ -0,0 +1,40 @@
+#ifndef INPUT_STREAM_H
+#define INPUT_STREAM_H
+
+#include "../common/common.h"
+
+// 带缓冲的输入流：按魔数识别压缩格式并边读边解压
+// 支持 gzip（zlib）、xz（liblzma）、bzip2（libbz2），构建时找到对应的库才启用
+// （HAVE_ZLIB / HAVE_LZMA / HAVE_BZIP2，由Makefile自动检测）。
+// 路径为 "-" 时读取标准输入；多个压缩流首尾相接的文件会被连续解压。
+
+#define INPUT_STREAM_BUFFER_SIZE (1024 * 1024)
+
+// 压缩格式
+typedef enum {
+    INPUT_COMPRESSION_NONE,
+    INPUT_COMPRESSION_GZIP,     // 1f 8b
+    INPUT_COMPRESSION_XZ,       // fd 37 7a 58 5a 00
+    INPUT_COMPRESSION_BZIP2     // "BZh"
+} InputCompression;
+
+// 输入流（内部状态取决于启用的压缩库，不对外公开）
+typedef struct InputStream InputStream;
+
+// 函数声明
+
+// 打开输入流并识别压缩格式，失败或格式不受支持时返回NULL
+InputStream* open_input_stream(const char* path);
+
+// 读取解压后的数据，返回读到的字节数，0表示结束或出错（用 input_stream_error 区分）
+size_t read_input_stream(InputStream* stream, char* buffer, size_t size);
+int input_stream_error(const InputStream* stream);
+InputCompression input_stream_compression(const InputStream* stream);
+void close_input_stream(InputStream* stream);
+
+// 格式识别
+InputCompression detect_input_compression(const unsigned char* data, size_t size);
+const char* input_compression_name(InputCompression compression);
+int input_compression_supported(InputCompression compression);
+
+#endif // INPUT_STREAM_H
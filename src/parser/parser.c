@@ -3,6 +3,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "../trace/trace.h"
 
 // 错误处理函数
 void parser_error(const char* message) {
@@ -17,8 +21,10 @@ Clause* parse_clause_line(const char* line) {
     // 跳过行首空白字符
     while (isspace(*line)) line++;
     
-    // 使用strtok分割字符串
-    char* line_copy = strdup(line);
+    // 使用strtok分割字符串（副本之后用safe_free释放，因此同样用safe_malloc分配）
+    size_t line_length = strlen(line);
+    char* line_copy = (char*)safe_malloc(line_length + 1);
+    memcpy(line_copy, line, line_length + 1);
     char* token = strtok(line_copy, " \t\n");
     
     while (token != NULL) {
@@ -39,105 +45,700 @@ Clause* parse_clause_line(const char* line) {
     return clause;
 }
 
-// 解析CNF文件的主要函数
-Formula* parse_cnf_file(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        print_error("parse_cnf_file", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open file");
-        return NULL;
+// 记录扫描错误（附带行号），返回0
+static int scan_fail(CnfScanState* state, const char* message) {
+    if (!state->silent) {
+        char text[160];
+        snprintf(text, sizeof(text), "%s (line %lld)", message, state->line);
+        print_error("parse_cnf", COMMON_ERROR_INVALID_PARAMETER, text);
     }
+    state->error = 1;
+    return 0;
+}
+
+// 初始化扫描状态
+void init_cnf_scan_state(CnfScanState* state) {
+    if (state == NULL) return;
     
-    char line[1024];
+    memset(state, 0, sizeof(CnfScanState));
+    state->mode = CNF_SCAN_LINE_START;
+    state->line = 1;
+}
+
+// 释放扫描状态持有的内存
+void free_cnf_scan_state(CnfScanState* state) {
+    if (state == NULL) return;
+    
+    safe_free(state->literals);
+    safe_free(state->clauses);
+    init_cnf_scan_state(state);
+}
+
+// 解析问题行 "p cnf <变量数> <子句数>"
+static int parse_problem_line(CnfScanState* state) {
+    char format[16];
     int num_vars = 0;
     int num_clauses = 0;
-    Formula* formula = NULL;
     
-    // 逐行读取文件
-    while (fgets(line, sizeof(line), file) != NULL) {
-        // 去除行末换行符
-        line[strcspn(line, "\n")] = 0;
-        
-        // 跳过空行
-        if (strlen(line) == 0) {
-            continue;
+    state->header[state->header_length] = '\0';
+    if (state->header_seen) {
+        return scan_fail(state, "Duplicate problem line");
+    }
+    if (sscanf(state->header, "p %15s %d %d", format, &num_vars, &num_clauses) != 3) {
+        return scan_fail(state, "Cannot parse problem line");
+    }
+    if (strcmp(format, "cnf") != 0) {
+        return scan_fail(state, "Unsupported format, only CNF format is supported");
+    }
+    if (num_vars < 0 || num_clauses < 0) {
+        return scan_fail(state, "Negative count in problem line");
+    }
+    
+    state->header_seen = 1;
+    state->num_vars = num_vars;
+    state->declared_clauses = num_clauses;
+    
+    // 按声明的子句数预留子句数组
+    if (num_clauses > state->clause_capacity) {
+        state->clauses = (Clause*)tracked_realloc(MEMORY_PARSER, state->clauses, (size_t)num_clauses * sizeof(Clause));
+        state->clause_capacity = num_clauses;
+    }
+    return 1;
+}
+
+// 结束当前子句（遇到0或输入结束）
+static int close_clause(CnfScanState* state) {
+    if (state->num_clauses >= state->clause_capacity) {
+        if (state->clause_capacity >= INT_MAX / 2) {
+            return scan_fail(state, "Too many clauses");
         }
-        
-        // 如果行以 'c' 开头，忽略（注释行）
-        if (line[0] == 'c') {
-            continue;
+        int new_capacity = state->clause_capacity > 0 ? state->clause_capacity * 2 : 1024;
+        state->clauses = (Clause*)tracked_realloc(MEMORY_PARSER, state->clauses, (size_t)new_capacity * sizeof(Clause));
+        state->clause_capacity = new_capacity;
+    }
+    
+    size_t length = state->num_literals - state->clause_start;
+    if (length > INT_MAX) {
+        return scan_fail(state, "Clause too long");
+    }
+    
+    Clause* clause = &state->clauses[state->num_clauses++];
+    clause->literals = NULL;
+    clause->length = (int)length;
+    clause->capacity = (int)length;
+    state->clause_start = state->num_literals;
+    return 1;
+}
+
+// 一个数字扫描完毕：0结束子句，其余追加到文字区
+static inline int finish_number(CnfScanState* state, int negative, long long value) {
+    if (value == 0) {
+        if (negative) {
+            return scan_fail(state, "Malformed literal");
         }
-        
-        // 如果行以 'p' 开头，解析问题行
-        if (line[0] == 'p') {
-            char format[10];
-            if (sscanf(line, "p %s %d %d", format, &num_vars, &num_clauses) != 3) {
-                parser_error("Cannot parse problem line");
+        return close_clause(state);
+    }
+    if (value > state->num_vars) {
+        return scan_fail(state, state->header_seen ? "Variable exceeds the count in the problem line"
+                                                   : "Problem line not found before parsing clauses");
+    }
+    
+    if (state->num_literals >= state->literal_capacity) {
+        size_t new_capacity = state->literal_capacity > 0 ? state->literal_capacity * 2 : 65536;
+        state->literals = (int*)tracked_realloc(MEMORY_PARSER, state->literals, new_capacity * sizeof(int));
+        state->literal_capacity = new_capacity;
+    }
+    state->literals[state->num_literals++] = negative ? -(int)value : (int)value;
+    if ((int)value > state->max_var) {
+        state->max_var = (int)value;
+    }
+    return 1;
+}
+
+// 扫描一块数据，出错返回0
+int scan_cnf_block(CnfScanState* state, const char* data, size_t length) {
+    if (state == NULL || (data == NULL && length > 0)) {
+        print_error("scan_cnf_block", COMMON_ERROR_INVALID_PARAMETER, "State or data is NULL");
+        return 0;
+    }
+    if (state->error) {
+        return 0;
+    }
+    
+    const char* p = data;
+    const char* end = data + length;
+    
+    while (p < end) {
+        switch (state->mode) {
+            case CNF_SCAN_END:
+                return 1;
+            
+            case CNF_SCAN_COMMENT: {
+                const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+                if (newline == NULL) {
+                    return 1;
+                }
+                p = newline + 1;
+                state->line++;
+                state->mode = CNF_SCAN_LINE_START;
+                break;
             }
             
-            // 检查格式是否为cnf
-            if (strcmp(format, "cnf") != 0) {
-                parser_error("Unsupported format, only CNF format is supported");
+            case CNF_SCAN_HEADER: {
+                while (p < end && *p != '\n') {
+                    if (state->header_length < CNF_SCAN_HEADER_MAX - 1) {
+                        state->header[state->header_length++] = *p;
+                    }
+                    p++;
+                }
+                if (p == end) {
+                    return 1;
+                }
+                if (!parse_problem_line(state)) {
+                    return 0;
+                }
+                p++;
+                state->line++;
+                state->mode = CNF_SCAN_LINE_START;
+                break;
             }
             
-            // 创建公式结构
-            formula = create_formula(num_vars, num_clauses);
-            continue;
+            case CNF_SCAN_NUMBER: {
+                // 上一块末尾被截断的数字，在这里继续累加
+                long long value = state->value;
+                while (p < end && (unsigned char)(*p - '0') < 10) {
+                    value = value * 10 + (*p - '0');
+                    if (value > INT_MAX) {
+                        return scan_fail(state, "Literal out of range");
+                    }
+                    p++;
+                }
+                state->value = value;
+                if (p == end) {
+                    return 1;
+                }
+                if (*p != ' ' && *p != '\n' && *p != '\t' && *p != '\r') {
+                    return scan_fail(state, "Unexpected character in literal");
+                }
+                if (!finish_number(state, state->negative, value)) {
+                    return 0;
+                }
+                state->mode = CNF_SCAN_TOKENS;
+                break;
+            }
+            
+            case CNF_SCAN_LINE_START:
+            case CNF_SCAN_TOKENS: {
+                // 快速路径：在本块内连续处理空白与数字，遇到其他字符再回到状态分派。
+                // 文字区的写入位置等热字段放在局部变量中，只在进入慢路径前后与状态同步
+                CnfScanMode mode = state->mode;
+                int* literals = state->literals;
+                size_t count = state->num_literals;
+                size_t capacity = state->literal_capacity;
+                int max_var = state->max_var;
+                const long long num_vars = state->num_vars;
+                
+                while (p < end) {
+                    char ch = *p;
+                    if (ch == ' ' || ch == '\t' || ch == '\r') {
+                        p++;
+                        continue;
+                    }
+                    if (ch == '\n') {
+                        state->line++;
+                        mode = CNF_SCAN_LINE_START;
+                        p++;
+                        continue;
+                    }
+                    if ((unsigned char)(ch - '0') >= 10 && ch != '-') {
+                        break;
+                    }
+                    
+                    // 就地扫描整个数字（超过10位必然越界，扫描完再统一检查）
+                    int negative = (ch == '-');
+                    const char* q = p + negative;
+                    unsigned long long value = 0;
+                    while (q < end && (unsigned char)(*q - '0') < 10) {
+                        value = value * 10 + (unsigned)(*q - '0');
+                        q++;
+                    }
+                    if (q - p - negative > 10 || value > INT_MAX) {
+                        state->num_literals = count;
+                        return scan_fail(state, "Literal out of range");
+                    }
+                    
+                    // 数字被块边界截断：保存到状态中，下一块继续
+                    if (q == end) {
+                        state->num_literals = count;
+                        state->max_var = max_var;
+                        state->negative = negative;
+                        state->value = value;
+                        state->mode = CNF_SCAN_NUMBER;
+                        return 1;
+                    }
+                    if (*q != ' ' && *q != '\n' && *q != '\t' && *q != '\r') {
+                        state->num_literals = count;
+                        return scan_fail(state, "Unexpected character in literal");
+                    }
+                    p = q;
+                    mode = CNF_SCAN_TOKENS;
+                    
+                    // 常见情况直接写入文字区；子句结束、扩容与错误交给 finish_number
+                    if (value != 0 && (long long)value <= num_vars && count < capacity) {
+                        literals[count++] = negative ? -(int)value : (int)value;
+                        if ((int)value > max_var) {
+                            max_var = (int)value;
+                        }
+                        continue;
+                    }
+                    state->num_literals = count;
+                    state->max_var = max_var;
+                    if (!finish_number(state, negative, (long long)value)) {
+                        return 0;
+                    }
+                    literals = state->literals;
+                    count = state->num_literals;
+                    capacity = state->literal_capacity;
+                    max_var = state->max_var;
+                }
+                state->num_literals = count;
+                state->max_var = max_var;
+                state->mode = mode;
+                
+                if (p == end) {
+                    return 1;
+                }
+                
+                char ch = *p;
+                if (state->mode == CNF_SCAN_LINE_START && ch == 'c') {
+                    state->mode = CNF_SCAN_COMMENT;
+                } else if (state->mode == CNF_SCAN_LINE_START && ch == 'p') {
+                    state->header_length = 0;
+                    state->mode = CNF_SCAN_HEADER;
+                } else if (state->mode == CNF_SCAN_LINE_START && ch == '%') {
+                    // SATLIB格式以"%"行结束
+                    state->mode = CNF_SCAN_END;
+                } else {
+                    return scan_fail(state, "Unexpected character");
+                }
+                break;
+            }
         }
-        
-        // 其他行就是子句
-        if (formula == NULL) {
-            parser_error("Problem line not found before parsing clauses");
+    }
+    
+    return 1;
+}
+
+// 结束扫描：收尾未结束的数字和子句，把文字区与子句交给新公式，出错返回NULL
+Formula* finish_cnf_scan(CnfScanState* state) {
+    if (state == NULL) {
+        print_error("finish_cnf_scan", COMMON_ERROR_INVALID_PARAMETER, "State is NULL");
+        return NULL;
+    }
+    
+    // 输入在数字、问题行中间或缺少结尾的0时结束
+    if (!state->error && state->mode == CNF_SCAN_NUMBER) {
+        finish_number(state, state->negative, state->value);
+    }
+    if (!state->error && state->mode == CNF_SCAN_HEADER) {
+        parse_problem_line(state);
+    }
+    if (!state->error && state->num_literals > state->clause_start) {
+        close_clause(state);
+    }
+    if (!state->error && !state->header_seen) {
+        scan_fail(state, "Problem line not found in file");
+    }
+    if (state->error) {
+        free_cnf_scan_state(state);
+        return NULL;
+    }
+    
+    Formula* formula = (Formula*)tracked_malloc(MEMORY_FORMULA, sizeof(Formula));
+    formula->num_vars = state->num_vars;
+    formula->num_clauses = state->num_clauses;
+    formula->clause_capacity = state->num_clauses;
+    formula->clauses = (Clause*)safe_realloc(state->clauses,
+                                             (state->num_clauses > 0 ? state->num_clauses : 1) * sizeof(Clause));
+    formula->var_states = (int*)tracked_malloc(MEMORY_FORMULA, (state->num_vars > 0 ? state->num_vars : 1) * sizeof(int));
+    memset(formula->var_states, 0, (size_t)state->num_vars * sizeof(int));
+    
+    // 文字数已确定，整体复制到公式的文字区，再让子句指向其中的位置
+    arena_init(&formula->literal_arena, MEMORY_FORMULA, FORMULA_ARENA_CHUNK_SIZE, MEMORY_HUGE_PAGES);
+    int* literals = (int*)arena_alloc(&formula->literal_arena,
+                                      (state->num_literals > 0 ? state->num_literals : 1) * sizeof(int));
+    memcpy(literals, state->literals, state->num_literals * sizeof(int));
+    size_t offset = 0;
+    for (int i = 0; i < formula->num_clauses; i++) {
+        formula->clauses[i].literals = literals + offset;
+        offset += (size_t)formula->clauses[i].length;
+    }
+    
+    state->clauses = NULL;
+    free_cnf_scan_state(state);
+    return formula;
+}
+
+// 解析内存中的DIMACS文本
+Formula* parse_cnf_buffer(const char* data, size_t length) {
+    CnfScanState state;
+    init_cnf_scan_state(&state);
+    
+    TRACE_BEGIN("parser", "scan");
+    int ok = scan_cnf_block(&state, data, length);
+    TRACE_END("parser", "scan");
+    if (!ok) {
+        free_cnf_scan_state(&state);
+        return NULL;
+    }
+    
+    TRACE_BEGIN("parser", "build_formula");
+    Formula* formula = finish_cnf_scan(&state);
+    TRACE_END("parser", "build_formula");
+    return formula;
+}
+
+// 跳过行首的空格和制表符
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// 找到正文（问题行之后）的起点：问题行之前只允许空行和注释，否则返回0交给顺序解析
+static size_t find_cnf_body(const char* data, size_t length) {
+    const char* p = data;
+    const char* end = data + length;
+    
+    while (p < end) {
+        const char* line = skip_blanks(p, end);
+        const char* newline = (const char*)memchr(line, '\n', (size_t)(end - line));
+        if (newline == NULL) {
+            return 0;
         }
+        if (line < newline && *line == 'p') {
+            return (size_t)(newline + 1 - data);
+        }
+        if (line < newline && *line != 'c') {
+            return 0;
+        }
+        p = newline + 1;
+    }
+    return 0;
+}
+
+// 从position之后的第一个行首开始，找到第一个子句结束符0，返回紧跟其后一个空白字符之后的位置；
+// 找不到（或先遇到'%'）时返回length
+static size_t find_chunk_boundary(const char* data, size_t length, size_t position) {
+    if (position >= length) {
+        return length;
+    }
+    
+    const char* end = data + length;
+    const char* p = (const char*)memchr(data + position, '\n', length - position);
+    
+    while (p != NULL) {
+        p++;
+        const char* line = skip_blanks(p, end);
+        const char* newline = line < end ? (const char*)memchr(line, '\n', (size_t)(end - line)) : NULL;
+        const char* line_end = newline != NULL ? newline : end;
         
-        // 解析子句
-        Clause* clause = parse_clause_line(line);
-        
-        // 将子句添加到公式中
-        if (formula->num_clauses < num_clauses) {
-            // 深拷贝子句数据
-            Clause* target_clause = &formula->clauses[formula->num_clauses];
-            target_clause->length = clause->length;
-            target_clause->capacity = clause->length; // 使用实际长度作为容量
-            
-            // 分配新的内存并复制文字
-            target_clause->literals = (int*)safe_malloc(clause->length * sizeof(int));
-            
-            // 复制文字数据
-            for (int j = 0; j < clause->length; j++) {
-                target_clause->literals[j] = clause->literals[j];
-            }
-            
-            formula->num_clauses++;
-        } else {
-            // 如果子句数量超出预期，动态扩容
-            int new_num_clauses = formula->num_clauses + 1;
-            formula->clauses = (Clause*)safe_realloc(formula->clauses, new_num_clauses * sizeof(Clause));
-            
-            // 深拷贝子句数据
-            Clause* target_clause = &formula->clauses[formula->num_clauses];
-            target_clause->length = clause->length;
-            target_clause->capacity = clause->length;
-            
-            // 分配新的内存并复制文字
-            target_clause->literals = (int*)safe_malloc(clause->length * sizeof(int));
-            
-            // 复制文字数据
-            for (int j = 0; j < clause->length; j++) {
-                target_clause->literals[j] = clause->literals[j];
+        if (line < line_end && *line == '%') {
+            return length;
+        }
+        if (line < line_end && *line != 'c' && *line != 'p') {
+            // 逐个标记查找单独的"0"
+            const char* token = line;
+            while (token < line_end) {
+                const char* token_end = token;
+                while (token_end < line_end && *token_end != ' ' && *token_end != '\t' && *token_end != '\r') {
+                    token_end++;
+                }
+                if (token_end - token == 1 && *token == '0' && token_end < end) {
+                    return (size_t)(token_end + 1 - data);
+                }
+                token = skip_blanks(token_end, line_end);
             }
-            
-            formula->num_clauses++;
         }
+        p = newline;
+    }
+    return length;
+}
+
+// 一个块的并行扫描任务
+typedef struct {
+    const char* data;
+    size_t begin;
+    size_t end;
+    int last;                   // 是否为最后一块（负责收尾未结束的子句）
+    CnfScanState state;
+    // 合并阶段
+    Formula* formula;
+    int* literals;              // 公式文字区中整块分配的文字数组
+    size_t literal_offset;
+    int clause_offset;
+} CnfChunkTask;
+
+// 扫描一块，最后一块还要像 finish_cnf_scan 一样收尾
+static void* scan_cnf_chunk(void* arg) {
+    CnfChunkTask* task = (CnfChunkTask*)arg;
+    CnfScanState* state = &task->state;
+    
+    trace_set_thread_name("parser worker");
+    TRACE_BEGIN("parser", "scan_chunk");
+    scan_cnf_block(state, task->data + task->begin, task->end - task->begin);
+    if (task->last && !state->error) {
+        if (state->mode == CNF_SCAN_NUMBER) {
+            finish_number(state, state->negative, state->value);
+        }
+        if (!state->error && state->mode == CNF_SCAN_HEADER) {
+            parse_problem_line(state);
+        }
+        if (!state->error && state->num_literals > state->clause_start) {
+            close_clause(state);
+        }
+    }
+    TRACE_END("parser", "scan_chunk");
+    return NULL;
+}
+
+// 把一块的文字与子句复制到合并后的公式中
+static void* merge_cnf_chunk(void* arg) {
+    CnfChunkTask* task = (CnfChunkTask*)arg;
+    Formula* formula = task->formula;
+    int* literals = task->literals + task->literal_offset;
+    
+    trace_set_thread_name("parser worker");
+    TRACE_BEGIN("parser", "merge_chunk");
+    if (task->state.num_literals > 0) {
+        memcpy(literals, task->state.literals, task->state.num_literals * sizeof(int));
+    }
+    for (int i = 0; i < task->state.num_clauses; i++) {
+        Clause* clause = &formula->clauses[task->clause_offset + i];
+        clause->literals = literals;
+        clause->length = task->state.clauses[i].length;
+        clause->capacity = clause->length;
+        literals += clause->length;
+    }
+    free_cnf_scan_state(&task->state);
+    TRACE_END("parser", "merge_chunk");
+    return NULL;
+}
+
+// 并行运行每个任务，线程创建失败时在当前线程中执行
+static void run_chunk_tasks(CnfChunkTask* tasks, int count, void* (*function)(void*)) {
+    pthread_t* threads = (pthread_t*)safe_malloc((size_t)count * sizeof(pthread_t));
+    int* started = (int*)safe_malloc((size_t)count * sizeof(int));
+    
+    for (int i = 0; i < count; i++) {
+        started[i] = (pthread_create(&threads[i], NULL, function, &tasks[i]) == 0);
+        if (!started[i]) {
+            function(&tasks[i]);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    
+    safe_free(started);
+    safe_free(threads);
+}
+
+// 并行解析内存中的DIMACS文本
+Formula* parse_cnf_buffer_parallel(const char* data, size_t length, int num_threads) {
+    if (data == NULL && length > 0) {
+        print_error("parse_cnf_buffer_parallel", COMMON_ERROR_INVALID_PARAMETER, "Data is NULL");
+        return NULL;
+    }
+    if (num_threads <= 0) {
+        num_threads = get_cpu_count();
+    }
+    
+    // 先顺序扫描问题行及其之前的注释
+    size_t body = find_cnf_body(data, length);
+    if (body == 0 || num_threads <= 1 || length - body < 2 * (size_t)CNF_PARALLEL_MIN_CHUNK) {
+        return parse_cnf_buffer(data, length);
+    }
+    CnfScanState header;
+    init_cnf_scan_state(&header);
+    header.silent = 1;
+    if (!scan_cnf_block(&header, data, body) || !header.header_seen) {
+        free_cnf_scan_state(&header);
+        return parse_cnf_buffer(data, length);
+    }
+    
+    // 把正文切成块，切分点在子句结束符之后
+    int max_chunks = (int)((length - body) / CNF_PARALLEL_MIN_CHUNK);
+    int num_chunks = num_threads < max_chunks ? num_threads : max_chunks;
+    CnfChunkTask* tasks = (CnfChunkTask*)safe_malloc((size_t)num_chunks * sizeof(CnfChunkTask));
+    size_t begin = body;
+    int count = 0;
+    for (int i = 0; i < num_chunks && begin < length; i++) {
+        size_t end = length;
+        if (i < num_chunks - 1) {
+            size_t target = body + (length - body) / (size_t)num_chunks * (size_t)(i + 1);
+            end = find_chunk_boundary(data, length, target > begin ? target : begin);
+        }
+        
+        CnfChunkTask* task = &tasks[count++];
+        task->data = data;
+        task->begin = begin;
+        task->end = end;
+        task->last = (end == length);
+        init_cnf_scan_state(&task->state);
+        task->state.silent = 1;
+        task->state.header_seen = 1;
+        task->state.num_vars = header.num_vars;
+        task->state.declared_clauses = header.declared_clauses;
+        task->state.mode = (data[begin - 1] == '\n') ? CNF_SCAN_LINE_START : CNF_SCAN_TOKENS;
         
-        // 释放临时子句
-        free_clause(clause);
+        begin = end;
+    }
+    
+    run_chunk_tasks(tasks, count, scan_cnf_chunk);
+    
+    // 计算各块在合并结果中的位置；遇到'%'的块之后的内容全部忽略
+    size_t total_literals = 0;
+    long long total_clauses = 0;
+    int failed = 0;
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        CnfScanState* state = &tasks[i].state;
+        if (state->error) {
+            failed = 1;
+            break;
+        }
+        tasks[i].literal_offset = total_literals;
+        tasks[i].clause_offset = (int)total_clauses;
+        total_literals += state->num_literals;
+        total_clauses += state->num_clauses;
+        used = i + 1;
+        if (state->mode == CNF_SCAN_END) {
+            break;
+        }
+    }
+    if (total_clauses > INT_MAX) {
+        failed = 1;
+    }
+    
+    // 任何一块出错时改用顺序解析，错误信息（含行号）与顺序解析一致
+    if (failed) {
+        for (int i = 0; i < count; i++) {
+            free_cnf_scan_state(&tasks[i].state);
+        }
+        safe_free(tasks);
+        free_cnf_scan_state(&header);
+        return parse_cnf_buffer(data, length);
+    }
+    
+    Formula* formula = (Formula*)tracked_malloc(MEMORY_FORMULA, sizeof(Formula));
+    formula->num_vars = header.num_vars;
+    formula->num_clauses = (int)total_clauses;
+    formula->clause_capacity = (int)total_clauses;
+    arena_init(&formula->literal_arena, MEMORY_FORMULA, FORMULA_ARENA_CHUNK_SIZE, MEMORY_HUGE_PAGES);
+    int* literals = (int*)arena_alloc(&formula->literal_arena, (total_literals > 0 ? total_literals : 1) * sizeof(int));
+    formula->clauses = (Clause*)tracked_malloc(MEMORY_FORMULA, (total_clauses > 0 ? (size_t)total_clauses : 1) * sizeof(Clause));
+    formula->var_states = (int*)tracked_malloc(MEMORY_FORMULA, (header.num_vars > 0 ? header.num_vars : 1) * sizeof(int));
+    memset(formula->var_states, 0, (size_t)header.num_vars * sizeof(int));
+    
+    for (int i = 0; i < used; i++) {
+        tasks[i].formula = formula;
+        tasks[i].literals = literals;
+    }
+    run_chunk_tasks(tasks, used, merge_cnf_chunk);
+    
+    for (int i = used; i < count; i++) {
+        free_cnf_scan_state(&tasks[i].state);
+    }
+    safe_free(tasks);
+    free_cnf_scan_state(&header);
+    return formula;
+}
+
+// 从输入流逐块解析
+Formula* parse_cnf_input_stream(InputStream* stream) {
+    if (stream == NULL) {
+        print_error("parse_cnf_input_stream", COMMON_ERROR_INVALID_PARAMETER, "Stream is NULL");
+        return NULL;
     }
     
-    fclose(file);
+    char* buffer = (char*)tracked_malloc(MEMORY_PARSER, INPUT_STREAM_BUFFER_SIZE);
+    CnfScanState state;
+    init_cnf_scan_state(&state);
     
-    if (formula == NULL) {
-        parser_error("Problem line not found in file");
+    size_t count;
+    TRACE_BEGIN("parser", "scan_stream");
+    while ((count = read_input_stream(stream, buffer, INPUT_STREAM_BUFFER_SIZE)) > 0) {
+        if (!scan_cnf_block(&state, buffer, count)) {
+            break;
+        }
     }
+    TRACE_END("parser", "scan_stream");
+    safe_free(buffer);
     
+    if (state.error || input_stream_error(stream)) {
+        free_cnf_scan_state(&state);
+        return NULL;
+    }
+    
+    TRACE_BEGIN("parser", "build_formula");
+    Formula* formula = finish_cnf_scan(&state);
+    TRACE_END("parser", "build_formula");
+    return formula;
+}
+
+// 通过输入流解析文件或标准输入
+static Formula* parse_cnf_streamed(const char* filename) {
+    InputStream* stream = open_input_stream(filename);
+    if (stream == NULL) {
+        return NULL;
+    }
+    
+    Formula* formula = parse_cnf_input_stream(stream);
+    close_input_stream(stream);
+    return formula;
+}
+
+// 解析CNF文件的主要函数：普通文件映射后扫描（大文件并行），压缩文件和标准输入流式解析
+Formula* parse_cnf_file(const char* filename) {
+    return parse_cnf_file_parallel(filename, 0);
+}
+
+// 并行解析CNF文件（压缩文件和标准输入只能顺序解压，退回流式解析）
+Formula* parse_cnf_file_parallel(const char* filename, int num_threads) {
+    if (filename == NULL) {
+        print_error("parse_cnf_file", COMMON_ERROR_INVALID_PARAMETER, "Filename is NULL");
+        return NULL;
+    }
+    if (strcmp(filename, "-") == 0) {
+        return parse_cnf_streamed(filename);
+    }
+    
+    // 管道、FIFO、/dev/stdin 等不是普通文件，大小未知，不能映射，按流读取
+    struct stat info;
+    if (stat(filename, &info) == 0 && !S_ISREG(info.st_mode)) {
+        return parse_cnf_streamed(filename);
+    }
+    
+    MappedFile file;
+    if (!map_file_readonly(filename, &file)) {
+        // 文件不存在或无法映射时同样交给流式读取，由它报告打开失败
+        return parse_cnf_streamed(filename);
+    }
+    if (detect_input_compression((const unsigned char*)file.data, file.size) != INPUT_COMPRESSION_NONE) {
+        unmap_file(&file);
+        return parse_cnf_streamed(filename);
+    }
+    
+    Formula* formula;
+    if (file.size < CNF_PARALLEL_MIN_BYTES) {
+        formula = parse_cnf_buffer(file.data, file.size);
+    } else {
+        formula = parse_cnf_buffer_parallel(file.data, file.size, num_threads);
+    }
+    unmap_file(&file);
     return formula;
 }
@@ -3,10 +3,84 @@
 
 #include "../common/common.h"
 #include "../core/core.h"
+#include "input_stream.h"
 
-// 解析CNF文件的主要函数
+// DIMACS CNF 解析
+// 文件以只读方式内存映射，逐字节扫描整数，文字写入连续的缓冲区，结束后整块放入公式的文字区
+// （Formula.literal_arena），不复制行、不按行分配子句。子句以0结束，可以任意长、可以跨行；以'c'开头的行为注释，
+// 以'%'开头的行表示数据结束（SATLIB格式）。
+// 扫描状态可以跨数据块保存：数据可分块交给 scan_cnf_block，数字、注释或问题行被块边界
+// 截断时会在下一块继续，因此同一扫描器也适用于流式输入。
+
+#define CNF_SCAN_HEADER_MAX 128
+
+// 扫描所处的位置
+typedef enum {
+    CNF_SCAN_LINE_START,    // 行首
+    CNF_SCAN_TOKENS,        // 行内，位于数字之间
+    CNF_SCAN_NUMBER,        // 数字中间
+    CNF_SCAN_COMMENT,       // 注释行
+    CNF_SCAN_HEADER,        // 问题行
+    CNF_SCAN_END            // 已遇到'%'，忽略之后的内容
+} CnfScanMode;
+
+// 可恢复的扫描状态
+typedef struct {
+    CnfScanMode mode;
+    int negative;               // 当前数字是否带负号
+    long long value;            // 当前数字的绝对值
+    char header[CNF_SCAN_HEADER_MAX];
+    int header_length;
+    int header_seen;            // 是否已解析问题行
+    int num_vars;               // 问题行声明的变量数
+    int declared_clauses;       // 问题行声明的子句数
+    int max_var;                // 出现过的最大变量编号
+    long long line;             // 当前行号（用于错误信息）
+    int error;                  // 是否出错
+    int silent;                 // 出错时不打印（并行分块扫描出错后改由顺序扫描报告）
+    
+    int* literals;              // 文字区
+    size_t num_literals;
+    size_t literal_capacity;
+    Clause* clauses;            // 子句（literals 在扫描结束时才指向文字区）
+    int num_clauses;
+    int clause_capacity;
+    size_t clause_start;        // 当前子句第一个文字在文字区中的位置
+} CnfScanState;
+
+// 并行解析
+// 问题行之后的正文按大小切成若干块，切分点总是落在某个子句结束符0之后（从行首开始判断，
+// 不会落在注释行里），各线程用独立的扫描状态把各自的块解析到自己的文字区，最后按块的
+// 顺序合并为一个公式。结果与顺序解析完全相同；任何一块出错时改用顺序解析，以得到相同的
+// 错误信息。文件不小于 CNF_PARALLEL_MIN_BYTES 时 parse_cnf_file 自动使用并行解析。
+
+#define CNF_PARALLEL_MIN_BYTES (8 * 1024 * 1024)
+#define CNF_PARALLEL_MIN_CHUNK (1024 * 1024)
+
+// 压缩输入与标准输入
+// parse_cnf_file 按魔数识别 gzip/xz/bzip2 压缩的文件，路径为 "-" 时读取标准输入，
+// 这两种情况通过输入流（见 input_stream.h）分块解压并交给同一个可恢复的扫描器；
+// 未压缩的普通文件仍走内存映射（及并行）解析。
+
+// 解析CNF文件的主要函数（出错时返回NULL）
 Formula* parse_cnf_file(const char* filename);
 
+// 从输入流逐块解析
+Formula* parse_cnf_input_stream(InputStream* stream);
+
+// 解析内存中的DIMACS文本
+Formula* parse_cnf_buffer(const char* data, size_t length);
+
+// 并行解析，num_threads <= 0 表示使用CPU核心数
+Formula* parse_cnf_file_parallel(const char* filename, int num_threads);
+Formula* parse_cnf_buffer_parallel(const char* data, size_t length, int num_threads);
+
+// 分块扫描：scan_cnf_block 出错返回0；finish_cnf_scan 把结果转为公式并清空状态
+void init_cnf_scan_state(CnfScanState* state);
+int scan_cnf_block(CnfScanState* state, const char* data, size_t length);
+Formula* finish_cnf_scan(CnfScanState* state);
+void free_cnf_scan_state(CnfScanState* state);
+
 // 解析单行子句的辅助函数
 Clause* parse_clause_line(const char* line);
 
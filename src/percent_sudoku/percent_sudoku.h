@@ -7,12 +7,42 @@
 // 包含核心模块
 #include "percent_sudoku_core.h"
 
+// 包含位掩码求解器模块
+#include "percent_sudoku_bitmask.h"
+
+// 包含Dancing Links精确覆盖求解器模块
+#include "percent_sudoku_dlx.h"
+
+// 包含位切片批量求解器模块
+#include "percent_sudoku_simd.h"
+
+// 包含单行格式批量读写模块
+#include "percent_sudoku_io.h"
+
+// 包含二进制谜题库模块
+#include "percent_sudoku_db.h"
+
+// 包含对称变换模块
+#include "percent_sudoku_transform.h"
+
 // 包含CNF转换模块
 #include "percent_sudoku_cnf.h"
 
 // 包含求解器模块
 #include "percent_sudoku_solver.h"
 
+// 包含已解谜题缓存模块
+#include "percent_sudoku_cache.h"
+
+// 包含多线程批量求解模块
+#include "percent_sudoku_batch.h"
+
+// 包含多线程谜题生成模块
+#include "percent_sudoku_generator.h"
+
+// 包含基准测试模块
+#include "percent_sudoku_benchmark.h"
+
 // 这个文件现在只作为统一接口，具体的功能实现分别在各子模块中
 // 保持了向后兼容性，同时提供了清晰的模块结构
 
@@ -0,0 +1,431 @@
+#include "percent_sudoku_batch.h"
+#include "../trace/trace.h"
+#include <pthread.h>
+#include <sys/stat.h>
+
+// 队列中的求解任务
+typedef struct {
+    int index;                    // 输入顺序
+    int source;                   // 输入中的位置（行号或文件序号，从1开始）
+    int valid;                    // 输入是否解析成功
+    PercentSudokuGrid puzzle;
+} BatchJob;
+
+// 重排窗口中的结果
+typedef struct {
+    int ready;
+    BatchJob job;
+    PercentSudokuResult result;
+    PercentSudokuGrid solution;
+    double latency_ms;
+    int cache_hit;
+} BatchSlot;
+
+// 流水线共享状态（所有字段由mutex保护）
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t queue_not_empty;
+    pthread_cond_t queue_not_full;
+    pthread_cond_t slot_ready;
+    pthread_cond_t slot_free;
+    
+    BatchJob* queue;              // 环形输入队列
+    int queue_capacity;
+    int queue_head;
+    int queue_count;
+    
+    BatchSlot* slots;             // 重排窗口，任务i放在 slots[i % window]
+    int window;
+    int next_to_write;
+    
+    int num_read;                 // 已放入队列的任务数
+    int input_done;               // 读取阶段是否结束
+    
+    const BatchOptions* options;
+    PuzzleLineWriter* output;
+    BatchReport* report;
+    double* latencies;            // 按输入顺序记录的延迟
+    int latency_capacity;
+} BatchPipeline;
+
+// 读取阶段：放入一个任务，队列满时等待
+static void enqueue_job(BatchPipeline* pipeline, const BatchJob* job) {
+    pthread_mutex_lock(&pipeline->mutex);
+    while (pipeline->queue_count == pipeline->queue_capacity) {
+        pthread_cond_wait(&pipeline->queue_not_full, &pipeline->mutex);
+    }
+    
+    int tail = (pipeline->queue_head + pipeline->queue_count) % pipeline->queue_capacity;
+    pipeline->queue[tail] = *job;
+    pipeline->queue[tail].index = pipeline->num_read++;
+    pipeline->queue_count++;
+    
+    pthread_cond_signal(&pipeline->queue_not_empty);
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+// 求解一组任务：先逐个查缓存，未命中的有效谜题一起交给引擎（位切片引擎按通道同步求解），
+// 延迟按组内谜题分摊
+static void solve_batch_group(BatchPipeline* pipeline, BatchSlot* results, int count) {
+    const BatchOptions* options = pipeline->options;
+    PercentSudokuGrid puzzles[SIMD_BATCH_LANES];
+    PercentSudokuGrid solutions[SIMD_BATCH_LANES];
+    PercentSudokuResult statuses[SIMD_BATCH_LANES];
+    CanonicalPuzzle canonical[SIMD_BATCH_LANES];
+    int pending[SIMD_BATCH_LANES];
+    int num_pending = 0;
+    
+    double start_time = get_monotonic_time_ms();
+    TRACE_BEGIN("batch", "solve_puzzle");
+    for (int i = 0; i < count; i++) {
+        BatchSlot* result = &results[i];
+        result->cache_hit = 0;
+        if (!result->job.valid) {
+            result->result = PERCENT_SUDOKU_ERROR;
+            continue;
+        }
+        if (options->cache != NULL) {
+            canonicalize_percent_sudoku(&result->job.puzzle, &canonical[num_pending]);
+            if (lookup_puzzle_cache(options->cache, &canonical[num_pending], &result->solution)) {
+                result->result = PERCENT_SUDOKU_SOLVED;
+                result->cache_hit = 1;
+                continue;
+            }
+        }
+        copy_percent_sudoku_grid(&result->job.puzzle, &puzzles[num_pending]);
+        pending[num_pending++] = i;
+    }
+    
+    if (num_pending > 0) {
+        solve_percent_sudoku_group(options->engine, puzzles, num_pending, solutions, statuses,
+                                   options->timeout_seconds);
+    }
+    for (int k = 0; k < num_pending; k++) {
+        BatchSlot* result = &results[pending[k]];
+        result->result = statuses[k];
+        copy_percent_sudoku_grid(&solutions[k], &result->solution);
+        if (options->cache != NULL && statuses[k] == PERCENT_SUDOKU_SOLVED) {
+            insert_puzzle_cache(options->cache, &canonical[k], &solutions[k]);
+        }
+    }
+    TRACE_END("batch", "solve_puzzle");
+    
+    double latency_ms = (get_monotonic_time_ms() - start_time) / count;
+    for (int i = 0; i < count; i++) {
+        results[i].latency_ms = latency_ms;
+        results[i].ready = 1;
+    }
+}
+
+// 工作线程：取任务、求解、把结果放入重排窗口
+// 位切片引擎一次取出最多一个通道宽度的任务（队列中已有的），其余引擎一次一个
+static void* batch_worker(void* arg) {
+    BatchPipeline* pipeline = (BatchPipeline*)arg;
+    BatchSlot results[SIMD_BATCH_LANES];
+    int max_group = pipeline->options->engine == PERCENT_SUDOKU_ENGINE_SIMD ? SIMD_BATCH_LANES : 1;
+    
+    set_solver_verbose(0);
+    trace_set_thread_name("batch worker");
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    while (1) {
+        while (pipeline->queue_count == 0 && !pipeline->input_done) {
+            pthread_cond_wait(&pipeline->queue_not_empty, &pipeline->mutex);
+        }
+        if (pipeline->queue_count == 0) {
+            break;  // 输入结束且队列已空
+        }
+        
+        int count = 0;
+        while (count < max_group && pipeline->queue_count > 0) {
+            results[count++].job = pipeline->queue[pipeline->queue_head];
+            pipeline->queue_head = (pipeline->queue_head + 1) % pipeline->queue_capacity;
+            pipeline->queue_count--;
+        }
+        pthread_cond_signal(&pipeline->queue_not_full);
+        pthread_mutex_unlock(&pipeline->mutex);
+        
+        solve_batch_group(pipeline, results, count);
+        
+        // 组内任务按输入顺序放入窗口；序号最小的未写出任务总能放入，因此不会互相等死
+        pthread_mutex_lock(&pipeline->mutex);
+        for (int i = 0; i < count; i++) {
+            while (results[i].job.index >= pipeline->next_to_write + pipeline->window) {
+                pthread_cond_wait(&pipeline->slot_free, &pipeline->mutex);
+            }
+            pipeline->slots[results[i].job.index % pipeline->window] = results[i];
+            if (results[i].job.index == pipeline->next_to_write) {
+                pthread_cond_signal(&pipeline->slot_ready);
+            }
+        }
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    free_shared_dlx_solver();
+    return NULL;
+}
+
+// 写出一个结果并计入报告（只由写出线程调用）
+static void write_batch_result(BatchPipeline* pipeline, const BatchSlot* slot) {
+    BatchReport* report = pipeline->report;
+    
+    switch (slot->result) {
+        case PERCENT_SUDOKU_SOLVED: report->solved++; break;
+        case PERCENT_SUDOKU_UNSOLVABLE: report->unsolvable++; break;
+        case PERCENT_SUDOKU_TIMEOUT: report->timeouts++; break;
+        default: report->errors++; break;
+    }
+    report->cache_hits += slot->cache_hit;
+    
+    if (slot->job.valid) {
+        if (report->latency.count == pipeline->latency_capacity) {
+            pipeline->latency_capacity = pipeline->latency_capacity > 0 ? pipeline->latency_capacity * 2 : 1024;
+            pipeline->latencies = (double*)tracked_realloc(MEMORY_SUDOKU, pipeline->latencies,
+                                                           pipeline->latency_capacity * sizeof(double));
+        }
+        pipeline->latencies[report->latency.count++] = slot->latency_ms;
+    }
+    
+    if (pipeline->output == NULL) {
+        return;
+    }
+    
+    if (!slot->job.valid) {
+        char comment[64];
+        snprintf(comment, sizeof(comment), "input %d: invalid puzzle", slot->job.source);
+        write_puzzle_comment(pipeline->output, comment);
+        return;
+    }
+    
+    write_puzzle_line(pipeline->output, &slot->job.puzzle,
+                      slot->result == PERCENT_SUDOKU_SOLVED ? &slot->solution : NULL);
+}
+
+// 写出线程：按输入顺序依次取出结果
+static void* batch_writer(void* arg) {
+    BatchPipeline* pipeline = (BatchPipeline*)arg;
+    BatchSlot slot;
+    
+    trace_set_thread_name("batch writer");
+    pthread_mutex_lock(&pipeline->mutex);
+    while (1) {
+        BatchSlot* next = &pipeline->slots[pipeline->next_to_write % pipeline->window];
+        while (!next->ready && !(pipeline->input_done && pipeline->next_to_write == pipeline->num_read)) {
+            pthread_cond_wait(&pipeline->slot_ready, &pipeline->mutex);
+        }
+        if (!next->ready) {
+            break;  // 所有结果都已写出
+        }
+        
+        slot = *next;
+        next->ready = 0;
+        pipeline->next_to_write++;
+        pthread_cond_broadcast(&pipeline->slot_free);
+        pthread_mutex_unlock(&pipeline->mutex);
+        
+        TRACE_BEGIN("batch", "write_result");
+        write_batch_result(pipeline, &slot);
+        TRACE_END("batch", "write_result");
+        
+        pthread_mutex_lock(&pipeline->mutex);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return NULL;
+}
+
+// 读取目录中的 .percent_sudoku 文件（按文件名排序），返回读取的谜题数，失败返回-1
+static int read_puzzle_directory(BatchPipeline* pipeline, const char* dir_path) {
+    char** paths = NULL;
+    int num_files = list_percent_sudoku_files(dir_path, &paths);
+    if (num_files < 0) {
+        return -1;
+    }
+    
+    BatchJob job;
+    for (int i = 0; i < num_files; i++) {
+        memset(&job, 0, sizeof(BatchJob));
+        job.source = i + 1;
+        
+        PercentSudokuGame* game = load_percent_sudoku_from_file(paths[i]);
+        if (game != NULL) {
+            copy_percent_sudoku_grid(&game->puzzle, &job.puzzle);
+            job.valid = 1;
+            free_percent_sudoku_game(game);
+        }
+        
+        enqueue_job(pipeline, &job);
+    }
+    
+    free_file_list(paths, num_files);
+    return num_files;
+}
+
+// 读取每行一个谜题的文件（内存映射），返回读取的谜题数，失败返回-1
+static int read_puzzle_lines(BatchPipeline* pipeline, const char* file_path) {
+    PuzzleLineReader reader;
+    if (!open_puzzle_reader(&reader, file_path)) {
+        return -1;
+    }
+    
+    BatchJob job;
+    int count = 0;
+    int status;
+    
+    while ((status = read_next_puzzle(&reader, &job.puzzle, NULL, NULL)) != PUZZLE_READ_END) {
+        job.source = reader.line_number;
+        job.valid = (status == PUZZLE_READ_OK);
+        enqueue_job(pipeline, &job);
+        count++;
+    }
+    
+    close_puzzle_reader(&reader);
+    return count;
+}
+
+// 初始化批量求解选项
+void init_batch_options(BatchOptions* options) {
+    if (options == NULL) {
+        return;
+    }
+    
+    options->engine = PERCENT_SUDOKU_ENGINE_BITMASK;
+    options->num_threads = 0;
+    options->queue_capacity = BATCH_DEFAULT_QUEUE_CAPACITY;
+    options->timeout_seconds = 60.0;
+    options->cache = NULL;
+}
+
+// 运行批量求解流水线，output_path为NULL时只统计不写出，失败返回0
+int run_percent_sudoku_batch(const char* input_path, const char* output_path,
+                             const BatchOptions* options, BatchReport* report) {
+    if (!is_valid_file_path(input_path) || options == NULL || report == NULL) {
+        print_error("run_percent_sudoku_batch", COMMON_ERROR_INVALID_PARAMETER, "Invalid parameters");
+        return 0;
+    }
+    
+    struct stat input_stat;
+    if (stat(input_path, &input_stat) != 0) {
+        print_error("run_percent_sudoku_batch", COMMON_ERROR_FILE_NOT_FOUND, "Input path does not exist");
+        return 0;
+    }
+    
+    memset(report, 0, sizeof(BatchReport));
+    report->num_threads = options->num_threads > 0 ? options->num_threads : get_cpu_count();
+    
+    BatchPipeline pipeline;
+    memset(&pipeline, 0, sizeof(BatchPipeline));
+    pipeline.options = options;
+    pipeline.report = report;
+    pipeline.queue_capacity = options->queue_capacity > 0 ? options->queue_capacity : BATCH_DEFAULT_QUEUE_CAPACITY;
+    pipeline.window = pipeline.queue_capacity + 2 * report->num_threads;
+    
+    if (output_path != NULL) {
+        pipeline.output = open_puzzle_writer(output_path);
+        if (pipeline.output == NULL) {
+            return 0;
+        }
+    }
+    
+    pipeline.queue = (BatchJob*)tracked_malloc(MEMORY_SUDOKU, pipeline.queue_capacity * sizeof(BatchJob));
+    pipeline.slots = (BatchSlot*)tracked_malloc(MEMORY_SUDOKU, pipeline.window * sizeof(BatchSlot));
+    for (int i = 0; i < pipeline.window; i++) {
+        pipeline.slots[i].ready = 0;
+    }
+    
+    pthread_mutex_init(&pipeline.mutex, NULL);
+    pthread_cond_init(&pipeline.queue_not_empty, NULL);
+    pthread_cond_init(&pipeline.queue_not_full, NULL);
+    pthread_cond_init(&pipeline.slot_ready, NULL);
+    pthread_cond_init(&pipeline.slot_free, NULL);
+    
+    double start_time = get_monotonic_time_ms();
+    
+    // 启动写出线程与工作线程；部分工作线程创建失败时以实际启动的数量运行，
+    // 写出线程或全部工作线程都无法创建时流水线无法推进，报错结束
+    pthread_t writer;
+    pthread_t* workers = (pthread_t*)tracked_malloc(MEMORY_SUDOKU, report->num_threads * sizeof(pthread_t));
+    int writer_started = pthread_create(&writer, NULL, batch_writer, &pipeline) == 0;
+    int num_started = 0;
+    if (writer_started) {
+        for (int i = 0; i < report->num_threads; i++) {
+            if (pthread_create(&workers[num_started], NULL, batch_worker, &pipeline) == 0) {
+                num_started++;
+            }
+        }
+    }
+    
+    // 读取阶段在调用线程中运行
+    int num_read = -1;
+    if (writer_started && num_started > 0) {
+        report->num_threads = num_started;
+        if (S_ISDIR(input_stat.st_mode)) {
+            num_read = read_puzzle_directory(&pipeline, input_path);
+        } else {
+            num_read = read_puzzle_lines(&pipeline, input_path);
+        }
+    } else {
+        print_error("run_percent_sudoku_batch", COMMON_ERROR_UNKNOWN, "Cannot create pipeline threads");
+    }
+    
+    pthread_mutex_lock(&pipeline.mutex);
+    pipeline.input_done = 1;
+    pthread_cond_broadcast(&pipeline.queue_not_empty);
+    pthread_cond_broadcast(&pipeline.slot_ready);
+    pthread_mutex_unlock(&pipeline.mutex);
+    
+    for (int i = 0; i < num_started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    if (writer_started) {
+        pthread_join(writer, NULL);
+    }
+    
+    report->wall_time_ms = get_monotonic_time_ms() - start_time;
+    report->num_puzzles = pipeline.num_read;
+    if (report->wall_time_ms > 0.0) {
+        report->puzzles_per_second = report->num_puzzles * 1000.0 / report->wall_time_ms;
+    }
+    summarize_latencies(pipeline.latencies, report->latency.count, &report->latency);
+    
+    // 清理（结果写出失败时整个批次视为失败）
+    int output_ok = pipeline.output == NULL || close_puzzle_writer(pipeline.output);
+    pthread_mutex_destroy(&pipeline.mutex);
+    pthread_cond_destroy(&pipeline.queue_not_empty);
+    pthread_cond_destroy(&pipeline.queue_not_full);
+    pthread_cond_destroy(&pipeline.slot_ready);
+    pthread_cond_destroy(&pipeline.slot_free);
+    safe_free(workers);
+    safe_free(pipeline.queue);
+    safe_free(pipeline.slots);
+    safe_free(pipeline.latencies);
+    
+    return num_read >= 0 && output_ok;
+}
+
+// 打印批量求解报告
+void print_batch_report(const BatchReport* report, const BatchOptions* options) {
+    if (report == NULL) {
+        return;
+    }
+    
+    printf("=== Batch Solving Report ===\n");
+    if (options != NULL) {
+        printf("Engine: %s\n", percent_sudoku_engine_name(options->engine));
+    }
+    printf("Worker threads: %d\n", report->num_threads);
+    printf("Puzzles: %d (solved %d, unsolvable %d, timeout %d, error %d)\n",
+           report->num_puzzles, report->solved, report->unsolvable, report->timeouts, report->errors);
+    printf("Wall time: %.2f ms\n", report->wall_time_ms);
+    printf("Throughput: %.1f puzzles/sec\n", report->puzzles_per_second);
+    printf("Latency (ms): mean %.3f, p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n",
+           report->latency.mean, report->latency.p50, report->latency.p90,
+           report->latency.p99, report->latency.max);
+    if (options != NULL && options->cache != NULL) {
+        PuzzleCacheStats cache_stats;
+        get_puzzle_cache_stats(options->cache, &cache_stats);
+        printf("Cache hits in this batch: %d\n", report->cache_hits);
+        print_puzzle_cache_stats(&cache_stats);
+    }
+    printf("============================\n");
+}
@@ -0,0 +1,52 @@
+#ifndef PERCENT_SUDOKU_BATCH_H
+#define PERCENT_SUDOKU_BATCH_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+#include "percent_sudoku_solver.h"
+#include "percent_sudoku_io.h"
+#include "percent_sudoku_cache.h"
+
+// 多线程批量求解流水线
+// 读取阶段（调用线程）把谜题依次放入有界队列，工作线程池从队列取出并求解，
+// 写出阶段按输入顺序输出结果。结果暂存在大小固定的重排窗口中，
+// 领先写出进度过多的工作线程会等待，因此内存占用与输入规模无关。
+//
+// 输入：包含 .percent_sudoku 文件的目录（按文件名排序），
+//       或单行格式的谜题文件（见 percent_sudoku_io.h，解答字段被忽略）。
+// 输出：单行格式，有解时在谜题后附上解答。
+// 指定已解谜题缓存时，工作线程先按规范形式查缓存，重复或等价的谜题不再求解。
+
+#define BATCH_DEFAULT_QUEUE_CAPACITY 256
+
+// 批量求解选项
+typedef struct {
+    PercentSudokuEngine engine;   // 求解引擎
+    int num_threads;              // 工作线程数，<=0 表示使用CPU核心数
+    int queue_capacity;           // 输入队列容量
+    double timeout_seconds;       // 单个谜题的超时时间
+    PuzzleCache* cache;           // 已解谜题缓存，NULL表示不使用
+} BatchOptions;
+
+// 批量求解报告
+typedef struct {
+    int num_puzzles;              // 读取的谜题数量
+    int solved;                   // 有解
+    int unsolvable;               // 无解
+    int timeouts;                 // 超时
+    int errors;                   // 输入格式错误等
+    int cache_hits;               // 由缓存直接得到解答的谜题数
+    int num_threads;              // 实际使用的工作线程数
+    double wall_time_ms;          // 总墙钟时间
+    double puzzles_per_second;    // 吞吐量
+    LatencySummary latency;       // 单个谜题的求解延迟
+} BatchReport;
+
+// 函数声明
+
+void init_batch_options(BatchOptions* options);
+int run_percent_sudoku_batch(const char* input_path, const char* output_path,
+                             const BatchOptions* options, BatchReport* report);
+void print_batch_report(const BatchReport* report, const BatchOptions* options);
+
+#endif // PERCENT_SUDOKU_BATCH_H
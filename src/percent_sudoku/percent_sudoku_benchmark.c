@@ -0,0 +1,293 @@
+#include "percent_sudoku_benchmark.h"
+#include "percent_sudoku_io.h"
+
+// 初始化基准测试选项
+void init_benchmark_options(BenchmarkOptions* options) {
+    if (options == NULL) {
+        return;
+    }
+    
+    options->num_puzzles = 20;
+    options->difficulty = 0;
+    options->warmup_runs = BENCHMARK_DEFAULT_WARMUP;
+    options->seed = BENCHMARK_DEFAULT_SEED;
+    options->timeout_seconds = 60.0;
+    options->engine_mask = BENCHMARK_ALL_ENGINES;
+    options->corpus_file = NULL;
+    options->csv_file = NULL;
+    options->json_file = NULL;
+}
+
+// 解析逗号分隔的引擎列表（如 "bitmask,dlx"），成功返回1
+int parse_engine_list(const char* list, int* engine_mask) {
+    if (list == NULL || engine_mask == NULL) {
+        return 0;
+    }
+    
+    char name[32];
+    int mask = 0;
+    
+    while (*list != '\0') {
+        size_t length = strcspn(list, ",");
+        if (length == 0 || length >= sizeof(name)) {
+            return 0;
+        }
+        memcpy(name, list, length);
+        name[length] = '\0';
+        
+        PercentSudokuEngine engine;
+        if (!parse_percent_sudoku_engine(name, &engine)) {
+            return 0;
+        }
+        mask |= 1 << engine;
+        
+        list += length;
+        if (*list == ',') {
+            list++;
+        }
+    }
+    
+    *engine_mask = mask;
+    return mask != 0;
+}
+
+// 用固定种子生成一个难度的谜题集，相同种子总是得到相同的谜题
+int generate_benchmark_corpus(int difficulty, int count, unsigned int seed, PercentSudokuGrid* puzzles) {
+    if (puzzles == NULL || count <= 0) {
+        return 0;
+    }
+    
+    Rng rng;
+    rng_seed(&rng, derive_seed(seed, (uint64_t)difficulty));
+    for (int i = 0; i < count; i++) {
+        PercentSudokuGame* game = generate_percent_sudoku_puzzle_with_rng(difficulty, &rng);
+        if (game == NULL) {
+            return 0;
+        }
+        copy_percent_sudoku_grid(&game->puzzle, &puzzles[i]);
+        free_percent_sudoku_game(game);
+    }
+    
+    return 1;
+}
+
+// 从单行格式文件加载谜题集，返回谜题数量（失败返回0）
+int load_benchmark_corpus(const char* filename, PercentSudokuGrid** puzzles) {
+    if (filename == NULL || puzzles == NULL) {
+        return 0;
+    }
+    
+    PuzzleLineReader reader;
+    if (!open_puzzle_reader(&reader, filename)) {
+        return 0;
+    }
+    
+    int count = 0, capacity = 0;
+    int status;
+    *puzzles = NULL;
+    
+    do {
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 256;
+            *puzzles = (PercentSudokuGrid*)tracked_realloc(MEMORY_SUDOKU, *puzzles, capacity * sizeof(PercentSudokuGrid));
+        }
+        status = read_next_puzzle(&reader, &(*puzzles)[count], NULL, NULL);
+        if (status == PUZZLE_READ_OK) {
+            count++;
+        }
+    } while (status != PUZZLE_READ_END);
+    
+    close_puzzle_reader(&reader);
+    if (count == 0) {
+        safe_free(*puzzles);
+        *puzzles = NULL;
+    }
+    return count;
+}
+
+// 对一个谜题集测试一个引擎
+static void benchmark_engine(const PercentSudokuGrid* puzzles, int count, PercentSudokuEngine engine,
+                             const BenchmarkOptions* options, BenchmarkResult* result) {
+    PercentSudokuGrid solution;
+    double* latencies = (double*)tracked_malloc(MEMORY_SUDOKU, count * sizeof(double));
+    
+    memset(result, 0, sizeof(BenchmarkResult));
+    result->engine = engine;
+    result->num_puzzles = count;
+    
+    // 预热：填充缓存并构建引擎内部的共享结构（如DLX矩阵）
+    for (int i = 0; i < options->warmup_runs; i++) {
+        solve_percent_sudoku_with_engine(engine, &puzzles[i % count], &solution, options->timeout_seconds);
+    }
+    
+    // 位切片引擎按通道宽度成组求解，组内每个谜题的延迟取分摊值；其余引擎逐题计时
+    int group = engine == PERCENT_SUDOKU_ENGINE_SIMD ? SIMD_BATCH_LANES : 1;
+    PercentSudokuGrid solutions[SIMD_BATCH_LANES];
+    PercentSudokuResult statuses[SIMD_BATCH_LANES];
+    for (int base = 0; base < count; base += group) {
+        int lanes = (count - base < group) ? count - base : group;
+        double start_time = get_monotonic_time_ms();
+        solve_percent_sudoku_group(engine, &puzzles[base], lanes, solutions, statuses, options->timeout_seconds);
+        double elapsed_ms = get_monotonic_time_ms() - start_time;
+        result->total_time_ms += elapsed_ms;
+        
+        for (int lane = 0; lane < lanes; lane++) {
+            latencies[base + lane] = elapsed_ms / lanes;
+            if (statuses[lane] == PERCENT_SUDOKU_SOLVED &&
+                verify_solution_correctness(&puzzles[base + lane], &solutions[lane])) {
+                result->solved++;
+            } else {
+                result->failed++;
+            }
+        }
+    }
+    
+    if (result->total_time_ms > 0.0) {
+        result->puzzles_per_second = count * 1000.0 / result->total_time_ms;
+    }
+    summarize_latencies(latencies, count, &result->latency);
+    safe_free(latencies);
+}
+
+// 打印一行结果
+static void print_benchmark_result(const BenchmarkResult* result) {
+    printf("%-6d %-10s %6d/%-6d %10.3f %10.3f %10.3f %10.3f %10.3f %12.1f\n",
+           result->difficulty, percent_sudoku_engine_name(result->engine),
+           result->solved, result->num_puzzles,
+           result->latency.mean, result->latency.p50, result->latency.p90,
+           result->latency.p99, result->latency.max, result->puzzles_per_second);
+}
+
+// 输出CSV
+static void write_benchmark_csv(const char* filename, const BenchmarkResult* results, int num_results,
+                                const BenchmarkOptions* options) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        print_error("write_benchmark_csv", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open CSV file for writing");
+        return;
+    }
+    
+    fprintf(file, "seed,difficulty,engine,puzzles,solved,failed,mean_ms,p50_ms,p90_ms,p99_ms,max_ms,puzzles_per_sec\n");
+    for (int i = 0; i < num_results; i++) {
+        const BenchmarkResult* r = &results[i];
+        fprintf(file, "%u,%d,%s,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.2f\n",
+                options->seed, r->difficulty, percent_sudoku_engine_name(r->engine),
+                r->num_puzzles, r->solved, r->failed,
+                r->latency.mean, r->latency.p50, r->latency.p90, r->latency.p99, r->latency.max,
+                r->puzzles_per_second);
+    }
+    
+    fclose(file);
+    printf("CSV results saved to: %s\n", filename);
+}
+
+// 输出JSON
+static void write_benchmark_json(const char* filename, const BenchmarkResult* results, int num_results,
+                                 const BenchmarkOptions* options) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        print_error("write_benchmark_json", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open JSON file for writing");
+        return;
+    }
+    
+    fprintf(file, "{\n");
+    fprintf(file, "  \"seed\": %u,\n", options->seed);
+    fprintf(file, "  \"warmup_runs\": %d,\n", options->warmup_runs);
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < num_results; i++) {
+        const BenchmarkResult* r = &results[i];
+        fprintf(file, "    {\"difficulty\": %d, \"engine\": \"%s\", \"puzzles\": %d, \"solved\": %d, \"failed\": %d, "
+                "\"mean_ms\": %.6f, \"p50_ms\": %.6f, \"p90_ms\": %.6f, \"p99_ms\": %.6f, \"max_ms\": %.6f, "
+                "\"puzzles_per_sec\": %.2f}%s\n",
+                r->difficulty, percent_sudoku_engine_name(r->engine), r->num_puzzles, r->solved, r->failed,
+                r->latency.mean, r->latency.p50, r->latency.p90, r->latency.p99, r->latency.max,
+                r->puzzles_per_second, (i + 1 < num_results) ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+    
+    fclose(file);
+    printf("JSON results saved to: %s\n", filename);
+}
+
+// 运行基准测试，成功返回1
+int run_percent_sudoku_benchmark(const BenchmarkOptions* options) {
+    if (options == NULL || options->num_puzzles <= 0 || options->difficulty < 0 || options->difficulty > 5) {
+        print_error("run_percent_sudoku_benchmark", COMMON_ERROR_INVALID_PARAMETER, "Invalid benchmark options");
+        return 0;
+    }
+    
+    // 谜题集：指定文件时只有一组，否则每个难度一组
+    int first_difficulty = options->difficulty > 0 ? options->difficulty : 1;
+    int last_difficulty = options->difficulty > 0 ? options->difficulty : 5;
+    if (options->corpus_file != NULL) {
+        first_difficulty = last_difficulty = 0;
+    }
+    
+    int max_results = (last_difficulty - first_difficulty + 1) * PERCENT_SUDOKU_ENGINE_COUNT;
+    BenchmarkResult* results = (BenchmarkResult*)tracked_malloc(MEMORY_SUDOKU, max_results * sizeof(BenchmarkResult));
+    int num_results = 0;
+    
+    // 求解过程的逐节点输出会淹没计时，测试期间关闭
+    int saved_verbose = get_solver_verbose();
+    set_solver_verbose(0);
+    
+    printf("\n=== Percent Sudoku Solver Benchmark ===\n");
+    if (options->corpus_file != NULL) {
+        printf("Corpus: %s\n", options->corpus_file);
+    } else {
+        printf("Seed: %u, Puzzles per difficulty: %d\n", options->seed, options->num_puzzles);
+    }
+    printf("Warm-up runs: %d\n", options->warmup_runs);
+    printf("%-6s %-10s %-13s %10s %10s %10s %10s %10s %12s\n",
+           "Diff", "Engine", "Solved", "Mean(ms)", "p50(ms)", "p90(ms)", "p99(ms)", "Max(ms)", "Puzzles/s");
+    
+    for (int difficulty = first_difficulty; difficulty <= last_difficulty; difficulty++) {
+        PercentSudokuGrid* puzzles = NULL;
+        int count;
+        
+        if (options->corpus_file != NULL) {
+            count = load_benchmark_corpus(options->corpus_file, &puzzles);
+            if (count > options->num_puzzles) {
+                count = options->num_puzzles;
+            }
+        } else {
+            count = options->num_puzzles;
+            puzzles = (PercentSudokuGrid*)tracked_malloc(MEMORY_SUDOKU, count * sizeof(PercentSudokuGrid));
+            if (!generate_benchmark_corpus(difficulty, count, options->seed, puzzles)) {
+                count = 0;
+            }
+        }
+        
+        if (count <= 0) {
+            safe_free(puzzles);
+            continue;
+        }
+        
+        for (int engine = 0; engine < PERCENT_SUDOKU_ENGINE_COUNT; engine++) {
+            if (!(options->engine_mask & (1 << engine))) {
+                continue;
+            }
+            
+            BenchmarkResult* result = &results[num_results++];
+            benchmark_engine(puzzles, count, (PercentSudokuEngine)engine, options, result);
+            result->difficulty = difficulty;
+            print_benchmark_result(result);
+        }
+        
+        safe_free(puzzles);
+    }
+    
+    set_solver_verbose(saved_verbose);
+    printf("=======================================\n");
+    
+    if (options->csv_file != NULL) {
+        write_benchmark_csv(options->csv_file, results, num_results, options);
+    }
+    if (options->json_file != NULL) {
+        write_benchmark_json(options->json_file, results, num_results, options);
+    }
+    
+    safe_free(results);
+    return 1;
+}
@@ -0,0 +1,50 @@
+#ifndef PERCENT_SUDOKU_BENCHMARK_H
+#define PERCENT_SUDOKU_BENCHMARK_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+#include "percent_sudoku_solver.h"
+
+// 求解引擎基准测试
+// 每个难度用固定种子生成（或从单行格式文件加载）同一批谜题，
+// 各引擎先做若干次预热，再用单调时钟逐题计时，
+// 报告 p50/p90/p99/max 延迟与吞吐量，可同时输出 CSV 与 JSON 以便长期跟踪。
+
+#define BENCHMARK_DEFAULT_SEED 20240601u
+#define BENCHMARK_DEFAULT_WARMUP 3
+#define BENCHMARK_ALL_ENGINES ((1 << PERCENT_SUDOKU_ENGINE_COUNT) - 1)
+
+// 基准测试选项
+typedef struct {
+    int num_puzzles;              // 每个难度的谜题数量
+    int difficulty;               // 难度 1-5，0 表示全部难度
+    int warmup_runs;              // 每个引擎的预热次数
+    unsigned int seed;            // 谜题生成种子
+    double timeout_seconds;       // 单个谜题的超时时间
+    int engine_mask;              // 启用的引擎，bit i 对应 PercentSudokuEngine i
+    const char* corpus_file;      // 谜题文件（单行格式），NULL 时按种子生成
+    const char* csv_file;         // CSV 输出文件，NULL 不输出
+    const char* json_file;        // JSON 输出文件，NULL 不输出
+} BenchmarkOptions;
+
+// 单个（难度, 引擎）的测试结果
+typedef struct {
+    int difficulty;               // 0 表示来自谜题文件
+    PercentSudokuEngine engine;
+    int num_puzzles;
+    int solved;                   // 求解成功且通过验证
+    int failed;                   // 无解、超时或解答错误
+    double total_time_ms;
+    double puzzles_per_second;
+    LatencySummary latency;
+} BenchmarkResult;
+
+// 函数声明
+
+void init_benchmark_options(BenchmarkOptions* options);
+int parse_engine_list(const char* list, int* engine_mask);
+int generate_benchmark_corpus(int difficulty, int count, unsigned int seed, PercentSudokuGrid* puzzles);
+int load_benchmark_corpus(const char* filename, PercentSudokuGrid** puzzles);
+int run_percent_sudoku_benchmark(const BenchmarkOptions* options);
+
+#endif // PERCENT_SUDOKU_BENCHMARK_H
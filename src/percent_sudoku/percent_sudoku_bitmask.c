@@ -0,0 +1,297 @@
+#include "percent_sudoku_bitmask.h"
+
+// 统计候选掩码中的数字个数
+int count_candidate_bits(int mask) {
+#ifdef __GNUC__
+    return __builtin_popcount((unsigned int)mask);
+#else
+    int count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// 掩码中最低位数字
+static int lowest_digit(int mask) {
+#ifdef __GNUC__
+    return __builtin_ctz((unsigned int)mask);
+#else
+    int num = 0;
+    while (!(mask & (1 << num))) num++;
+    return num;
+#endif
+}
+
+// 获取格子所属的约束单元编号（对应 PERCENT_SUDOKU_UNITS），返回单元数量（3-5）
+int get_cell_units(int cell, int units[5]) {
+    int row = cell / PERCENT_SUDOKU_SIZE;
+    int col = cell % PERCENT_SUDOKU_SIZE;
+    int count = 0;
+    
+    units[count++] = row;
+    units[count++] = 9 + col;
+    units[count++] = 18 + (row / 3) * 3 + col / 3;
+    if (row + col == 8) {
+        units[count++] = 27;  // 撇对角线
+    }
+    if (row >= 1 && row <= 3 && col >= 1 && col <= 3) {
+        units[count++] = 28;  // 上方窗口
+    }
+    if (row >= 5 && row <= 7 && col >= 5 && col <= 7) {
+        units[count++] = 29;  // 下方窗口
+    }
+    
+    return count;
+}
+
+// 计算格子的候选数字掩码
+int get_cell_candidates(const BitmaskSolverState* state, int cell) {
+    int units[5];
+    int count = get_cell_units(cell, units);
+    int used = 0;
+    
+    for (int i = 0; i < count; i++) {
+        used |= state->unit_used[units[i]];
+    }
+    
+    return PERCENT_SUDOKU_ALL_DIGITS & ~used;
+}
+
+// 在格子放置数字
+static void place_digit(BitmaskSolverState* state, int cell, int num) {
+    int units[5];
+    int count = get_cell_units(cell, units);
+    
+    for (int i = 0; i < count; i++) {
+        state->unit_used[units[i]] |= (unsigned short)(1 << num);
+    }
+    state->value[cell] = (unsigned char)num;
+    state->empty_count--;
+}
+
+// 撤销格子上的数字
+static void remove_digit(BitmaskSolverState* state, int cell) {
+    int units[5];
+    int count = get_cell_units(cell, units);
+    int bit = 1 << state->value[cell];
+    
+    for (int i = 0; i < count; i++) {
+        state->unit_used[units[i]] &= (unsigned short)~bit;
+    }
+    state->value[cell] = PERCENT_SUDOKU_EMPTY;
+    state->empty_count++;
+}
+
+// 从网格初始化状态，给定数字相互冲突时返回0
+int init_bitmask_state(BitmaskSolverState* state, const PercentSudokuGrid* grid) {
+    memset(state, 0, sizeof(BitmaskSolverState));
+    state->empty_count = PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE;
+    
+    for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+        int num = grid->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+        if (num == PERCENT_SUDOKU_EMPTY) {
+            continue;
+        }
+        if (num < PERCENT_SUDOKU_MIN_NUM || num > PERCENT_SUDOKU_MAX_NUM ||
+            !(get_cell_candidates(state, cell) & (1 << num))) {
+            return 0;
+        }
+        place_digit(state, cell, num);
+    }
+    
+    return 1;
+}
+
+// 应用唯一候选数与隐性唯一数，放置的格子记入trail
+// 返回0表示出现矛盾；*best_cell 返回候选最少的空格（无空格时为-1）
+// rng不为NULL时，候选数相同的空格中随机选择一个
+static int propagate_singles(BitmaskSolverState* state, int* trail, int* trail_length, int* best_cell, Rng* rng) {
+    int progress = 1;
+    
+    while (progress) {
+        progress = 0;
+        *best_cell = -1;
+        int best_count = 10;
+        int ties = 0;
+        
+        // 唯一候选数，同时寻找候选最少的空格
+        for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+            if (state->value[cell] != PERCENT_SUDOKU_EMPTY) {
+                continue;
+            }
+            int candidates = get_cell_candidates(state, cell);
+            int count = count_candidate_bits(candidates);
+            
+            if (count == 0) {
+                return 0;
+            }
+            if (count == 1) {
+                place_digit(state, cell, lowest_digit(candidates));
+                trail[(*trail_length)++] = cell;
+                progress = 1;
+            } else if (count < best_count) {
+                best_count = count;
+                *best_cell = cell;
+                ties = 1;
+            } else if (rng != NULL && count == best_count && rng_range(rng, ++ties) == 0) {
+                *best_cell = cell;  // 蓄水池抽样，并列的空格等概率被选中
+            }
+        }
+        if (progress) {
+            continue;
+        }
+        
+        // 隐性唯一数：某数字在单元内只剩一个位置
+        for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+            int missing = PERCENT_SUDOKU_ALL_DIGITS & ~state->unit_used[u];
+            if (missing == 0) {
+                continue;
+            }
+            
+            int once = 0, twice = 0;
+            for (int n = 0; n < 9; n++) {
+                int cell = PERCENT_SUDOKU_UNITS[u][n];
+                if (state->value[cell] == PERCENT_SUDOKU_EMPTY) {
+                    int candidates = get_cell_candidates(state, cell);
+                    twice |= once & candidates;
+                    once |= candidates;
+                }
+            }
+            
+            if (missing & ~once) {
+                return 0;  // 某个缺少的数字已无处可放
+            }
+            
+            int hidden = missing & once & ~twice;
+            while (hidden) {
+                int num = lowest_digit(hidden);
+                hidden &= hidden - 1;
+                
+                for (int n = 0; n < 9; n++) {
+                    int cell = PERCENT_SUDOKU_UNITS[u][n];
+                    if (state->value[cell] == PERCENT_SUDOKU_EMPTY && (get_cell_candidates(state, cell) & (1 << num))) {
+                        place_digit(state, cell, num);
+                        trail[(*trail_length)++] = cell;
+                        progress = 1;
+                        break;
+                    }
+                }
+                if (!(state->unit_used[u] & (1 << num))) {
+                    return 0;  // 同一格是两个数字的唯一位置
+                }
+            }
+            if (progress) {
+                break;
+            }
+        }
+    }
+    
+    return 1;
+}
+
+// 递归搜索，找到的第一个解写入solution，计数达到limit时停止
+// rng不为NULL时随机选择分支格子与数字的尝试顺序；node_budget不为NULL时，搜索节点数用完即放弃
+static void search_bitmask(BitmaskSolverState* state, int* count, int limit, PercentSudokuGrid* solution,
+                           Rng* rng, int* node_budget) {
+    int trail[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];
+    int trail_length = 0;
+    int best_cell;
+    
+    if (node_budget != NULL && --(*node_budget) < 0) {
+        return;
+    }
+    
+    if (propagate_singles(state, trail, &trail_length, &best_cell, rng)) {
+        if (state->empty_count == 0) {
+            if (*count == 0 && solution != NULL) {
+                for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+                    solution->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE] = state->value[cell];
+                }
+            }
+            (*count)++;
+        } else if (best_cell >= 0) {
+            int candidates = get_cell_candidates(state, best_cell);
+            int digits[9];
+            int num_digits = 0;
+            while (candidates) {
+                digits[num_digits++] = lowest_digit(candidates);
+                candidates &= candidates - 1;
+            }
+            if (rng != NULL) {
+                shuffle_array_with_rng(digits, num_digits, rng);
+            }
+            
+            for (int i = 0; i < num_digits && *count < limit && (node_budget == NULL || *node_budget >= 0); i++) {
+                place_digit(state, best_cell, digits[i]);
+                search_bitmask(state, count, limit, solution, rng, node_budget);
+                remove_digit(state, best_cell);
+            }
+        }
+    }
+    
+    // 撤销本层推理放置的数字
+    while (trail_length > 0) {
+        remove_digit(state, trail[--trail_length]);
+    }
+}
+
+// 求解百分号数独，成功时将解写回grid
+int solve_percent_sudoku_bitmask(PercentSudokuGrid* grid) {
+    if (grid == NULL) {
+        return 0;
+    }
+    
+    BitmaskSolverState state;
+    if (!init_bitmask_state(&state, grid)) {
+        return 0;
+    }
+    
+    int count = 0;
+    search_bitmask(&state, &count, 1, grid, NULL, NULL);
+    return count > 0;
+}
+
+// 用随机的分支顺序求解，返回随机的一个解（空网格时即随机生成完整解答）
+// 随机顺序偶尔会陷入很深的回溯，因此给每轮搜索限定节点数，用完后换一个随机顺序重来，
+// 每轮的限额加倍，保证最终能完成完整搜索
+int solve_percent_sudoku_bitmask_random(PercentSudokuGrid* grid, Rng* rng) {
+    if (grid == NULL || rng == NULL) {
+        return 0;
+    }
+    
+    BitmaskSolverState state;
+    if (!init_bitmask_state(&state, grid)) {
+        return 0;
+    }
+    
+    for (int budget = BITMASK_RESTART_NODES; ; budget *= 2) {
+        int count = 0;
+        int node_budget = budget;
+        search_bitmask(&state, &count, 1, grid, rng, &node_budget);
+        if (count > 0) {
+            return 1;
+        }
+        if (node_budget >= 0 || budget > (1 << 28)) {
+            return 0;  // 搜索已完成仍无解
+        }
+    }
+}
+
+// 计算解的个数（最多计到limit）
+int count_percent_sudoku_solutions_bitmask(const PercentSudokuGrid* grid, int limit) {
+    if (grid == NULL || limit <= 0) {
+        return 0;
+    }
+    
+    BitmaskSolverState state;
+    if (!init_bitmask_state(&state, grid)) {
+        return 0;
+    }
+    
+    int count = 0;
+    search_bitmask(&state, &count, limit, NULL, NULL, NULL);
+    return count;
+}
@@ -0,0 +1,41 @@
+#ifndef PERCENT_SUDOKU_BITMASK_H
+#define PERCENT_SUDOKU_BITMASK_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// 基于位掩码候选集的回溯求解器
+// 每个约束单元（9行、9列、9宫、撇对角线、2个窗口）维护一个9位"已用数字"掩码，
+// 格子的候选集 = 所在各单元掩码之并的补集。
+// 搜索时优先选择候选数最少的空格（MRV），并在每次决策之间应用唯一候选数与隐性唯一数推理。
+// _random 版本在候选数相同的空格间随机选择，并随机排列数字的尝试顺序，用于生成随机的完整解答。
+
+// 候选掩码：bit k 表示数字 k（k = 1..9）
+#define PERCENT_SUDOKU_ALL_DIGITS 0x3FE
+
+// 随机求解时第一轮搜索的节点限额（之后每轮加倍）
+#define BITMASK_RESTART_NODES 64
+
+// 求解状态
+typedef struct {
+    unsigned short unit_used[PERCENT_SUDOKU_NUM_UNITS];  // 各单元已使用的数字
+    unsigned char value[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];  // 格子的值，0表示空
+    int empty_count;                                     // 剩余空格数量
+} BitmaskSolverState;
+
+// 函数声明
+
+// 状态操作
+int init_bitmask_state(BitmaskSolverState* state, const PercentSudokuGrid* grid);
+int get_cell_units(int cell, int units[5]);
+int get_cell_candidates(const BitmaskSolverState* state, int cell);
+
+// 求解与计数
+int solve_percent_sudoku_bitmask(PercentSudokuGrid* grid);
+int solve_percent_sudoku_bitmask_random(PercentSudokuGrid* grid, Rng* rng);
+int count_percent_sudoku_solutions_bitmask(const PercentSudokuGrid* grid, int limit);
+
+// 工具函数
+int count_candidate_bits(int mask);
+
+#endif // PERCENT_SUDOKU_BITMASK_H
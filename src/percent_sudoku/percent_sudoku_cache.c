@@ -0,0 +1,364 @@
+#include "percent_sudoku_cache.h"
+
+#define NUM_CELLS (PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE)
+#define CACHE_HEADER_SIZE 12
+#define CACHE_RECORD_SIZE (2 * NUM_CELLS)
+
+// 小端序读写
+static void put_u32(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+    out[2] = (unsigned char)((value >> 16) & 0xFF);
+    out[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+static unsigned int get_u32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8) | ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+// 创建缓存，capacity<=0 时使用默认容量
+PuzzleCache* create_puzzle_cache(int capacity) {
+    if (capacity <= 0) {
+        capacity = PUZZLE_CACHE_DEFAULT_CAPACITY;
+    }
+    
+    PuzzleCache* cache = (PuzzleCache*)tracked_malloc(MEMORY_SUDOKU, sizeof(PuzzleCache));
+    memset(cache, 0, sizeof(PuzzleCache));
+    cache->capacity = capacity;
+    cache->entries = (PuzzleCacheEntry*)tracked_malloc(MEMORY_SUDOKU, capacity * sizeof(PuzzleCacheEntry));
+    
+    cache->num_buckets = 1;
+    while (cache->num_buckets < capacity) {
+        cache->num_buckets <<= 1;
+    }
+    cache->buckets = (int*)tracked_malloc(MEMORY_SUDOKU, cache->num_buckets * sizeof(int));
+    for (int i = 0; i < cache->num_buckets; i++) {
+        cache->buckets[i] = -1;
+    }
+    
+    cache->head = -1;
+    cache->tail = -1;
+    cache->stats.capacity = capacity;
+    pthread_mutex_init(&cache->mutex, NULL);
+    return cache;
+}
+
+// 释放缓存
+void free_puzzle_cache(PuzzleCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    
+    pthread_mutex_destroy(&cache->mutex);
+    safe_free(cache->entries);
+    safe_free(cache->buckets);
+    safe_free(cache);
+}
+
+// 从LRU链表中摘下条目
+static void unlink_entry(PuzzleCache* cache, int index) {
+    PuzzleCacheEntry* entry = &cache->entries[index];
+    if (entry->prev >= 0) {
+        cache->entries[entry->prev].next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next >= 0) {
+        cache->entries[entry->next].prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+}
+
+// 把条目放到LRU链表头部（最近使用）
+static void push_front(PuzzleCache* cache, int index) {
+    PuzzleCacheEntry* entry = &cache->entries[index];
+    entry->prev = -1;
+    entry->next = cache->head;
+    if (cache->head >= 0) {
+        cache->entries[cache->head].prev = index;
+    }
+    cache->head = index;
+    if (cache->tail < 0) {
+        cache->tail = index;
+    }
+}
+
+// 在哈希桶中查找条目，未找到返回-1（调用方持有锁）
+static int find_entry(PuzzleCache* cache, uint64_t key, const unsigned char* puzzle) {
+    int index = cache->buckets[key & (uint64_t)(cache->num_buckets - 1)];
+    while (index >= 0) {
+        PuzzleCacheEntry* entry = &cache->entries[index];
+        if (entry->key == key && memcmp(entry->puzzle, puzzle, NUM_CELLS) == 0) {
+            return index;
+        }
+        index = entry->bucket_next;
+    }
+    return -1;
+}
+
+// 从哈希桶中移除条目
+static void remove_from_bucket(PuzzleCache* cache, int index) {
+    int* link = &cache->buckets[cache->entries[index].key & (uint64_t)(cache->num_buckets - 1)];
+    while (*link >= 0) {
+        if (*link == index) {
+            *link = cache->entries[index].bucket_next;
+            return;
+        }
+        link = &cache->entries[*link].bucket_next;
+    }
+}
+
+// 插入或更新规范形式下的条目（调用方持有锁）
+static void store_entry(PuzzleCache* cache, uint64_t key, const unsigned char* puzzle, const unsigned char* solution) {
+    int index = find_entry(cache, key, puzzle);
+    if (index >= 0) {
+        memcpy(cache->entries[index].solution, solution, NUM_CELLS);
+        unlink_entry(cache, index);
+        push_front(cache, index);
+        return;
+    }
+    
+    if (cache->count < cache->capacity) {
+        index = cache->count++;
+    } else {
+        // 淘汰最久未使用的条目
+        index = cache->tail;
+        unlink_entry(cache, index);
+        remove_from_bucket(cache, index);
+        cache->stats.evictions++;
+    }
+    
+    PuzzleCacheEntry* entry = &cache->entries[index];
+    entry->key = key;
+    memcpy(entry->puzzle, puzzle, NUM_CELLS);
+    memcpy(entry->solution, solution, NUM_CELLS);
+    
+    int bucket = (int)(key & (uint64_t)(cache->num_buckets - 1));
+    entry->bucket_next = cache->buckets[bucket];
+    cache->buckets[bucket] = index;
+    push_front(cache, index);
+    
+    cache->stats.insertions++;
+}
+
+// 查询缓存，命中时把解答映射回原谜题写入solution并返回1
+int lookup_puzzle_cache(PuzzleCache* cache, const CanonicalPuzzle* canonical, PercentSudokuGrid* solution) {
+    if (cache == NULL || canonical == NULL || solution == NULL) {
+        return 0;
+    }
+    
+    PercentSudokuGrid canonical_solution;
+    int found = 0;
+    
+    pthread_mutex_lock(&cache->mutex);
+    cache->stats.lookups++;
+    int index = find_entry(cache, canonical->hash, canonical->cells);
+    if (index >= 0) {
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            canonical_solution.grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE] = cache->entries[index].solution[cell];
+            canonical_solution.is_given[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE] = 0;
+        }
+        unlink_entry(cache, index);
+        push_front(cache, index);
+        cache->stats.hits++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    
+    if (found) {
+        PercentSudokuTransform inverse;
+        invert_transform(&canonical->to_canonical, &inverse);
+        apply_transform_grid(&inverse, &canonical_solution, solution);
+    }
+    return found;
+}
+
+// 把谜题的解答写入缓存（以规范形式保存）
+void insert_puzzle_cache(PuzzleCache* cache, const CanonicalPuzzle* canonical, const PercentSudokuGrid* solution) {
+    if (cache == NULL || canonical == NULL || solution == NULL) {
+        return;
+    }
+    
+    PercentSudokuGrid canonical_solution;
+    unsigned char solution_cells[NUM_CELLS];
+    apply_transform_grid(&canonical->to_canonical, solution, &canonical_solution);
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        solution_cells[cell] = (unsigned char)canonical_solution.grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+    }
+    
+    pthread_mutex_lock(&cache->mutex);
+    store_entry(cache, canonical->hash, canonical->cells, solution_cells);
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// 先查缓存，未命中时用指定引擎求解，有解时写入缓存
+PercentSudokuResult solve_percent_sudoku_cached(PuzzleCache* cache, PercentSudokuEngine engine,
+                                                const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution,
+                                                double timeout_seconds, int* hit) {
+    if (hit != NULL) {
+        *hit = 0;
+    }
+    if (cache == NULL || puzzle == NULL || solution == NULL) {
+        return solve_percent_sudoku_with_engine(engine, puzzle, solution, timeout_seconds);
+    }
+    
+    CanonicalPuzzle canonical;
+    canonicalize_percent_sudoku(puzzle, &canonical);
+    if (lookup_puzzle_cache(cache, &canonical, solution)) {
+        if (hit != NULL) {
+            *hit = 1;
+        }
+        return PERCENT_SUDOKU_SOLVED;
+    }
+    
+    PercentSudokuResult result = solve_percent_sudoku_with_engine(engine, puzzle, solution, timeout_seconds);
+    if (result == PERCENT_SUDOKU_SOLVED) {
+        insert_puzzle_cache(cache, &canonical, solution);
+    }
+    return result;
+}
+
+// 检查一条缓存记录：解答必须完整、合法，且与规范化谜题的已给数字一致
+static int is_consistent_record(const unsigned char* record) {
+    PercentSudokuGrid puzzle;
+    PercentSudokuGrid solution;
+    memset(&puzzle, 0, sizeof(puzzle));
+    memset(&solution, 0, sizeof(solution));
+    
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        // 越界的值不能进入网格
+        if (record[cell] > PERCENT_SUDOKU_MAX_NUM || record[NUM_CELLS + cell] > PERCENT_SUDOKU_MAX_NUM) {
+            return 0;
+        }
+        puzzle.grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE] = record[cell];
+        solution.grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE] = record[NUM_CELLS + cell];
+    }
+    
+    return is_complete_percent_sudoku(&solution) && is_valid_percent_sudoku(&solution) &&
+           verify_solution_correctness(&puzzle, &solution);
+}
+
+// 从缓存文件加载条目，返回加载的条目数；文件不存在返回0，格式错误返回-1
+int load_puzzle_cache(PuzzleCache* cache, const char* filename) {
+    if (cache == NULL || filename == NULL) {
+        return -1;
+    }
+    
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    
+    unsigned char header[CACHE_HEADER_SIZE];
+    if (fread(header, 1, CACHE_HEADER_SIZE, file) != CACHE_HEADER_SIZE ||
+        memcmp(header, PUZZLE_CACHE_MAGIC, 4) != 0 || get_u32(header + 4) != PUZZLE_CACHE_VERSION) {
+        print_error("load_puzzle_cache", COMMON_ERROR_INVALID_PARAMETER, "Not a puzzle cache file");
+        fclose(file);
+        return -1;
+    }
+    
+    unsigned int count = get_u32(header + 8);
+    unsigned char record[CACHE_RECORD_SIZE];
+    int loaded = 0;
+    int dropped = 0;
+    
+    pthread_mutex_lock(&cache->mutex);
+    for (unsigned int i = 0; i < count; i++) {
+        if (fread(record, 1, CACHE_RECORD_SIZE, file) != CACHE_RECORD_SIZE) {
+            print_error("load_puzzle_cache", COMMON_ERROR_INVALID_PARAMETER, "Truncated puzzle cache file");
+            break;
+        }
+        
+        if (!is_consistent_record(record)) {
+            dropped++;
+            continue;
+        }
+        
+        store_entry(cache, hash_fnv1a64(record, NUM_CELLS), record, record + NUM_CELLS);
+        loaded++;
+    }
+    // 加载的条目不计入本次运行的插入次数
+    cache->stats.insertions = 0;
+    cache->stats.evictions = 0;
+    pthread_mutex_unlock(&cache->mutex);
+    
+    fclose(file);
+    if (dropped > 0) {
+        fprintf(stderr, "Warning: Dropped %d invalid entries from puzzle cache %s\n", dropped, filename);
+    }
+    return loaded;
+}
+
+// 把缓存写入文件（从最久未使用到最近使用），返回写出的条目数，失败返回-1
+int save_puzzle_cache(PuzzleCache* cache, const char* filename) {
+    if (cache == NULL || filename == NULL) {
+        return -1;
+    }
+    
+    // 先写临时文件再改名，中途失败不会覆盖原有的缓存
+    char temp_path[MAX_PATH_LENGTH + 8];
+    int path_length = snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* file = (path_length > 0 && (size_t)path_length < sizeof(temp_path)) ? fopen(temp_path, "wb") : NULL;
+    if (file == NULL) {
+        print_error("save_puzzle_cache", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open cache file for writing");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&cache->mutex);
+    
+    unsigned char header[CACHE_HEADER_SIZE];
+    memcpy(header, PUZZLE_CACHE_MAGIC, 4);
+    put_u32(header + 4, PUZZLE_CACHE_VERSION);
+    put_u32(header + 8, (unsigned int)cache->count);
+    int ok = fwrite(header, 1, CACHE_HEADER_SIZE, file) == CACHE_HEADER_SIZE;
+    
+    int written = 0;
+    for (int index = cache->tail; index >= 0 && ok; index = cache->entries[index].prev) {
+        ok = fwrite(cache->entries[index].puzzle, 1, NUM_CELLS, file) == NUM_CELLS &&
+             fwrite(cache->entries[index].solution, 1, NUM_CELLS, file) == NUM_CELLS;
+        written += ok;
+    }
+    
+    pthread_mutex_unlock(&cache->mutex);
+    
+    ok = (fclose(file) == 0) && ok;
+
+#ifdef _WIN32
+    remove(filename);
+#endif
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        print_error("save_puzzle_cache", COMMON_ERROR_UNKNOWN, "Failed to write cache file");
+        return -1;
+    }
+    return written;
+}
+
+// 读取统计快照
+void get_puzzle_cache_stats(PuzzleCache* cache, PuzzleCacheStats* stats) {
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(PuzzleCacheStats));
+    if (cache == NULL) {
+        return;
+    }
+    
+    pthread_mutex_lock(&cache->mutex);
+    *stats = cache->stats;
+    stats->entries = cache->count;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// 打印缓存统计
+void print_puzzle_cache_stats(const PuzzleCacheStats* stats) {
+    if (stats == NULL) {
+        return;
+    }
+    
+    printf("Cache: %llu/%llu hits (%.1f%%), %d/%d entries, %llu inserted, %llu evicted\n",
+           stats->hits, stats->lookups,
+           stats->lookups > 0 ? stats->hits * 100.0 / stats->lookups : 0.0,
+           stats->entries, stats->capacity, stats->insertions, stats->evictions);
+}
@@ -0,0 +1,81 @@
+#ifndef PERCENT_SUDOKU_CACHE_H
+#define PERCENT_SUDOKU_CACHE_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+#include "percent_sudoku_solver.h"
+#include "percent_sudoku_transform.h"
+#include <pthread.h>
+
+// 已解谜题缓存
+// 以规范形式（见 percent_sudoku_transform.h）为键，保存规范形式下的解答。重标记、反射等
+// 变换后再次出现的谜题会命中同一条目，取出的解答经逆变换映射回原谜题。
+// 容量固定，超出时淘汰最久未使用的条目（LRU）。所有操作由互斥锁保护，可在多线程中共享。
+//
+// 缓存文件（.pscache，小端序）：
+//   0   "PSCA"     魔数
+//   4   u32 版本号 当前为1
+//   8   u32 条目数
+//   12  条目，每条为81字节规范谜题 + 81字节规范解答，按最久未使用到最近使用的顺序排列
+// 保存时先写 <文件名>.tmp 再改名，写入中途失败不会破坏原有的缓存文件。
+
+#define PUZZLE_CACHE_MAGIC "PSCA"
+#define PUZZLE_CACHE_VERSION 1
+#define PUZZLE_CACHE_DEFAULT_CAPACITY 65536
+
+// 缓存统计
+typedef struct {
+    unsigned long long lookups;     // 查询次数
+    unsigned long long hits;        // 命中次数
+    unsigned long long insertions;  // 插入次数
+    unsigned long long evictions;   // 淘汰次数
+    int entries;                    // 当前条目数
+    int capacity;                   // 容量
+} PuzzleCacheStats;
+
+// 缓存条目
+typedef struct {
+    uint64_t key;
+    unsigned char puzzle[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];    // 规范谜题（用于排除哈希冲突）
+    unsigned char solution[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];  // 规范解答
+    int prev;                       // LRU链表：更近使用的条目
+    int next;                       // LRU链表：更久未使用的条目
+    int bucket_next;                // 同一哈希桶中的下一个条目
+} PuzzleCacheEntry;
+
+// 缓存
+typedef struct {
+    pthread_mutex_t mutex;
+    PuzzleCacheEntry* entries;
+    int capacity;
+    int count;
+    int* buckets;                   // 哈希桶，存放条目下标，-1表示空
+    int num_buckets;                // 2的幂
+    int head;                       // 最近使用的条目
+    int tail;                       // 最久未使用的条目
+    PuzzleCacheStats stats;
+} PuzzleCache;
+
+// 函数声明
+
+PuzzleCache* create_puzzle_cache(int capacity);
+void free_puzzle_cache(PuzzleCache* cache);
+
+// 查询与插入（canonical 由 canonicalize_percent_sudoku 计算）
+int lookup_puzzle_cache(PuzzleCache* cache, const CanonicalPuzzle* canonical, PercentSudokuGrid* solution);
+void insert_puzzle_cache(PuzzleCache* cache, const CanonicalPuzzle* canonical, const PercentSudokuGrid* solution);
+
+// 先查缓存，未命中时求解并写入缓存；hit 可为NULL
+PercentSudokuResult solve_percent_sudoku_cached(PuzzleCache* cache, PercentSudokuEngine engine,
+                                                const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution,
+                                                double timeout_seconds, int* hit);
+
+// 持久化
+int load_puzzle_cache(PuzzleCache* cache, const char* filename);
+int save_puzzle_cache(PuzzleCache* cache, const char* filename);
+
+// 统计
+void get_puzzle_cache_stats(PuzzleCache* cache, PuzzleCacheStats* stats);
+void print_puzzle_cache_stats(const PuzzleCacheStats* stats);
+
+#endif // PERCENT_SUDOKU_CACHE_H
@@ -1,5 +1,6 @@
 #include "percent_sudoku_cnf.h"
 #include "../solver/solver.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,183 +29,242 @@ void get_position_from_variable(int var_index, int* row, int* col, int* num) {
     *row = var_index / 9;
 }
 
+// Name of an at-most-one encoding, for reports
+const char* amo_encoding_name(AmoEncoding encoding) {
+    switch (encoding) {
+        case AMO_ENCODING_PAIRWISE: return "pairwise";
+        case AMO_ENCODING_SEQUENTIAL: return "sequential";
+        case AMO_ENCODING_COMMANDER: return "commander";
+        case AMO_ENCODING_PRODUCT: return "product";
+        default: return "unknown";
+    }
+}
+
+// Initialize CNF options with the default (pairwise) encoding
+void init_cnf_options(PercentSudokuCnfOptions* options) {
+    if (options == NULL) return;
+    
+    options->amo_encoding = AMO_ENCODING_PAIRWISE;
+    options->reduced = 0;
+    options->extended = 0;
+}
+
+// Pairwise AMO: (-xi OR -xj) for every pair, n(n-1)/2 clauses, no auxiliary variables
+static void add_amo_pairwise(Formula* formula, const int* vars, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            int literals[2] = {-vars[i], -vars[j]};
+            add_clause_to_formula(formula, literals, 2);
+        }
+    }
+}
+
+// Sequential counter AMO (Sinz): s_i means "some x_1..x_i is true", 3n-4 clauses, n-1 auxiliary variables
+static void add_amo_sequential(Formula* formula, const int* vars, int n) {
+    if (n <= 1) return;
+    
+    int prev = add_variable_to_formula(formula);
+    int literals[2] = {-vars[0], prev};
+    add_clause_to_formula(formula, literals, 2);
+    
+    for (int i = 1; i < n - 1; i++) {
+        int s = add_variable_to_formula(formula);
+        
+        literals[0] = -vars[i]; literals[1] = s;
+        add_clause_to_formula(formula, literals, 2);
+        literals[0] = -prev; literals[1] = s;
+        add_clause_to_formula(formula, literals, 2);
+        literals[0] = -vars[i]; literals[1] = -prev;
+        add_clause_to_formula(formula, literals, 2);
+        
+        prev = s;
+    }
+    
+    literals[0] = -vars[n - 1]; literals[1] = -prev;
+    add_clause_to_formula(formula, literals, 2);
+}
+
+// Commander AMO (Klieber-Kwon): groups of 3, pairwise inside each group, recurse on the commanders
+static void add_amo_commander(Formula* formula, const int* vars, int n) {
+    if (n <= 4) {
+        add_amo_pairwise(formula, vars, n);
+        return;
+    }
+    
+    int commanders[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];
+    int num_commanders = 0;
+    
+    for (int start = 0; start < n; start += 3) {
+        int size = (n - start < 3) ? n - start : 3;
+        int c = add_variable_to_formula(formula);
+        commanders[num_commanders++] = c;
+        
+        // At most one variable of the group
+        add_amo_pairwise(formula, vars + start, size);
+        
+        // A true variable forces its commander, a true commander needs a true variable
+        int literals[4];
+        literals[0] = -c;
+        for (int i = 0; i < size; i++) {
+            int implication[2] = {-vars[start + i], c};
+            add_clause_to_formula(formula, implication, 2);
+            literals[i + 1] = vars[start + i];
+        }
+        add_clause_to_formula(formula, literals, size + 1);
+    }
+    
+    add_amo_commander(formula, commanders, num_commanders);
+}
+
+// Product AMO (Chen): place variables on a p x q grid, x_(a,b) implies row a and column b
+static void add_amo_product(Formula* formula, const int* vars, int n) {
+    if (n <= 4) {
+        add_amo_pairwise(formula, vars, n);
+        return;
+    }
+    
+    int p = 1;
+    while (p * p < n) p++;
+    int q = (n + p - 1) / p;
+    
+    int rows[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];
+    int cols[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];
+    for (int a = 0; a < p; a++) rows[a] = add_variable_to_formula(formula);
+    for (int b = 0; b < q; b++) cols[b] = add_variable_to_formula(formula);
+    
+    for (int i = 0; i < n; i++) {
+        int literals[2] = {-vars[i], rows[i / q]};
+        add_clause_to_formula(formula, literals, 2);
+        literals[1] = cols[i % q];
+        add_clause_to_formula(formula, literals, 2);
+    }
+    
+    add_amo_product(formula, rows, p);
+    add_amo_product(formula, cols, q);
+}
+
+// Add "at most one of vars is true" with the selected encoding
+void add_at_most_one(Formula* formula, const int* vars, int n, AmoEncoding encoding) {
+    switch (encoding) {
+        case AMO_ENCODING_SEQUENTIAL: add_amo_sequential(formula, vars, n); break;
+        case AMO_ENCODING_COMMANDER: add_amo_commander(formula, vars, n); break;
+        case AMO_ENCODING_PRODUCT: add_amo_product(formula, vars, n); break;
+        case AMO_ENCODING_PAIRWISE:
+        default: add_amo_pairwise(formula, vars, n); break;
+    }
+}
+
 // Add cell constraints: each cell must contain a digit from 1 to 9
 void add_cell_constraints(Formula* formula) {
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
-            Clause* clause = create_clause(9);
+            int literals[9];
             
             // Each cell must contain at least one digit (1-9)
             for (int k = 1; k <= 9; k++) {
-                int var_index = get_variable_index(i, j, k);
-                add_literal(clause, var_index);
+                literals[k - 1] = get_variable_index(i, j, k);
             }
             
-            // Add clause to formula
-            formula->clauses[formula->num_clauses] = *clause;
-            formula->num_clauses++;
-            safe_free(clause);
+            add_clause_to_formula(formula, literals, 9);
         }
     }
 }
 
 // Add row constraints: each digit appears at most once in each row
-void add_row_constraints(Formula* formula) {
+void add_row_constraints(Formula* formula, AmoEncoding encoding) {
     for (int i = 0; i < 9; i++) {
         for (int k = 1; k <= 9; k++) {
-            // Each digit appears at most once in each row
-            for (int j1 = 0; j1 < 9; j1++) {
-                for (int j2 = j1 + 1; j2 < 9; j2++) {
-                    Clause* clause = create_clause(2);
-                    int var1 = get_variable_index(i, j1, k);
-                    int var2 = get_variable_index(i, j2, k);
-                    add_literal(clause, -var1);  // Negate first variable
-                    add_literal(clause, -var2);  // Negate second variable
-                    
-                    formula->clauses[formula->num_clauses] = *clause;
-                    formula->num_clauses++;
-                    safe_free(clause);
-                }
+            int vars[9];
+            for (int j = 0; j < 9; j++) {
+                vars[j] = get_variable_index(i, j, k);
             }
+            add_at_most_one(formula, vars, 9, encoding);
         }
     }
 }
 
 // Add column constraints: each digit appears at most once in each column
-void add_column_constraints(Formula* formula) {
+void add_column_constraints(Formula* formula, AmoEncoding encoding) {
     for (int j = 0; j < 9; j++) {
         for (int k = 1; k <= 9; k++) {
-            // Each digit appears at most once in each column
-            for (int i1 = 0; i1 < 9; i1++) {
-                for (int i2 = i1 + 1; i2 < 9; i2++) {
-                    Clause* clause = create_clause(2);
-                    int var1 = get_variable_index(i1, j, k);
-                    int var2 = get_variable_index(i2, j, k);
-                    add_literal(clause, -var1);  // Negate first variable
-                    add_literal(clause, -var2);  // Negate second variable
-                    
-                    formula->clauses[formula->num_clauses] = *clause;
-                    formula->num_clauses++;
-                    safe_free(clause);
-                }
+            int vars[9];
+            for (int i = 0; i < 9; i++) {
+                vars[i] = get_variable_index(i, j, k);
             }
+            add_at_most_one(formula, vars, 9, encoding);
         }
     }
 }
 
 // Add box constraints: each digit appears at most once in each 3x3 box
-void add_box_constraints(Formula* formula) {
+void add_box_constraints(Formula* formula, AmoEncoding encoding) {
     for (int box_row = 0; box_row < 3; box_row++) {
         for (int box_col = 0; box_col < 3; box_col++) {
             for (int k = 1; k <= 9; k++) {
-                // Each digit appears at most once in each box
-                for (int i1 = 0; i1 < 3; i1++) {
-                    for (int j1 = 0; j1 < 3; j1++) {
-                        for (int i2 = 0; i2 < 3; i2++) {
-                            for (int j2 = 0; j2 < 3; j2++) {
-                                if (i1 != i2 || j1 != j2) {
-                                    int row1 = box_row * 3 + i1;
-                                    int col1 = box_col * 3 + j1;
-                                    int row2 = box_row * 3 + i2;
-                                    int col2 = box_col * 3 + j2;
-                                    
-                                    // Avoid duplicate constraints
-                                    if ((row1 * 9 + col1) < (row2 * 9 + col2)) {
-                                        Clause* clause = create_clause(2);
-                                        int var1 = get_variable_index(row1, col1, k);
-                                        int var2 = get_variable_index(row2, col2, k);
-                                        add_literal(clause, -var1);
-                                        add_literal(clause, -var2);
-                                        
-                                        formula->clauses[formula->num_clauses] = *clause;
-                                        formula->num_clauses++;
-                                        safe_free(clause);
-                                    }
-                                }
-                            }
-                        }
-                    }
+                // Cells in row-major order, so pairwise clauses keep their (row1*9+col1) < (row2*9+col2) order
+                int vars[9];
+                for (int n = 0; n < 9; n++) {
+                    vars[n] = get_variable_index(box_row * 3 + n / 3, box_col * 3 + n % 3, k);
                 }
+                add_at_most_one(formula, vars, 9, encoding);
             }
         }
     }
 }
 
 // Add anti-diagonal constraints
-void add_diagonal_constraints(Formula* formula) {
+void add_diagonal_constraints(Formula* formula, AmoEncoding encoding) {
     // Anti-diagonal: i + j = 8 (array index starts from 0)
     for (int k = 1; k <= 9; k++) {
-        // Each digit appears at most once on the anti-diagonal
-        for (int i1 = 0; i1 < 9; i1++) {
-            int j1 = 8 - i1;  // Anti-diagonal: i + j = 8
-            for (int i2 = i1 + 1; i2 < 9; i2++) {
-                int j2 = 8 - i2;
-                
-                Clause* clause = create_clause(2);
-                int var1 = get_variable_index(i1, j1, k);
-                int var2 = get_variable_index(i2, j2, k);
-                add_literal(clause, -var1);
-                add_literal(clause, -var2);
-                
-                formula->clauses[formula->num_clauses] = *clause;
-                formula->num_clauses++;
-                safe_free(clause);
-            }
+        int vars[9];
+        for (int i = 0; i < 9; i++) {
+            vars[i] = get_variable_index(i, 8 - i, k);
         }
+        add_at_most_one(formula, vars, 9, encoding);
     }
 }
 
 // Add window constraints
-void add_window_constraints(Formula* formula) {
-    // Upper window: (1,1) to (3,3)
-    for (int k = 1; k <= 9; k++) {
-        for (int i1 = 1; i1 <= 3; i1++) {
-            for (int j1 = 1; j1 <= 3; j1++) {
-                for (int i2 = 1; i2 <= 3; i2++) {
-                    for (int j2 = 1; j2 <= 3; j2++) {
-                        if (i1 != i2 || j1 != j2) {
-                            // Avoid duplicate constraints
-                            if ((i1 * 9 + j1) < (i2 * 9 + j2)) {
-                                Clause* clause = create_clause(2);
-                                int var1 = get_variable_index(i1, j1, k);
-                                int var2 = get_variable_index(i2, j2, k);
-                                add_literal(clause, -var1);
-                                add_literal(clause, -var2);
-                                
-                                formula->clauses[formula->num_clauses] = *clause;
-                                formula->num_clauses++;
-                                safe_free(clause);
-                            }
-                        }
-                    }
-                }
+void add_window_constraints(Formula* formula, AmoEncoding encoding) {
+    // Upper window: (1,1) to (3,3), lower window: (5,5) to (7,7)
+    const int window_starts[2] = {1, 5};
+    
+    for (int w = 0; w < 2; w++) {
+        int start = window_starts[w];
+        for (int k = 1; k <= 9; k++) {
+            int vars[9];
+            for (int n = 0; n < 9; n++) {
+                vars[n] = get_variable_index(start + n / 3, start + n % 3, k);
             }
+            add_at_most_one(formula, vars, 9, encoding);
         }
     }
-    
-    // Lower window: (5,5) to (7,7)
-    for (int k = 1; k <= 9; k++) {
-        for (int i1 = 5; i1 <= 7; i1++) {
-            for (int j1 = 5; j1 <= 7; j1++) {
-                for (int i2 = 5; i2 <= 7; i2++) {
-                    for (int j2 = 5; j2 <= 7; j2++) {
-                        if (i1 != i2 || j1 != j2) {
-                            // Avoid duplicate constraints
-                            if ((i1 * 9 + j1) < (i2 * 9 + j2)) {
-                                Clause* clause = create_clause(2);
-                                int var1 = get_variable_index(i1, j1, k);
-                                int var2 = get_variable_index(i2, j2, k);
-                                add_literal(clause, -var1);
-                                add_literal(clause, -var2);
-                                
-                                formula->clauses[formula->num_clauses] = *clause;
-                                formula->num_clauses++;
-                                safe_free(clause);
-                            }
-                        }
-                    }
-                }
+}
+
+// Add redundant unit constraints: each digit appears at least once in every row, column,
+// box, the anti-diagonal and both windows, so unit propagation finds hidden singles
+void add_unit_digit_constraints(Formula* formula) {
+    for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+        for (int k = 1; k <= 9; k++) {
+            int literals[9];
+            for (int n = 0; n < 9; n++) {
+                int cell = PERCENT_SUDOKU_UNITS[u][n];
+                literals[n] = get_variable_index(cell / 9, cell % 9, k);
             }
+            add_clause_to_formula(formula, literals, 9);
+        }
+    }
+}
+
+// Add channeling constraints: each cell contains at most one digit
+void add_cell_at_most_one_constraints(Formula* formula, AmoEncoding encoding) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int vars[9];
+            for (int k = 1; k <= 9; k++) {
+                vars[k - 1] = get_variable_index(i, j, k);
+            }
+            add_at_most_one(formula, vars, 9, encoding);
         }
     }
 }
@@ -214,35 +274,282 @@ void add_given_constraints(Formula* formula, const PercentSudokuGrid* puzzle) {
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
             if (puzzle->grid[i][j] != PERCENT_SUDOKU_EMPTY) {
-                int num = puzzle->grid[i][j];
-                Clause* clause = create_clause(1);
-                int var_index = get_variable_index(i, j, num);
-                add_literal(clause, var_index);  // Force this variable to be true
-                
-                formula->clauses[formula->num_clauses] = *clause;
-                formula->num_clauses++;
-                safe_free(clause);
+                // Force this variable to be true
+                int literal = get_variable_index(i, j, puzzle->grid[i][j]);
+                add_clause_to_formula(formula, &literal, 1);
             }
         }
     }
 }
 
 // Add basic constraints (row, column, box)
-void add_basic_constraints(Formula* formula) {
+void add_basic_constraints(Formula* formula, AmoEncoding encoding) {
     add_cell_constraints(formula);
-    add_row_constraints(formula);
-    add_column_constraints(formula);
-    add_box_constraints(formula);
+    add_row_constraints(formula, encoding);
+    add_column_constraints(formula, encoding);
+    add_box_constraints(formula, encoding);
+}
+
+// Presolve givens at grid level: candidates[i][j] is a bitmask (bit k = digit k possible),
+// fixed[i][j] receives every digit decided by givens, naked singles or hidden singles.
+// Returns 0 if the givens contradict each other.
+int presolve_percent_sudoku_candidates(const PercentSudokuGrid* puzzle, int candidates[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE],
+                                       int fixed[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE]) {
+    const int all_digits = 0x3FE;  // bits 1..9
+    
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            candidates[i][j] = all_digits;
+            fixed[i][j] = PERCENT_SUDOKU_EMPTY;
+        }
+    }
+    
+    // Queue of decided cells whose digit still has to be removed from their units
+    int queue[81];
+    int queue_length = 0;
+    
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int num = puzzle->grid[i][j];
+            if (num != PERCENT_SUDOKU_EMPTY) {
+                if (num < 1 || num > 9 || !(candidates[i][j] & (1 << num))) {
+                    return 0;
+                }
+                candidates[i][j] = 1 << num;
+                fixed[i][j] = num;
+                queue[queue_length++] = i * 9 + j;
+            }
+        }
+    }
+    
+    int progress = 1;
+    while (progress) {
+        progress = 0;
+        
+        // Eliminate decided digits from every unit containing the cell
+        while (queue_length > 0) {
+            int cell = queue[--queue_length];
+            int bit = 1 << fixed[cell / 9][cell % 9];
+            
+            for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+                int in_unit = 0;
+                for (int n = 0; n < 9; n++) {
+                    if (PERCENT_SUDOKU_UNITS[u][n] == cell) {
+                        in_unit = 1;
+                        break;
+                    }
+                }
+                if (!in_unit) continue;
+                
+                for (int n = 0; n < 9; n++) {
+                    int peer = PERCENT_SUDOKU_UNITS[u][n];
+                    int r = peer / 9, c = peer % 9;
+                    if (peer == cell || !(candidates[r][c] & bit)) continue;
+                    
+                    if (fixed[r][c] != PERCENT_SUDOKU_EMPTY) {
+                        return 0;  // Two decided cells share a digit
+                    }
+                    candidates[r][c] &= ~bit;
+                    if (candidates[r][c] == 0) {
+                        return 0;
+                    }
+                }
+            }
+        }
+        
+        // Naked singles
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                int mask = candidates[i][j];
+                if (fixed[i][j] == PERCENT_SUDOKU_EMPTY && (mask & (mask - 1)) == 0) {
+                    int num = 1;
+                    while (!(mask & (1 << num))) num++;
+                    fixed[i][j] = num;
+                    queue[queue_length++] = i * 9 + j;
+                    progress = 1;
+                }
+            }
+        }
+        
+        // Hidden singles: a digit with one remaining place in a unit
+        for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS && queue_length == 0; u++) {
+            for (int num = 1; num <= 9; num++) {
+                int places = 0, place = -1, decided = 0;
+                for (int n = 0; n < 9; n++) {
+                    int cell = PERCENT_SUDOKU_UNITS[u][n];
+                    if (candidates[cell / 9][cell % 9] & (1 << num)) {
+                        places++;
+                        place = cell;
+                        if (fixed[cell / 9][cell % 9] == num) decided = 1;
+                    }
+                }
+                if (places == 0) {
+                    return 0;  // Digit can no longer be placed in this unit
+                }
+                if (places == 1 && !decided) {
+                    candidates[place / 9][place % 9] = 1 << num;
+                    fixed[place / 9][place % 9] = num;
+                    queue[queue_length++] = place;
+                    progress = 1;
+                    break;
+                }
+            }
+        }
+    }
+    
+    return 1;
 }
 
-// Convert Percent Sudoku puzzle to CNF formula
+// Fill the standard (identity) variable map
+static void init_standard_var_map(PercentSudokuVarMap* var_map) {
+    memset(var_map, 0, sizeof(PercentSudokuVarMap));
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            for (int k = 1; k <= 9; k++) {
+                int var = get_variable_index(i, j, k);
+                var_map->var_index[i][j][k] = var;
+                var_map->var_row[var] = i;
+                var_map->var_col[var] = j;
+                var_map->var_num[var] = k;
+            }
+        }
+    }
+    var_map->num_cell_vars = 729;
+}
+
+// Reduced encoding: variables only for undecided (cell, digit) candidates,
+// clauses already satisfied by decided cells are dropped
+static Formula* percent_sudoku_to_reduced_cnf(const PercentSudokuGrid* puzzle, const PercentSudokuCnfOptions* options,
+                                              PercentSudokuVarMap* var_map) {
+    int candidates[9][9];
+    memset(var_map, 0, sizeof(PercentSudokuVarMap));
+    
+    if (!presolve_percent_sudoku_candidates(puzzle, candidates, var_map->fixed)) {
+        // Contradictory givens: a single empty clause makes the formula unsatisfiable
+        Formula* formula = create_formula(0, 1);
+        add_clause_to_formula(formula, NULL, 0);
+        return formula;
+    }
+    
+    // Compact numbering of the remaining candidates
+    int num_vars = 0;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (var_map->fixed[i][j] != PERCENT_SUDOKU_EMPTY) continue;
+            for (int k = 1; k <= 9; k++) {
+                if (candidates[i][j] & (1 << k)) {
+                    num_vars++;
+                    var_map->var_index[i][j][k] = num_vars;
+                    var_map->var_row[num_vars] = i;
+                    var_map->var_col[num_vars] = j;
+                    var_map->var_num[num_vars] = k;
+                }
+            }
+        }
+    }
+    var_map->num_cell_vars = num_vars;
+    
+    Formula* formula = create_formula(num_vars, num_vars * 4 + 1);
+    
+    // Each undecided cell takes one of its remaining candidates
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (var_map->fixed[i][j] != PERCENT_SUDOKU_EMPTY) continue;
+            int literals[9];
+            int length = 0;
+            for (int k = 1; k <= 9; k++) {
+                if (var_map->var_index[i][j][k] != 0) {
+                    literals[length++] = var_map->var_index[i][j][k];
+                }
+            }
+            add_clause_to_formula(formula, literals, length);
+        }
+    }
+    
+    // Each digit at most once per unit, over the cells where it is still a candidate
+    for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+        for (int k = 1; k <= 9; k++) {
+            int vars[9];
+            int n = 0;
+            for (int c = 0; c < 9; c++) {
+                int cell = PERCENT_SUDOKU_UNITS[u][c];
+                int var = var_map->var_index[cell / 9][cell % 9][k];
+                if (var != 0) {
+                    vars[n++] = var;
+                }
+            }
+            if (n >= 2) {
+                add_at_most_one(formula, vars, n, options->amo_encoding);
+            }
+            
+            // Extended: the digit must still be placed somewhere in this unit
+            if (options->extended && n > 0) {
+                add_clause_to_formula(formula, vars, n);
+            }
+        }
+    }
+    
+    // Extended: each undecided cell takes at most one of its candidates
+    if (options->extended) {
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                int vars[9];
+                int n = 0;
+                for (int k = 1; k <= 9; k++) {
+                    if (var_map->var_index[i][j][k] != 0) {
+                        vars[n++] = var_map->var_index[i][j][k];
+                    }
+                }
+                if (n >= 2) {
+                    add_at_most_one(formula, vars, n, options->amo_encoding);
+                }
+            }
+        }
+    }
+    
+    return formula;
+}
+
+// Add every puzzle-independent clause of the standard encoding
+static void add_standard_constraints(Formula* formula, const PercentSudokuCnfOptions* options) {
+    add_basic_constraints(formula, options->amo_encoding);
+    add_diagonal_constraints(formula, options->amo_encoding);
+    add_window_constraints(formula, options->amo_encoding);
+    if (options->extended) {
+        add_unit_digit_constraints(formula);
+        add_cell_at_most_one_constraints(formula, options->amo_encoding);
+    }
+}
+
+// Convert Percent Sudoku puzzle to CNF formula (pairwise encoding)
 Formula* percent_sudoku_to_cnf(const PercentSudokuGrid* puzzle) {
-    if (puzzle == NULL) {
-        print_error("percent_sudoku_to_cnf", COMMON_ERROR_INVALID_PARAMETER, "Puzzle is NULL");
+    PercentSudokuCnfOptions options;
+    init_cnf_options(&options);
+    return percent_sudoku_to_cnf_with_options(puzzle, &options, NULL);
+}
+
+// Convert Percent Sudoku puzzle to CNF formula with the given encoding options.
+// var_map (optional for the standard encoding, required for the reduced one) receives the variable mapping.
+Formula* percent_sudoku_to_cnf_with_options(const PercentSudokuGrid* puzzle, const PercentSudokuCnfOptions* options,
+                                            PercentSudokuVarMap* var_map) {
+    if (puzzle == NULL || options == NULL) {
+        print_error("percent_sudoku_to_cnf", COMMON_ERROR_INVALID_PARAMETER, "Puzzle or options is NULL");
         return NULL;
     }
     
-    // Calculate number of clauses
+    if (options->reduced) {
+        if (var_map == NULL) {
+            print_error("percent_sudoku_to_cnf", COMMON_ERROR_INVALID_PARAMETER, "Reduced encoding needs a variable map");
+            return NULL;
+        }
+        return percent_sudoku_to_reduced_cnf(puzzle, options, var_map);
+    }
+    
+    if (var_map != NULL) {
+        init_standard_var_map(var_map);
+    }
+    
+    // Calculate number of clauses (exact for pairwise, the formula grows as needed for other encodings)
     int num_clauses = 0;
     
     // Cell constraints: 81 clauses (each cell at least one digit)
@@ -278,23 +585,88 @@ Formula* percent_sudoku_to_cnf(const PercentSudokuGrid* puzzle) {
     num_clauses += num_givens;
     
     // Create formula: 729 variables (9×9×9), calculated number of clauses
+    // Auxiliary variables of compact encodings are appended after variable 729
     Formula* formula = create_formula(729, num_clauses);
     if (formula == NULL) {
-        print_error("verify_percent_sudoku_cnf", COMMON_ERROR_INVALID_PARAMETER, "Formula is NULL");
-        return 0;
+        print_error("percent_sudoku_to_cnf", COMMON_ERROR_MEMORY_ALLOCATION, "Formula is NULL");
+        return NULL;
     }
     
     // Add all constraints
-    add_basic_constraints(formula);
-    add_diagonal_constraints(formula);
-    add_window_constraints(formula);
+    add_standard_constraints(formula, options);
     add_given_constraints(formula, puzzle);
     
     return formula;
 }
 
+// Shared base formulas, one per (AMO encoding, extended) combination, built on first use and kept for the process
+static pthread_mutex_t base_cnf_mutex = PTHREAD_MUTEX_INITIALIZER;
+static Formula* base_cnf[AMO_ENCODING_COUNT][2];
+
+// Get the shared base formula of the standard encoding: every constraint clause, no givens.
+// The formula is immutable and shared by all threads; the caller must not modify or free it.
+const Formula* get_percent_sudoku_base_cnf(const PercentSudokuCnfOptions* options) {
+    if (options == NULL || options->reduced ||
+        options->amo_encoding < 0 || options->amo_encoding >= AMO_ENCODING_COUNT) {
+        print_error("get_percent_sudoku_base_cnf", COMMON_ERROR_INVALID_PARAMETER,
+                    "Base formula needs the standard encoding");
+        return NULL;
+    }
+    
+    int extended = options->extended ? 1 : 0;
+    
+    pthread_mutex_lock(&base_cnf_mutex);
+    Formula* formula = base_cnf[options->amo_encoding][extended];
+    if (formula == NULL) {
+        formula = create_formula(729, 9 * 9 * 36 * 3 + 9 * 36 * 3 + 81);
+        if (formula != NULL) {
+            add_standard_constraints(formula, options);
+            base_cnf[options->amo_encoding][extended] = formula;
+        }
+    }
+    pthread_mutex_unlock(&base_cnf_mutex);
+    
+    if (formula == NULL) {
+        print_error("get_percent_sudoku_base_cnf", COMMON_ERROR_MEMORY_ALLOCATION, "Formula is NULL");
+    }
+    return formula;
+}
+
+// Instantiate the base formula for one puzzle: every variable unassigned except the givens,
+// which are assumed true (and the other digits of a given cell false). Returns the number of givens.
+int set_percent_sudoku_given_assumptions(const PercentSudokuGrid* puzzle, int* assignments, int num_vars) {
+    if (puzzle == NULL || assignments == NULL || num_vars < 729) {
+        print_error("set_percent_sudoku_given_assumptions", COMMON_ERROR_INVALID_PARAMETER, "Invalid parameter");
+        return -1;
+    }
+    
+    for (int i = 0; i < num_vars; i++) {
+        assignments[i] = UNASSIGNED;
+    }
+    
+    int num_givens = 0;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int given = puzzle->grid[i][j];
+            if (given == PERCENT_SUDOKU_EMPTY) continue;
+            for (int k = 1; k <= 9; k++) {
+                assignments[get_variable_index(i, j, k) - 1] = (k == given) ? TRUE : FALSE;
+            }
+            num_givens++;
+        }
+    }
+    
+    return num_givens;
+}
+
 // Restore Percent Sudoku from CNF solution
 PercentSudokuGrid* cnf_to_percent_sudoku(const Formula* formula, int* assignments, const PercentSudokuGrid* puzzle) {
+    return cnf_to_percent_sudoku_with_map(formula, assignments, puzzle, NULL);
+}
+
+// Restore Percent Sudoku from CNF solution through a variable map (NULL = standard encoding)
+PercentSudokuGrid* cnf_to_percent_sudoku_with_map(const Formula* formula, int* assignments, const PercentSudokuGrid* puzzle,
+                                                  const PercentSudokuVarMap* var_map) {
     if (formula == NULL || assignments == NULL || puzzle == NULL) {
         print_error("cnf_to_percent_sudoku", COMMON_ERROR_INVALID_PARAMETER, "One or more parameters are NULL");
         return NULL;
@@ -312,9 +684,13 @@ PercentSudokuGrid* cnf_to_percent_sudoku(const Formula* formula, int* assignment
     // Fill solution according to variable assignments
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
+            if (solution->grid[i][j] == PERCENT_SUDOKU_EMPTY && var_map != NULL && var_map->fixed[i][j] != PERCENT_SUDOKU_EMPTY) {
+                solution->grid[i][j] = var_map->fixed[i][j];  // Decided by presolve, no variable
+                continue;
+            }
             if (solution->grid[i][j] == PERCENT_SUDOKU_EMPTY) {
                 for (int k = 1; k <= 9; k++) {
-                    int var_index = get_variable_index(i, j, k);
+                    int var_index = (var_map != NULL) ? var_map->var_index[i][j][k] : get_variable_index(i, j, k);
                     if (var_index > 0 && var_index <= formula->num_vars) {
                         if (assignments[var_index - 1] == TRUE) {  // Variable index starts from 1, array from 0
                             solution->grid[i][j] = k;
@@ -335,9 +711,9 @@ int verify_percent_sudoku_cnf(const Formula* formula, const PercentSudokuGrid* p
         return 0;
     }
     
-    // Check variable count
-    if (formula->num_vars != 729) {
-        printf("Error: Expected 729 variables, got %d\n", formula->num_vars);
+    // Check variable count (compact encodings add auxiliary variables after 729)
+    if (formula->num_vars < 729) {
+        printf("Error: Expected at least 729 variables, got %d\n", formula->num_vars);
         return 0;
     }
     
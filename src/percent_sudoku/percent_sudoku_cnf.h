@@ -9,23 +9,74 @@
 // 变量编码规则：对于位置(i,j)的数字k，变量编号为 (i*9 + j)*9 + k
 // 其中 i,j 从0开始，k从1开始
 
+// 辅助变量（紧凑编码使用）从730开始依次分配
+
+// "至多一个"约束的编码方式
+typedef enum {
+    AMO_ENCODING_PAIRWISE,      // 两两互斥编码（默认，O(n^2)子句）
+    AMO_ENCODING_SEQUENTIAL,    // 顺序计数器编码（3n-4子句，n-1个辅助变量）
+    AMO_ENCODING_COMMANDER,     // 指挥官编码（每3个变量一组）
+    AMO_ENCODING_PRODUCT        // 乘积编码（约2n+4√n子句）
+} AmoEncoding;
+
+#define AMO_ENCODING_COUNT 4
+
+// CNF转换选项
+typedef struct {
+    AmoEncoding amo_encoding;   // "至多一个"约束的编码方式
+    int reduced;                // 优化编码：预处理给定数字，只为仍可能的(格,数字)分配变量
+    int extended;               // 扩展编码：每个单元每个数字至少出现一次、每格至多一个数字
+} PercentSudokuCnfOptions;
+
+// 变量映射：(行,列,数字) <-> 变量编号
+// 标准编码下与 get_variable_index 一致；优化编码下变量紧凑编号，
+// 已确定的格子不再分配变量，其值记录在 fixed 中
+typedef struct {
+    int num_cell_vars;                                                  // (格,数字)变量数量
+    int var_index[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_MAX_NUM + 1]; // 0表示无变量
+    int var_row[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_MAX_NUM + 1];
+    int var_col[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_MAX_NUM + 1];
+    int var_num[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_MAX_NUM + 1];
+    int fixed[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE];               // 预处理已确定的数字，0表示未定
+} PercentSudokuVarMap;
+
 // 函数声明
 
 // 基本CNF转换
 Formula* percent_sudoku_to_cnf(const PercentSudokuGrid* puzzle);
-void add_basic_constraints(Formula* formula);
-void add_diagonal_constraints(Formula* formula);
-void add_window_constraints(Formula* formula);
+Formula* percent_sudoku_to_cnf_with_options(const PercentSudokuGrid* puzzle, const PercentSudokuCnfOptions* options,
+                                            PercentSudokuVarMap* var_map);
+void init_cnf_options(PercentSudokuCnfOptions* options);
+
+// 共享基础公式：标准编码的约束子句与谜题无关，每种编码组合在首次使用时构建一次，
+// 之后所有谜题、所有线程共用（只读，调用者不得修改或释放）。
+// 每个谜题只需把给定数字作为假设写入赋值数组，再对基础公式运行DPLL。
+const Formula* get_percent_sudoku_base_cnf(const PercentSudokuCnfOptions* options);
+int set_percent_sudoku_given_assumptions(const PercentSudokuGrid* puzzle, int* assignments, int num_vars);
+
+const char* amo_encoding_name(AmoEncoding encoding);
+void add_basic_constraints(Formula* formula, AmoEncoding encoding);
+void add_diagonal_constraints(Formula* formula, AmoEncoding encoding);
+void add_window_constraints(Formula* formula, AmoEncoding encoding);
 void add_given_constraints(Formula* formula, const PercentSudokuGrid* puzzle);
 
 // 约束生成函数
+void add_at_most_one(Formula* formula, const int* vars, int n, AmoEncoding encoding);
 void add_cell_constraints(Formula* formula);
-void add_row_constraints(Formula* formula);
-void add_column_constraints(Formula* formula);
-void add_box_constraints(Formula* formula);
+void add_row_constraints(Formula* formula, AmoEncoding encoding);
+void add_column_constraints(Formula* formula, AmoEncoding encoding);
+void add_box_constraints(Formula* formula, AmoEncoding encoding);
+void add_unit_digit_constraints(Formula* formula);
+void add_cell_at_most_one_constraints(Formula* formula, AmoEncoding encoding);
 
 // 从CNF解还原百分号数独
 PercentSudokuGrid* cnf_to_percent_sudoku(const Formula* formula, int* assignments, const PercentSudokuGrid* puzzle);
+PercentSudokuGrid* cnf_to_percent_sudoku_with_map(const Formula* formula, int* assignments, const PercentSudokuGrid* puzzle,
+                                                  const PercentSudokuVarMap* var_map);
+
+// 优化编码的预处理：在网格层面根据给定数字消去候选，返回0表示发现矛盾
+int presolve_percent_sudoku_candidates(const PercentSudokuGrid* puzzle, int candidates[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE],
+                                       int fixed[PERCENT_SUDOKU_SIZE][PERCENT_SUDOKU_SIZE]);
 
 // 变量编码辅助函数
 int get_variable_index(int row, int col, int num);
@@ -1,13 +1,64 @@
 #include "percent_sudoku_core.h"
+#include "percent_sudoku_bitmask.h"
+#include <pthread.h>
 
 // 百分号数独特殊位置定义
 const int DIAGONAL_POSITIONS[9] = {19, 28, 37, 46, 55, 64, 73, 82, 91};
 const int UPPER_WINDOW_POSITIONS[9] = {22, 23, 24, 32, 33, 34, 42, 43, 44};
 const int LOWER_WINDOW_POSITIONS[9] = {66, 67, 68, 76, 77, 78, 86, 87, 88};
 
+// 全部约束单元（格子下标 row*9+col）
+const int PERCENT_SUDOKU_UNITS[PERCENT_SUDOKU_NUM_UNITS][9] = {
+    // 行 0-8
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8},
+    { 9, 10, 11, 12, 13, 14, 15, 16, 17},
+    {18, 19, 20, 21, 22, 23, 24, 25, 26},
+    {27, 28, 29, 30, 31, 32, 33, 34, 35},
+    {36, 37, 38, 39, 40, 41, 42, 43, 44},
+    {45, 46, 47, 48, 49, 50, 51, 52, 53},
+    {54, 55, 56, 57, 58, 59, 60, 61, 62},
+    {63, 64, 65, 66, 67, 68, 69, 70, 71},
+    {72, 73, 74, 75, 76, 77, 78, 79, 80},
+    // 列 0-8
+    { 0,  9, 18, 27, 36, 45, 54, 63, 72},
+    { 1, 10, 19, 28, 37, 46, 55, 64, 73},
+    { 2, 11, 20, 29, 38, 47, 56, 65, 74},
+    { 3, 12, 21, 30, 39, 48, 57, 66, 75},
+    { 4, 13, 22, 31, 40, 49, 58, 67, 76},
+    { 5, 14, 23, 32, 41, 50, 59, 68, 77},
+    { 6, 15, 24, 33, 42, 51, 60, 69, 78},
+    { 7, 16, 25, 34, 43, 52, 61, 70, 79},
+    { 8, 17, 26, 35, 44, 53, 62, 71, 80},
+    // 宫 0-8
+    { 0,  1,  2,  9, 10, 11, 18, 19, 20},
+    { 3,  4,  5, 12, 13, 14, 21, 22, 23},
+    { 6,  7,  8, 15, 16, 17, 24, 25, 26},
+    {27, 28, 29, 36, 37, 38, 45, 46, 47},
+    {30, 31, 32, 39, 40, 41, 48, 49, 50},
+    {33, 34, 35, 42, 43, 44, 51, 52, 53},
+    {54, 55, 56, 63, 64, 65, 72, 73, 74},
+    {57, 58, 59, 66, 67, 68, 75, 76, 77},
+    {60, 61, 62, 69, 70, 71, 78, 79, 80},
+    // 撇对角线、上方窗口、下方窗口
+    { 8, 16, 24, 32, 40, 48, 56, 64, 72},
+    {10, 11, 12, 19, 20, 21, 28, 29, 30},
+    {50, 51, 52, 59, 60, 61, 68, 69, 70}
+};
+
+// 网格对象池（批量求解时各线程共用，加锁访问）
+static MemoryPool grid_pool;
+static int grid_pool_ready = 0;
+static pthread_mutex_t grid_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 // 创建百分号数独网格
 PercentSudokuGrid* create_percent_sudoku_grid(void) {
-    PercentSudokuGrid* grid = (PercentSudokuGrid*)safe_malloc(sizeof(PercentSudokuGrid));
+    pthread_mutex_lock(&grid_pool_mutex);
+    if (!grid_pool_ready) {
+        pool_init(&grid_pool, MEMORY_SUDOKU, sizeof(PercentSudokuGrid), 64, 0);
+        grid_pool_ready = 1;
+    }
+    PercentSudokuGrid* grid = (PercentSudokuGrid*)pool_alloc(&grid_pool);
+    pthread_mutex_unlock(&grid_pool_mutex);
     
     // 初始化网格为空
     for (int i = 0; i < PERCENT_SUDOKU_SIZE; i++) {
@@ -23,16 +74,19 @@ PercentSudokuGrid* create_percent_sudoku_grid(void) {
 // 释放百分号数独网格内存
 void free_percent_sudoku_grid(PercentSudokuGrid* grid) {
     if (grid != NULL) {
-        safe_free(grid);
+        pthread_mutex_lock(&grid_pool_mutex);
+        pool_free(&grid_pool, grid);
+        pthread_mutex_unlock(&grid_pool_mutex);
     }
 }
 
 // 创建百分号数独游戏
 PercentSudokuGame* create_percent_sudoku_game(void) {
-    PercentSudokuGame* game = (PercentSudokuGame*)safe_malloc(sizeof(PercentSudokuGame));
+    PercentSudokuGame* game = (PercentSudokuGame*)tracked_malloc(MEMORY_SUDOKU, sizeof(PercentSudokuGame));
     
-    game->puzzle = *create_percent_sudoku_grid();
-    game->solution = *create_percent_sudoku_grid();
+    // 两个网格内嵌在结构体中，直接清空即可
+    memset(&game->puzzle, 0, sizeof(PercentSudokuGrid));
+    memset(&game->solution, 0, sizeof(PercentSudokuGrid));
     game->difficulty = 1;
     game->num_givens = 0;
     
@@ -177,7 +231,7 @@ int is_valid_placement(const PercentSudokuGrid* grid, int row, int col, int num)
            check_window_constraint(grid, row, col, num);
 }
 
-// 递归求解百分号数独
+// 递归求解百分号数独（按行优先顺序的基础回溯，保留作对照）
 int solve_percent_sudoku_recursive(PercentSudokuGrid* grid, int row, int col) {
     // 如果到达最后一行的下一行，说明求解完成
     if (row == PERCENT_SUDOKU_SIZE) {
@@ -210,17 +264,31 @@ int solve_percent_sudoku_recursive(PercentSudokuGrid* grid, int row, int col) {
     return 0;  // 无解
 }
 
-// 求解百分号数独
+// 求解百分号数独（位掩码候选集 + MRV 求解器）
 int solve_percent_sudoku(PercentSudokuGrid* grid) {
     if (grid == NULL) {
         return 0;
     }
-    return solve_percent_sudoku_recursive(grid, 0, 0);
+    return solve_percent_sudoku_bitmask(grid);
+}
+
+// 用全局随机数（rand）给一个生成器设置种子，兼容 srand 的调用方式
+static void seed_rng_from_rand(Rng* rng) {
+    uint64_t seed = ((uint64_t)(unsigned int)rand() << 32) ^ (uint64_t)(unsigned int)rand();
+    rng_seed(rng, seed);
 }
 
-// 生成完整的百分号数独
+// 生成完整的百分号数独（随机性来自全局 rand）
 void generate_complete_percent_sudoku(PercentSudokuGrid* grid) {
-    if (grid == NULL) {
+    Rng rng;
+    seed_rng_from_rand(&rng);
+    generate_random_complete_percent_sudoku(grid, &rng);
+}
+
+// 用指定的随机数生成器生成随机的完整解答
+// 在位掩码求解器上随机化分支格子与数字顺序，推理仍照常进行，因此很快就能填满
+void generate_random_complete_percent_sudoku(PercentSudokuGrid* grid, Rng* rng) {
+    if (grid == NULL || rng == NULL) {
         return;
     }
     
@@ -231,12 +299,18 @@ void generate_complete_percent_sudoku(PercentSudokuGrid* grid) {
         }
     }
     
-    // 使用回溯算法生成完整数独
-    solve_percent_sudoku(grid);
+    solve_percent_sudoku_bitmask_random(grid, rng);
 }
 
-// 生成百分号数独谜题
+// 生成百分号数独谜题（随机性来自全局 rand，由调用方 srand 决定）
 PercentSudokuGame* generate_percent_sudoku_puzzle(int difficulty) {
+    Rng rng;
+    seed_rng_from_rand(&rng);
+    return generate_percent_sudoku_puzzle_with_rng(difficulty, &rng);
+}
+
+// 用指定的随机数生成器生成谜题，不访问全局状态，可在多线程中并行调用
+PercentSudokuGame* generate_percent_sudoku_puzzle_with_rng(int difficulty, Rng* rng) {
     PercentSudokuGame* game = create_percent_sudoku_game();
     if (game == NULL) {
         print_error("generate_percent_sudoku_puzzle", COMMON_ERROR_INVALID_PARAMETER, "Game is NULL");
@@ -245,14 +319,14 @@ PercentSudokuGame* generate_percent_sudoku_puzzle(int difficulty) {
     
     game->difficulty = difficulty;
     
-    // 生成完整解答
-    generate_complete_percent_sudoku(&game->solution);
+    // 生成随机的完整解答
+    generate_random_complete_percent_sudoku(&game->solution, rng);
     
     // 复制解答到谜题
     copy_percent_sudoku_grid(&game->solution, &game->puzzle);
     
     // 根据难度移除数字
-    remove_numbers_for_puzzle(&game->puzzle, &game->solution, difficulty);
+    remove_numbers_with_rng(&game->puzzle, difficulty, rng);
     
     // 计算给定数字数量
     game->num_givens = 0;
@@ -271,6 +345,13 @@ PercentSudokuGame* generate_percent_sudoku_puzzle(int difficulty) {
 // 根据难度移除数字创建谜题
 void remove_numbers_for_puzzle(PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int difficulty) {
     (void)solution; // Suppress unused parameter warning
+    Rng rng;
+    seed_rng_from_rand(&rng);
+    remove_numbers_with_rng(puzzle, difficulty, &rng);
+}
+
+// 按rng给出的随机顺序移除数字，保持解唯一
+void remove_numbers_with_rng(PercentSudokuGrid* puzzle, int difficulty, Rng* rng) {
     int num_to_remove;
     
     // 根据难度确定要移除的数字数量
@@ -289,14 +370,8 @@ void remove_numbers_for_puzzle(PercentSudokuGrid* puzzle, PercentSudokuGrid* sol
         positions[i] = i;
     }
     
-    // 随机打乱位置
-    srand(time(NULL));
-    for (int i = 80; i > 0; i--) {
-        int j = rand() % (i + 1);
-        int temp = positions[i];
-        positions[i] = positions[j];
-        positions[j] = temp;
-    }
+    // 随机打乱位置（相同种子得到相同的谜题）
+    shuffle_array_with_rng(positions, 81, rng);
     
     // 移除数字
     int removed = 0;
@@ -355,19 +430,13 @@ int is_valid_percent_sudoku(const PercentSudokuGrid* grid) {
     return 1;
 }
 
-// 计算解的个数
+// 计算解的个数（只需区分0、1、多解，最多计到2）
 int count_solutions(const PercentSudokuGrid* grid) {
     if (grid == NULL) {
         return 0;
     }
     
-    PercentSudokuGrid temp_grid;
-    copy_percent_sudoku_grid(grid, &temp_grid);
-    
-    int solutions = 0;
-    count_solutions_recursive(&temp_grid, 0, 0, &solutions);
-    
-    return solutions;
+    return count_percent_sudoku_solutions_bitmask(grid, 2);
 }
 
 // 递归计算解的个数
@@ -420,18 +489,35 @@ void shuffle_array(int* array, int size) {
     }
 }
 
+// 用指定的随机数生成器打乱数组
+void shuffle_array_with_rng(int* array, int size, Rng* rng) {
+    for (int i = size - 1; i > 0; i--) {
+        int j = rng_range(rng, i + 1);
+        int temp = array[i];
+        array[i] = array[j];
+        array[j] = temp;
+    }
+}
+
 // 注意：显示相关函数已移至 display 模块
 
 // 保存百分号数独到文件
 void save_percent_sudoku_to_file(const PercentSudokuGame* game, const char* filename) {
+    if (write_percent_sudoku_file(game, filename)) {
+        printf("Percent Sudoku saved to: %s\n", filename);
+    }
+}
+
+// 写出 .percent_sudoku 文件（不打印提示，供批量导出使用），成功返回1
+int write_percent_sudoku_file(const PercentSudokuGame* game, const char* filename) {
     if (game == NULL || filename == NULL) {
-        return;
+        return 0;
     }
     
     FILE* file = fopen(filename, "w");
     if (file == NULL) {
         print_error("save_percent_sudoku_grid", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open file for writing");
-        return;
+        return 0;
     }
     
     fprintf(file, "# Percent Sudoku Game File\n");
@@ -454,8 +540,12 @@ void save_percent_sudoku_to_file(const PercentSudokuGame* game, const char* file
         fprintf(file, "\n");
     }
     
-    fclose(file);
-    printf("Percent Sudoku saved to: %s\n", filename);
+    int ok = !ferror(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        print_error("save_percent_sudoku_grid", COMMON_ERROR_UNKNOWN, "Failed to write file");
+    }
+    return ok;
 }
 
 // 从文件加载百分号数独
@@ -521,6 +611,40 @@ PercentSudokuGame* load_percent_sudoku_from_file(const char* filename) {
     return game;
 }
 
+// 解析单行格式的谜题，成功返回1
+int parse_percent_sudoku_line(const char* line, PercentSudokuGrid* grid) {
+    if (line == NULL || grid == NULL) {
+        return 0;
+    }
+    
+    for (int cell = 0; cell < PERCENT_SUDOKU_LINE_LENGTH; cell++) {
+        char ch = line[cell];
+        int row = cell / PERCENT_SUDOKU_SIZE;
+        int col = cell % PERCENT_SUDOKU_SIZE;
+        
+        if (ch >= '1' && ch <= '9') {
+            grid->grid[row][col] = ch - '0';
+            grid->is_given[row][col] = 1;
+        } else if (ch == '0' || ch == '.') {
+            grid->grid[row][col] = PERCENT_SUDOKU_EMPTY;
+            grid->is_given[row][col] = 0;
+        } else {
+            return 0;  // 非法字符或行过短
+        }
+    }
+    
+    return 1;
+}
+
+// 将网格格式化为单行（空格写作'0'）
+void format_percent_sudoku_line(const PercentSudokuGrid* grid, char line[PERCENT_SUDOKU_LINE_LENGTH + 1]) {
+    for (int cell = 0; cell < PERCENT_SUDOKU_LINE_LENGTH; cell++) {
+        int num = grid->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+        line[cell] = (num >= PERCENT_SUDOKU_MIN_NUM && num <= PERCENT_SUDOKU_MAX_NUM) ? (char)('0' + num) : '0';
+    }
+    line[PERCENT_SUDOKU_LINE_LENGTH] = '\0';
+}
+
 // 控制台显示函数实现
 void print_percent_sudoku_console(PercentSudokuGrid* grid, int show_constraints) {
     if (grid == NULL) {
@@ -12,6 +12,7 @@
 #define PERCENT_SUDOKU_EMPTY 0
 #define PERCENT_SUDOKU_MIN_NUM 1
 #define PERCENT_SUDOKU_MAX_NUM 9
+#define PERCENT_SUDOKU_NUM_UNITS 30   // 9行 + 9列 + 9宫 + 撇对角线 + 2个窗口
 
 // 百分号数独网格结构
 typedef struct {
@@ -65,14 +66,18 @@ int check_box_constraint(const PercentSudokuGrid* grid, int row, int col, int nu
 int check_diagonal_constraint(const PercentSudokuGrid* grid, int row, int col, int num);
 int check_window_constraint(const PercentSudokuGrid* grid, int row, int col, int num);
 
-// 百分号数独求解（基础回溯算法）
+// 百分号数独求解（solve_percent_sudoku 使用位掩码 + MRV 求解器，_recursive 为基础回溯算法）
 int solve_percent_sudoku(PercentSudokuGrid* grid);
 int solve_percent_sudoku_recursive(PercentSudokuGrid* grid, int row, int col);
 
 // 百分号数独生成
+// （_with_rng 版本只使用传入的随机数生成器，可在多线程中并行调用）
 PercentSudokuGame* generate_percent_sudoku_puzzle(int difficulty);
+PercentSudokuGame* generate_percent_sudoku_puzzle_with_rng(int difficulty, Rng* rng);
 void generate_complete_percent_sudoku(PercentSudokuGrid* grid);
+void generate_random_complete_percent_sudoku(PercentSudokuGrid* grid, Rng* rng);
 void remove_numbers_for_puzzle(PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int difficulty);
+void remove_numbers_with_rng(PercentSudokuGrid* puzzle, int difficulty, Rng* rng);
 
 // 百分号数独验证
 int is_complete_percent_sudoku(const PercentSudokuGrid* grid);
@@ -81,8 +86,14 @@ int has_unique_solution(const PercentSudokuGrid* grid);
 
 // 文件I/O
 void save_percent_sudoku_to_file(const PercentSudokuGame* game, const char* filename);
+int write_percent_sudoku_file(const PercentSudokuGame* game, const char* filename);  // 不打印提示，成功返回1
 PercentSudokuGame* load_percent_sudoku_from_file(const char* filename);
 
+// 单行格式：81个字符按行优先排列，'1'-'9'为给定数字，'0'或'.'为空格
+#define PERCENT_SUDOKU_LINE_LENGTH 81
+int parse_percent_sudoku_line(const char* line, PercentSudokuGrid* grid);
+void format_percent_sudoku_line(const PercentSudokuGrid* grid, char line[PERCENT_SUDOKU_LINE_LENGTH + 1]);
+
 // 控制台显示
 void print_percent_sudoku_console(PercentSudokuGrid* grid, int show_constraints);
 void print_percent_sudoku_game_console(PercentSudokuGame* game, int show_solution, int show_constraints);
@@ -90,6 +101,7 @@ void print_percent_sudoku_game_console(PercentSudokuGame* game, int show_solutio
 // 工具函数
 int get_random_number(int min, int max);
 void shuffle_array(int* array, int size);
+void shuffle_array_with_rng(int* array, int size, Rng* rng);
 int count_solutions(const PercentSudokuGrid* grid);
 void count_solutions_recursive(PercentSudokuGrid* grid, int row, int col, int* count);
 
@@ -103,4 +115,8 @@ extern const int UPPER_WINDOW_POSITIONS[9];
 // 下方窗口位置编码: 66, 67, 68, 76, 77, 78, 86, 87, 88
 extern const int LOWER_WINDOW_POSITIONS[9];
 
+// 全部约束单元：0-8为行，9-17为列，18-26为宫，27为撇对角线，28、29为上、下窗口
+// 每个单元列出9个格子的下标 (row*9+col)
+extern const int PERCENT_SUDOKU_UNITS[PERCENT_SUDOKU_NUM_UNITS][9];
+
 #endif // PERCENT_SUDOKU_CORE_H
@@ -0,0 +1,443 @@
+#include "percent_sudoku_db.h"
+#include "percent_sudoku_io.h"
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#endif
+
+#define PSDB_STAGED_BYTES (2 * PSDB_GRID_BYTES)
+
+// 小端序读写
+static void put_u16(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+}
+
+static void put_u32(unsigned char* out, unsigned int value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (unsigned char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+static unsigned int get_u16(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8);
+}
+
+static unsigned int get_u32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8) | ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+// 把网格打包成41字节（偶数格在低4位）
+static void pack_grid(const PercentSudokuGrid* grid, unsigned char* out) {
+    memset(out, 0, PSDB_GRID_BYTES);
+    for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+        int num = grid->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+        if (num < PERCENT_SUDOKU_MIN_NUM || num > PERCENT_SUDOKU_MAX_NUM) {
+            num = PERCENT_SUDOKU_EMPTY;
+        }
+        out[cell >> 1] |= (unsigned char)(num << ((cell & 1) * 4));
+    }
+}
+
+static int packed_cell(const unsigned char* packed, int cell) {
+    return (packed[cell >> 1] >> ((cell & 1) * 4)) & 0xF;
+}
+
+// ==================== 读取 ====================
+
+// 打开谜题库并校验文件头，成功返回1
+int open_puzzle_database(const char* filename, PuzzleDatabase* db) {
+    if (filename == NULL || db == NULL) {
+        return 0;
+    }
+    
+    memset(db, 0, sizeof(PuzzleDatabase));
+    if (!map_file_readonly(filename, &db->file)) {
+        print_error("open_puzzle_database", COMMON_ERROR_FILE_NOT_FOUND, "Cannot map database file");
+        return 0;
+    }
+    
+    const unsigned char* header = (const unsigned char*)db->file.data;
+    if (db->file.size < PSDB_HEADER_SIZE || memcmp(header, PSDB_MAGIC, 4) != 0) {
+        print_error("open_puzzle_database", COMMON_ERROR_INVALID_PARAMETER, "Not a puzzle database file");
+        close_puzzle_database(db);
+        return 0;
+    }
+    
+    db->version = get_u16(header + 4);
+    db->flags = get_u16(header + 6);
+    db->record_size = get_u32(header + 8);
+    db->num_puzzles = get_u32(header + 12);
+    
+    unsigned int expected_size = (db->flags & PSDB_FLAG_SOLUTIONS) ? PSDB_GRID_BYTES + PSDB_MASK_BYTES : PSDB_GRID_BYTES;
+    if (db->version != PSDB_VERSION || db->record_size != expected_size ||
+        (db->file.size - PSDB_HEADER_SIZE) / db->record_size < db->num_puzzles) {
+        print_error("open_puzzle_database", COMMON_ERROR_INVALID_PARAMETER, "Unsupported or truncated database file");
+        close_puzzle_database(db);
+        return 0;
+    }
+    
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        db->index[d].first = get_u32(header + 16 + 8 * d);
+        db->index[d].count = get_u32(header + 20 + 8 * d);
+        if (db->index[d].first > db->num_puzzles || db->index[d].count > db->num_puzzles - db->index[d].first) {
+            print_error("open_puzzle_database", COMMON_ERROR_INVALID_PARAMETER, "Corrupt difficulty index");
+            close_puzzle_database(db);
+            return 0;
+        }
+    }
+    
+    db->records = header + PSDB_HEADER_SIZE;
+    return 1;
+}
+
+// 关闭谜题库
+void close_puzzle_database(PuzzleDatabase* db) {
+    if (db != NULL) {
+        unmap_file(&db->file);
+        db->records = NULL;
+        db->num_puzzles = 0;
+    }
+}
+
+// 读取第index个谜题（含难度与可选的解答），成功返回1；越界或记录损坏返回0
+int get_database_puzzle(const PuzzleDatabase* db, unsigned int index, PercentSudokuGame* game) {
+    if (db == NULL || game == NULL || db->records == NULL || index >= db->num_puzzles) {
+        return 0;
+    }
+    
+    const unsigned char* record = db->records + (size_t)index * db->record_size;
+    int has_solutions = (db->flags & PSDB_FLAG_SOLUTIONS) != 0;
+    const unsigned char* mask = record + PSDB_GRID_BYTES;
+    
+    memset(&game->puzzle, 0, sizeof(PercentSudokuGrid));
+    memset(&game->solution, 0, sizeof(PercentSudokuGrid));
+    game->num_givens = 0;
+    
+    for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+        int row = cell / PERCENT_SUDOKU_SIZE;
+        int col = cell % PERCENT_SUDOKU_SIZE;
+        int num = packed_cell(record, cell);
+        int given;
+        
+        // 4位能表示10-15，这些值不是合法数字，说明记录已损坏
+        if (num > PERCENT_SUDOKU_MAX_NUM) {
+            print_error("get_database_puzzle", COMMON_ERROR_INVALID_PARAMETER, "Corrupt database record");
+            return 0;
+        }
+        
+        if (has_solutions) {
+            game->solution.grid[row][col] = num;
+            given = (mask[cell >> 3] >> (cell & 7)) & 1;
+        } else {
+            given = num != PERCENT_SUDOKU_EMPTY;
+        }
+        
+        if (given) {
+            game->puzzle.grid[row][col] = num;
+            game->puzzle.is_given[row][col] = 1;
+            game->num_givens++;
+        }
+    }
+    
+    game->difficulty = 0;
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        if (index >= db->index[d].first && index < db->index[d].first + db->index[d].count) {
+            game->difficulty = d;
+            break;
+        }
+    }
+    
+    return 1;
+}
+
+// 读取某个难度的第n个谜题，成功返回1
+int get_database_puzzle_by_difficulty(const PuzzleDatabase* db, int difficulty, unsigned int n, PercentSudokuGame* game) {
+    if (db == NULL || difficulty < 0 || difficulty >= PSDB_NUM_DIFFICULTIES || n >= db->index[difficulty].count) {
+        return 0;
+    }
+    return get_database_puzzle(db, db->index[difficulty].first + n, game);
+}
+
+// 打印谜题库信息
+void print_database_info(const PuzzleDatabase* db) {
+    if (db == NULL) {
+        return;
+    }
+    
+    printf("=== Puzzle Database ===\n");
+    printf("Version: %u\n", db->version);
+    printf("Puzzles: %u\n", db->num_puzzles);
+    printf("Solutions: %s\n", (db->flags & PSDB_FLAG_SOLUTIONS) ? "yes" : "no");
+    printf("Record size: %u bytes\n", db->record_size);
+    printf("File size: %zu bytes\n", db->file.size);
+    printf("Difficulty index:\n");
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        if (db->index[d].count == 0) {
+            continue;
+        }
+        if (d == 0) {
+            printf("  unknown       first %-10u count %u\n", db->index[d].first, db->index[d].count);
+        } else {
+            printf("  difficulty %d  first %-10u count %u\n", d, db->index[d].first, db->index[d].count);
+        }
+    }
+    printf("=======================\n");
+}
+
+// ==================== 写出 ====================
+
+// 初始化打包暂存区
+void init_psdb_builder(PsdbBuilder* builder) {
+    if (builder != NULL) {
+        memset(builder, 0, sizeof(PsdbBuilder));
+        builder->all_have_solutions = 1;
+    }
+}
+
+// 加入一个谜题（solution可为NULL，超出范围的难度记为0），成功返回1
+// 含解答的记录只存解答与给定位图，谜题由解答还原，因此给定数字与解答不符的谜题被拒绝
+int add_psdb_puzzle(PsdbBuilder* builder, const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution, int difficulty) {
+    if (builder == NULL || puzzle == NULL) {
+        return 0;
+    }
+    
+    if (solution != NULL) {
+        for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+            int given = puzzle->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+            if (given != PERCENT_SUDOKU_EMPTY && given != solution->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE]) {
+                builder->rejected++;
+                return 0;
+            }
+        }
+    }
+    
+    int d = (difficulty >= 0 && difficulty < PSDB_NUM_DIFFICULTIES) ? difficulty : 0;
+    if (builder->count[d] == builder->capacity[d]) {
+        builder->capacity[d] = builder->capacity[d] > 0 ? builder->capacity[d] * 2 : 1024;
+        builder->entries[d] = (unsigned char*)tracked_realloc(MEMORY_SUDOKU, builder->entries[d],
+                                                              (size_t)builder->capacity[d] * PSDB_STAGED_BYTES);
+    }
+    
+    unsigned char* entry = builder->entries[d] + (size_t)builder->count[d] * PSDB_STAGED_BYTES;
+    pack_grid(puzzle, entry);
+    if (solution != NULL) {
+        pack_grid(solution, entry + PSDB_GRID_BYTES);
+    } else {
+        memset(entry + PSDB_GRID_BYTES, 0, PSDB_GRID_BYTES);
+        builder->all_have_solutions = 0;
+    }
+    builder->count[d]++;
+    return 1;
+}
+
+// 写出谜题库，返回写出的谜题数（失败返回-1）
+int write_puzzle_database(PsdbBuilder* builder, const char* filename, int include_solutions) {
+    if (builder == NULL || filename == NULL) {
+        return -1;
+    }
+    
+    if (include_solutions && !builder->all_have_solutions) {
+        printf("Warning: Some puzzles have no solution, writing puzzles only\n");
+        include_solutions = 0;
+    }
+    
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        print_error("write_puzzle_database", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open database file for writing");
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, 1 << 16);
+    
+    // 文件头
+    unsigned char header[PSDB_HEADER_SIZE];
+    unsigned int total = 0;
+    memset(header, 0, sizeof(header));
+    memcpy(header, PSDB_MAGIC, 4);
+    put_u16(header + 4, PSDB_VERSION);
+    put_u16(header + 6, include_solutions ? PSDB_FLAG_SOLUTIONS : 0);
+    put_u32(header + 8, include_solutions ? PSDB_GRID_BYTES + PSDB_MASK_BYTES : PSDB_GRID_BYTES);
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        put_u32(header + 16 + 8 * d, total);
+        put_u32(header + 20 + 8 * d, builder->count[d]);
+        total += builder->count[d];
+    }
+    put_u32(header + 12, total);
+    fwrite(header, 1, sizeof(header), file);
+    
+    // 记录（按难度顺序）
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        for (unsigned int i = 0; i < builder->count[d]; i++) {
+            const unsigned char* entry = builder->entries[d] + (size_t)i * PSDB_STAGED_BYTES;
+            
+            if (!include_solutions) {
+                fwrite(entry, 1, PSDB_GRID_BYTES, file);
+                continue;
+            }
+            
+            unsigned char mask[PSDB_MASK_BYTES];
+            memset(mask, 0, sizeof(mask));
+            for (int cell = 0; cell < PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE; cell++) {
+                if (packed_cell(entry, cell) != PERCENT_SUDOKU_EMPTY) {
+                    mask[cell >> 3] |= (unsigned char)(1 << (cell & 7));
+                }
+            }
+            fwrite(entry + PSDB_GRID_BYTES, 1, PSDB_GRID_BYTES, file);
+            fwrite(mask, 1, sizeof(mask), file);
+        }
+    }
+    
+    int ok = !ferror(file);
+    fclose(file);
+    if (!ok) {
+        print_error("write_puzzle_database", COMMON_ERROR_UNKNOWN, "Failed to write database file");
+        return -1;
+    }
+    
+    return (int)total;
+}
+
+// 释放暂存区
+void free_psdb_builder(PsdbBuilder* builder) {
+    if (builder == NULL) {
+        return;
+    }
+    for (int d = 0; d < PSDB_NUM_DIFFICULTIES; d++) {
+        safe_free(builder->entries[d]);
+    }
+    memset(builder, 0, sizeof(PsdbBuilder));
+}
+
+// ==================== 转换工具 ====================
+
+// 把 .percent_sudoku 目录或单行格式文件打包为谜题库，返回打包的谜题数（失败返回-1）
+// 单行格式不记录难度，其中的谜题统一记为line_difficulty（0表示未知）
+int pack_puzzle_database(const char* input_path, const char* output_file, int include_solutions, int line_difficulty) {
+    if (input_path == NULL || output_file == NULL) {
+        return -1;
+    }
+    
+    struct stat input_stat;
+    if (stat(input_path, &input_stat) != 0) {
+        print_error("pack_puzzle_database", COMMON_ERROR_FILE_NOT_FOUND, "Input path does not exist");
+        return -1;
+    }
+    
+    PsdbBuilder builder;
+    init_psdb_builder(&builder);
+    
+    if (S_ISDIR(input_stat.st_mode)) {
+        // 目录：通过现有的加载函数读取，保留难度
+        char** paths = NULL;
+        int num_files = list_percent_sudoku_files(input_path, &paths);
+        if (num_files < 0) {
+            return -1;
+        }
+        
+        for (int i = 0; i < num_files; i++) {
+            PercentSudokuGame* game = load_percent_sudoku_from_file(paths[i]);
+            if (game == NULL) {
+                continue;
+            }
+            int has_solution = is_complete_percent_sudoku(&game->solution);
+            add_psdb_puzzle(&builder, &game->puzzle, has_solution ? &game->solution : NULL, game->difficulty);
+            free_percent_sudoku_game(game);
+        }
+        free_file_list(paths, num_files);
+    } else {
+        // 单行格式文件
+        PuzzleLineReader reader;
+        if (!open_puzzle_reader(&reader, input_path)) {
+            return -1;
+        }
+        
+        PercentSudokuGrid puzzle, solution;
+        int has_solution, status;
+        while ((status = read_next_puzzle(&reader, &puzzle, &solution, &has_solution)) != PUZZLE_READ_END) {
+            if (status == PUZZLE_READ_OK) {
+                add_psdb_puzzle(&builder, &puzzle, has_solution ? &solution : NULL, line_difficulty);
+            }
+        }
+        close_puzzle_reader(&reader);
+    }
+    
+    if (builder.rejected > 0) {
+        fprintf(stderr, "Warning: Skipped %u puzzles whose givens disagree with their solution\n", builder.rejected);
+    }
+    
+    int written = write_puzzle_database(&builder, output_file, include_solutions);
+    free_psdb_builder(&builder);
+    return written;
+}
+
+// 把每条记录写成目录中的 .percent_sudoku 文件（按序号命名，补零使文件名顺序与序号一致），
+// 返回写出的谜题数（失败返回-1）
+static int unpack_to_directory(const PuzzleDatabase* db, const char* dir_path) {
+    struct stat dir_stat;
+    if (stat(dir_path, &dir_stat) != 0 && mkdir(dir_path, 0755) != 0) {
+        print_error("unpack_puzzle_database", COMMON_ERROR_FILE_NOT_FOUND, "Cannot create output directory");
+        return -1;
+    }
+    
+    int width = 6;
+    for (unsigned int n = db->num_puzzles / 1000000; n > 0; n /= 10) {
+        width++;
+    }
+    
+    size_t dir_length = strlen(dir_path);
+    const char* separator = (dir_length > 0 && dir_path[dir_length - 1] == '/') ? "" : "/";
+    char path[MAX_PATH_LENGTH];
+    PercentSudokuGame game;
+    for (unsigned int i = 0; i < db->num_puzzles; i++) {
+        int length = snprintf(path, sizeof(path), "%s%spuzzle_%0*u%s", dir_path, separator, width, i,
+                              PERCENT_SUDOKU_FILE_EXTENSION);
+        if (length < 0 || (size_t)length >= sizeof(path)) {
+            print_error("unpack_puzzle_database", COMMON_ERROR_INVALID_PARAMETER, "Output path is too long");
+            return -1;
+        }
+        if (!get_database_puzzle(db, i, &game) || !write_percent_sudoku_file(&game, path)) {
+            return -1;
+        }
+    }
+    return (int)db->num_puzzles;
+}
+
+// 把谜题库解包为单行格式文件或 .percent_sudoku 文件目录，返回写出的谜题数（失败返回-1）
+int unpack_puzzle_database(const char* db_file, const char* output_path) {
+    PuzzleDatabase db;
+    if (!open_puzzle_database(db_file, &db)) {
+        return -1;
+    }
+    
+    struct stat output_stat;
+    size_t output_length = output_path != NULL ? strlen(output_path) : 0;
+    if (output_path != NULL && ((stat(output_path, &output_stat) == 0 && S_ISDIR(output_stat.st_mode)) ||
+                                (output_length > 0 && output_path[output_length - 1] == '/'))) {
+        int count = unpack_to_directory(&db, output_path);
+        close_puzzle_database(&db);
+        return count;
+    }
+    
+    PuzzleLineWriter* writer = open_puzzle_writer(output_path);
+    if (writer == NULL) {
+        close_puzzle_database(&db);
+        return -1;
+    }
+    
+    PercentSudokuGame game;
+    int count = (int)db.num_puzzles;
+    int has_solutions = (db.flags & PSDB_FLAG_SOLUTIONS) != 0;
+    for (unsigned int i = 0; i < db.num_puzzles; i++) {
+        if (!get_database_puzzle(&db, i, &game)) {
+            count = -1;
+            break;
+        }
+        write_puzzle_line(writer, &game.puzzle, has_solutions ? &game.solution : NULL);
+    }
+    
+    int written = close_puzzle_writer(writer);
+    close_puzzle_database(&db);
+    return written ? count : -1;
+}
@@ -0,0 +1,75 @@
+#ifndef PERCENT_SUDOKU_DB_H
+#define PERCENT_SUDOKU_DB_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// 打包的二进制谜题库（.psdb）
+// 文件头（64字节，小端序）：
+//   0   "PSDB"                 魔数
+//   4   u16 版本号             当前为1
+//   6   u16 标志               bit0: 含解答
+//   8   u32 记录大小
+//   12  u32 谜题总数
+//   16  6 x (u32 起始序号, u32 数量)   难度0-5的索引（0表示难度未知）
+// 记录按难度排序，紧接文件头存放，第N条记录位于 64 + N * 记录大小：
+//   不含解答：41字节，81个格子各占4位（0为空格）
+//   含解答：  41字节解答 + 11字节给定数字位图（谜题 = 解答中给定的格子）
+// 读取时映射整个文件，按序号直接定位，无需扫描。
+
+#define PSDB_MAGIC "PSDB"
+#define PSDB_VERSION 1
+#define PSDB_FLAG_SOLUTIONS 0x1
+#define PSDB_HEADER_SIZE 64
+#define PSDB_NUM_DIFFICULTIES 6
+#define PSDB_GRID_BYTES 41          // 81个4位格子
+#define PSDB_MASK_BYTES 11          // 81位给定数字位图
+#define PSDB_EXTENSION ".psdb"
+
+// 难度索引项
+typedef struct {
+    unsigned int first;             // 该难度第一条记录的序号
+    unsigned int count;             // 该难度的记录数量
+} PsdbIndexEntry;
+
+// 打开的谜题库
+typedef struct {
+    MappedFile file;
+    unsigned int version;
+    unsigned int flags;
+    unsigned int record_size;
+    unsigned int num_puzzles;
+    PsdbIndexEntry index[PSDB_NUM_DIFFICULTIES];
+    const unsigned char* records;
+} PuzzleDatabase;
+
+// 打包时的暂存区（按难度分桶）
+typedef struct {
+    unsigned char* entries[PSDB_NUM_DIFFICULTIES];  // 每项：谜题41字节 + 解答41字节
+    unsigned int count[PSDB_NUM_DIFFICULTIES];
+    unsigned int capacity[PSDB_NUM_DIFFICULTIES];
+    int all_have_solutions;
+    unsigned int rejected;                          // 给定数字与解答不符而被拒绝的谜题数
+} PsdbBuilder;
+
+// 函数声明
+
+// 读取
+int open_puzzle_database(const char* filename, PuzzleDatabase* db);
+void close_puzzle_database(PuzzleDatabase* db);
+int get_database_puzzle(const PuzzleDatabase* db, unsigned int index, PercentSudokuGame* game);
+int get_database_puzzle_by_difficulty(const PuzzleDatabase* db, int difficulty, unsigned int n, PercentSudokuGame* game);
+void print_database_info(const PuzzleDatabase* db);
+
+// 写出
+void init_psdb_builder(PsdbBuilder* builder);
+int add_psdb_puzzle(PsdbBuilder* builder, const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution, int difficulty);
+int write_puzzle_database(PsdbBuilder* builder, const char* filename, int include_solutions);
+void free_psdb_builder(PsdbBuilder* builder);
+
+// 转换工具（与 .percent_sudoku 目录及单行格式文件互转）
+// 解包目标为已有目录或以'/'结尾时，每条记录写成目录中的一个 .percent_sudoku 文件，否则写成单行格式文件
+int pack_puzzle_database(const char* input_path, const char* output_file, int include_solutions, int line_difficulty);
+int unpack_puzzle_database(const char* db_file, const char* output_path);
+
+#endif // PERCENT_SUDOKU_DB_H
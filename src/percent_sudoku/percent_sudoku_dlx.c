@@ -0,0 +1,247 @@
+#include "percent_sudoku_dlx.h"
+
+// 每个线程的共享求解器（首次使用时构建）
+static THREAD_LOCAL DlxSolver* shared_dlx_solver = NULL;
+
+// 向列c的底部追加节点
+static void append_to_column(DlxSolver* solver, int node, int c) {
+    solver->column[node] = c;
+    solver->up[node] = solver->up[c];
+    solver->down[node] = c;
+    solver->down[solver->up[c]] = node;
+    solver->up[c] = node;
+    solver->size[c]++;
+}
+
+// 构建精确覆盖矩阵
+DlxSolver* create_dlx_solver(void) {
+    DlxSolver* solver = (DlxSolver*)tracked_malloc(MEMORY_SUDOKU, sizeof(DlxSolver));
+    memset(solver, 0, sizeof(DlxSolver));
+    
+    // 列头与根节点组成环形链表
+    for (int c = 0; c <= DLX_ROOT; c++) {
+        solver->left[c] = (c == 0) ? DLX_ROOT : c - 1;
+        solver->right[c] = (c == DLX_ROOT) ? 0 : c + 1;
+        solver->up[c] = c;
+        solver->down[c] = c;
+        solver->column[c] = c;
+    }
+    solver->num_nodes = DLX_ROOT + 1;
+    
+    for (int cell = 0; cell < 81; cell++) {
+        int r = cell / 9, c = cell % 9;
+        int box = (r / 3) * 3 + c / 3;
+        
+        for (int num = 1; num <= 9; num++) {
+            int columns[5];
+            int count = 0;
+            
+            columns[count++] = cell;
+            columns[count++] = 81 + r * 9 + (num - 1);
+            columns[count++] = 162 + c * 9 + (num - 1);
+            columns[count++] = 243 + box * 9 + (num - 1);
+            if (r + c == 8) {
+                columns[count++] = 324 + (num - 1);
+            } else if (r >= 1 && r <= 3 && c >= 1 && c <= 3) {
+                columns[count++] = 333 + (num - 1);
+            } else if (r >= 5 && r <= 7 && c >= 5 && c <= 7) {
+                columns[count++] = 342 + (num - 1);
+            }
+            
+            // 同一候选行的节点组成环形链表
+            int first = solver->num_nodes;
+            int row_id = cell * 9 + (num - 1);
+            for (int i = 0; i < count; i++) {
+                int node = solver->num_nodes++;
+                solver->row[node] = row_id;
+                solver->left[node] = (i == 0) ? first + count - 1 : node - 1;
+                solver->right[node] = (i == count - 1) ? first : node + 1;
+                append_to_column(solver, node, columns[i]);
+            }
+            solver->row_first[row_id] = first;
+        }
+    }
+    
+    return solver;
+}
+
+// 释放求解器
+void free_dlx_solver(DlxSolver* solver) {
+    if (solver != NULL) {
+        safe_free(solver);
+    }
+}
+
+// 覆盖列c
+static void cover_column(DlxSolver* solver, int c) {
+    solver->right[solver->left[c]] = solver->right[c];
+    solver->left[solver->right[c]] = solver->left[c];
+    solver->column_covered[c] = 1;
+    
+    for (int i = solver->down[c]; i != c; i = solver->down[i]) {
+        for (int j = solver->right[i]; j != i; j = solver->right[j]) {
+            solver->down[solver->up[j]] = solver->down[j];
+            solver->up[solver->down[j]] = solver->up[j];
+            solver->size[solver->column[j]]--;
+        }
+    }
+}
+
+// 恢复列c（与覆盖顺序相反）
+static void uncover_column(DlxSolver* solver, int c) {
+    for (int i = solver->up[c]; i != c; i = solver->up[i]) {
+        for (int j = solver->left[i]; j != i; j = solver->left[j]) {
+            solver->size[solver->column[j]]++;
+            solver->down[solver->up[j]] = j;
+            solver->up[solver->down[j]] = j;
+        }
+    }
+    
+    solver->column_covered[c] = 0;
+    solver->right[solver->left[c]] = c;
+    solver->left[solver->right[c]] = c;
+}
+
+// Algorithm X 搜索
+static void dlx_search(DlxSolver* solver, int* count, int limit, PercentSudokuGrid* solution) {
+    if (solver->right[DLX_ROOT] == DLX_ROOT) {
+        // 所有列都已覆盖：找到一个解
+        if (*count == 0 && solution != NULL) {
+            for (int i = 0; i < solver->depth; i++) {
+                int row_id = solver->partial[i];
+                int cell = row_id / 9;
+                solution->grid[cell / 9][cell % 9] = row_id % 9 + 1;
+            }
+        }
+        (*count)++;
+        return;
+    }
+    
+    // 选择节点最少的列
+    int best = solver->right[DLX_ROOT];
+    for (int c = solver->right[best]; c != DLX_ROOT; c = solver->right[c]) {
+        if (solver->size[c] < solver->size[best]) {
+            best = c;
+            if (solver->size[best] <= 1) break;
+        }
+    }
+    if (solver->size[best] == 0) {
+        return;
+    }
+    
+    cover_column(solver, best);
+    for (int r = solver->down[best]; r != best && *count < limit; r = solver->down[r]) {
+        solver->partial[solver->depth++] = solver->row[r];
+        for (int j = solver->right[r]; j != r; j = solver->right[j]) {
+            cover_column(solver, solver->column[j]);
+        }
+        
+        dlx_search(solver, count, limit, solution);
+        
+        for (int j = solver->left[r]; j != r; j = solver->left[j]) {
+            uncover_column(solver, solver->column[j]);
+        }
+        solver->depth--;
+    }
+    uncover_column(solver, best);
+}
+
+// 求解：先覆盖给定数字所在的行，搜索后按相反顺序恢复矩阵
+int dlx_solve(DlxSolver* solver, const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int limit) {
+    if (solver == NULL || puzzle == NULL || limit <= 0) {
+        return 0;
+    }
+    
+    int given_rows[81];
+    int num_given = 0;
+    int conflict = 0;
+    
+    for (int cell = 0; cell < 81 && !conflict; cell++) {
+        int num = puzzle->grid[cell / 9][cell % 9];
+        if (num == PERCENT_SUDOKU_EMPTY) {
+            continue;
+        }
+        if (num < PERCENT_SUDOKU_MIN_NUM || num > PERCENT_SUDOKU_MAX_NUM) {
+            conflict = 1;
+            break;
+        }
+        
+        // 该行的任一列已被其他给定数字覆盖，说明给定数字互相冲突
+        int first = solver->row_first[cell * 9 + (num - 1)];
+        int node = first;
+        do {
+            if (solver->column_covered[solver->column[node]]) {
+                conflict = 1;
+                break;
+            }
+            node = solver->right[node];
+        } while (node != first);
+        if (conflict) {
+            break;
+        }
+        
+        node = first;
+        do {
+            cover_column(solver, solver->column[node]);
+            node = solver->right[node];
+        } while (node != first);
+        
+        given_rows[num_given++] = first;
+    }
+    
+    int count = 0;
+    if (!conflict) {
+        solver->depth = 0;
+        if (solution != NULL) {
+            copy_percent_sudoku_grid(puzzle, solution);
+        }
+        dlx_search(solver, &count, limit, solution);
+    }
+    
+    // 恢复给定数字覆盖的列
+    while (num_given > 0) {
+        int first = given_rows[--num_given];
+        int node = solver->left[first];
+        while (1) {
+            uncover_column(solver, solver->column[node]);
+            if (node == first) break;
+            node = solver->left[node];
+        }
+    }
+    
+    return count;
+}
+
+// 获取共享求解器
+static DlxSolver* get_shared_dlx_solver(void) {
+    if (shared_dlx_solver == NULL) {
+        shared_dlx_solver = create_dlx_solver();
+    }
+    return shared_dlx_solver;
+}
+
+// 释放当前线程的共享求解器
+void free_shared_dlx_solver(void) {
+    free_dlx_solver(shared_dlx_solver);
+    shared_dlx_solver = NULL;
+}
+
+// 使用DLX求解百分号数独，成功时将解写回grid
+int solve_percent_sudoku_dlx(PercentSudokuGrid* grid) {
+    if (grid == NULL) {
+        return 0;
+    }
+    
+    PercentSudokuGrid puzzle;
+    copy_percent_sudoku_grid(grid, &puzzle);
+    return dlx_solve(get_shared_dlx_solver(), &puzzle, grid, 1) > 0;
+}
+
+// 使用DLX计算解的个数（最多计到limit）
+int count_solutions_dlx(const PercentSudokuGrid* grid, int limit) {
+    if (grid == NULL) {
+        return 0;
+    }
+    
+    return dlx_solve(get_shared_dlx_solver(), grid, NULL, limit);
+}
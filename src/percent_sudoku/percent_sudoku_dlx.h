@@ -0,0 +1,54 @@
+#ifndef PERCENT_SUDOKU_DLX_H
+#define PERCENT_SUDOKU_DLX_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// Dancing Links (Algorithm X) 精确覆盖求解器
+// 列（约束）：
+//   0-80     每个格子恰好一个数字
+//   81-161   每行每个数字恰好一次
+//   162-242  每列每个数字恰好一次
+//   243-323  每宫每个数字恰好一次
+//   324-332  撇对角线每个数字恰好一次
+//   333-341  上方窗口每个数字恰好一次
+//   342-350  下方窗口每个数字恰好一次
+// 行（候选）：729个 (格, 数字) 组合，每行4-5个节点
+// 矩阵只构建一次，每个谜题通过覆盖给定数字所在的行来复用
+
+#define DLX_NUM_COLUMNS 351
+#define DLX_NUM_ROWS 729
+#define DLX_ROOT DLX_NUM_COLUMNS
+#define DLX_MAX_NODES (DLX_NUM_COLUMNS + 1 + DLX_NUM_ROWS * 5)
+
+// DLX矩阵（节点0-350为列头，351为根，之后为数据节点）
+typedef struct {
+    int left[DLX_MAX_NODES];
+    int right[DLX_MAX_NODES];
+    int up[DLX_MAX_NODES];
+    int down[DLX_MAX_NODES];
+    int column[DLX_MAX_NODES];      // 节点所在列
+    int row[DLX_MAX_NODES];         // 节点所在候选行 (cell*9 + num-1)
+    int size[DLX_NUM_COLUMNS];      // 每列剩余节点数
+    int column_covered[DLX_NUM_COLUMNS];  // 列是否已被覆盖
+    int row_first[DLX_NUM_ROWS];    // 每个候选行的第一个节点
+    int num_nodes;
+    int partial[DLX_NUM_ROWS];      // 当前搜索路径上选择的候选行
+    int depth;
+} DlxSolver;
+
+// 函数声明
+
+// 求解器构建与释放（每个线程使用各自的求解器）
+DlxSolver* create_dlx_solver(void);
+void free_dlx_solver(DlxSolver* solver);
+
+// 求解：返回找到的解的个数（最多limit个），第一个解写入solution（可为NULL）
+int dlx_solve(DlxSolver* solver, const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int limit);
+
+// 便捷接口（每个线程按需创建一个共享求解器，线程结束前调用free_shared_dlx_solver释放）
+int solve_percent_sudoku_dlx(PercentSudokuGrid* grid);
+int count_solutions_dlx(const PercentSudokuGrid* grid, int limit);
+void free_shared_dlx_solver(void);
+
+#endif // PERCENT_SUDOKU_DLX_H
@@ -0,0 +1,330 @@
+#include "percent_sudoku_generator.h"
+#include "../trace/trace.h"
+#include <pthread.h>
+
+// 重排窗口中的谜题
+typedef struct {
+    int ready;
+    PercentSudokuGame game;
+} GeneratorSlot;
+
+// 流水线共享状态（所有字段由mutex保护）
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_ready;
+    pthread_cond_t slot_free;
+    
+    GeneratorSlot* slots;         // 重排窗口，谜题i放在 slots[i % window]
+    int window;
+    int num_sources;              // 需要生成的谜题数量
+    int next_index;               // 下一个待领取的序号
+    int next_to_write;            // 下一个待输出的序号
+    
+    const GeneratorOptions* options;
+} GeneratorPipeline;
+
+// 生成序号为index的谜题，失败时写入空谜题（给定数为0）
+static void generate_source_puzzle(const GeneratorOptions* options, int index, PercentSudokuGame* output) {
+    Rng rng;
+    rng_seed(&rng, derive_seed(options->seed, (uint64_t)index));
+    TRACE_BEGIN("generator", "generate_puzzle");
+    PercentSudokuGame* game = generate_percent_sudoku_puzzle_with_rng(options->difficulty, &rng);
+    TRACE_END("generator", "generate_puzzle");
+    if (game != NULL) {
+        *output = *game;
+    } else {
+        memset(output, 0, sizeof(PercentSudokuGame));
+    }
+    free_percent_sudoku_game(game);
+}
+
+// 工作线程：领取序号、生成谜题、放入重排窗口
+static void* generator_worker(void* arg) {
+    GeneratorPipeline* pipeline = (GeneratorPipeline*)arg;
+    PercentSudokuGame game;
+    
+    trace_set_thread_name("generator worker");
+    pthread_mutex_lock(&pipeline->mutex);
+    while (pipeline->next_index < pipeline->num_sources) {
+        int index = pipeline->next_index++;
+        pthread_mutex_unlock(&pipeline->mutex);
+        
+        generate_source_puzzle(pipeline->options, index, &game);
+        
+        pthread_mutex_lock(&pipeline->mutex);
+        while (index >= pipeline->next_to_write + pipeline->window) {
+            pthread_cond_wait(&pipeline->slot_free, &pipeline->mutex);
+        }
+        GeneratorSlot* slot = &pipeline->slots[index % pipeline->window];
+        slot->game = game;
+        slot->ready = 1;
+        if (index == pipeline->next_to_write) {
+            pthread_cond_signal(&pipeline->slot_ready);
+        }
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return NULL;
+}
+
+// 网格去重用的哈希集合（开放定址，0表示空位）
+typedef struct {
+    uint64_t* keys;
+    size_t mask;
+} GridHashSet;
+
+// 按预计的元素数量分配哈希集合（内存不足时与 safe_malloc 一样直接退出）
+static void init_grid_hash_set(GridHashSet* set, int expected) {
+    size_t capacity = 1;
+    while (capacity < 2 * (size_t)expected) {
+        capacity <<= 1;
+    }
+    set->keys = (uint64_t*)tracked_malloc(MEMORY_SUDOKU, capacity * sizeof(uint64_t));
+    memset(set->keys, 0, capacity * sizeof(uint64_t));
+    set->mask = capacity - 1;
+}
+
+// 加入一个网格，新网格返回1
+static int insert_grid_hash(GridHashSet* set, const PercentSudokuGrid* grid) {
+    char line[PERCENT_SUDOKU_LINE_LENGTH + 1];
+    format_percent_sudoku_line(grid, line);
+    uint64_t key = hash_fnv1a64(line, PERCENT_SUDOKU_LINE_LENGTH);
+    if (key == 0) {
+        key = 1;
+    }
+    
+    size_t pos = (size_t)key & set->mask;
+    while (set->keys[pos] != 0) {
+        if (set->keys[pos] == key) {
+            return 0;
+        }
+        pos = (pos + 1) & set->mask;
+    }
+    set->keys[pos] = key;
+    return 1;
+}
+
+// 初始化生成选项
+void init_generator_options(GeneratorOptions* options) {
+    if (options == NULL) {
+        return;
+    }
+    
+    options->count = 0;
+    options->difficulty = 2;
+    options->num_threads = 0;
+    options->seed = 0;
+    options->variants = 1;
+}
+
+// 运行生成流水线，按序号把谜题交给sink（可为NULL），返回生成的谜题数量
+int run_percent_sudoku_generator(const GeneratorOptions* options, GeneratedPuzzleSink sink, void* context,
+                                 GeneratorReport* report) {
+    if (options == NULL || report == NULL || options->count <= 0) {
+        print_error("run_percent_sudoku_generator", COMMON_ERROR_INVALID_PARAMETER, "Invalid parameters");
+        return 0;
+    }
+    
+    int variants = options->variants > 1 ? options->variants : 1;
+    
+    GeneratorPipeline pipeline;
+    memset(&pipeline, 0, sizeof(GeneratorPipeline));
+    pipeline.options = options;
+    pipeline.num_sources = (options->count + variants - 1) / variants;
+    
+    memset(report, 0, sizeof(GeneratorReport));
+    report->num_threads = options->num_threads > 0 ? options->num_threads : get_cpu_count();
+    if (report->num_threads > pipeline.num_sources) {
+        report->num_threads = pipeline.num_sources;
+    }
+    
+    pipeline.window = 4 * report->num_threads + 16;
+    pipeline.slots = (GeneratorSlot*)tracked_malloc(MEMORY_SUDOKU, pipeline.window * sizeof(GeneratorSlot));
+    for (int i = 0; i < pipeline.window; i++) {
+        pipeline.slots[i].ready = 0;
+    }
+    
+    GridHashSet seen_puzzles, seen_grids;
+    init_grid_hash_set(&seen_puzzles, options->count);
+    init_grid_hash_set(&seen_grids, options->count);
+    
+    pthread_mutex_init(&pipeline.mutex, NULL);
+    pthread_cond_init(&pipeline.slot_ready, NULL);
+    pthread_cond_init(&pipeline.slot_free, NULL);
+    
+    double start_time = get_monotonic_time_ms();
+    
+    // 只记录实际启动的工作线程；一个都没启动时由输出阶段自己依次生成
+    pthread_t* workers = (pthread_t*)tracked_malloc(MEMORY_SUDOKU, report->num_threads * sizeof(pthread_t));
+    int num_started = 0;
+    for (int i = 0; i < report->num_threads; i++) {
+        if (pthread_create(&workers[num_started], NULL, generator_worker, &pipeline) == 0) {
+            num_started++;
+        }
+    }
+    report->num_threads = num_started;
+    
+    // 输出阶段在调用线程中运行，按序号依次取出
+    PercentSudokuGame game, variant;
+    PercentSudokuTransform transform;
+    Rng variant_rng;
+    int output_index = 0;
+    
+    pthread_mutex_lock(&pipeline.mutex);
+    while (pipeline.next_to_write < pipeline.num_sources) {
+        GeneratorSlot* next = &pipeline.slots[pipeline.next_to_write % pipeline.window];
+        if (num_started == 0) {
+            generate_source_puzzle(options, pipeline.next_to_write, &next->game);
+            next->ready = 1;
+        }
+        while (!next->ready) {
+            pthread_cond_wait(&pipeline.slot_ready, &pipeline.mutex);
+        }
+        
+        game = next->game;
+        next->ready = 0;
+        int index = pipeline.next_to_write++;
+        pthread_cond_broadcast(&pipeline.slot_free);
+        pthread_mutex_unlock(&pipeline.mutex);
+        
+        // 第一个输出原谜题，其余为随机对称变换
+        rng_seed(&variant_rng, derive_seed(derive_seed(options->seed, (uint64_t)index), 1));
+        for (int v = 0; v < variants && output_index < options->count && game.num_givens > 0; v++) {
+            const PercentSudokuGame* output = &game;
+            if (v > 0) {
+                random_transform(&transform, &variant_rng);
+                apply_transform_game(&transform, &game, &variant);
+                output = &variant;
+            }
+            
+            report->generated++;
+            report->unique += insert_grid_hash(&seen_puzzles, &output->puzzle);
+            report->unique_grids += insert_grid_hash(&seen_grids, &output->solution);
+            if (sink != NULL) {
+                sink(context, output_index, output);
+            }
+            output_index++;
+        }
+        
+        pthread_mutex_lock(&pipeline.mutex);
+    }
+    pthread_mutex_unlock(&pipeline.mutex);
+    
+    for (int i = 0; i < num_started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    
+    report->wall_time_ms = get_monotonic_time_ms() - start_time;
+    if (report->wall_time_ms > 0.0) {
+        report->puzzles_per_second = report->generated * 1000.0 / report->wall_time_ms;
+    }
+    
+    // 清理
+    pthread_mutex_destroy(&pipeline.mutex);
+    pthread_cond_destroy(&pipeline.slot_ready);
+    pthread_cond_destroy(&pipeline.slot_free);
+    safe_free(workers);
+    safe_free(pipeline.slots);
+    safe_free(seen_puzzles.keys);
+    safe_free(seen_grids.keys);
+    
+    return report->generated;
+}
+
+// 输出回调：写出单行格式（谜题后附解答）
+static void write_generated_puzzle(void* context, int index, const PercentSudokuGame* game) {
+    (void)index;
+    write_puzzle_line((PuzzleLineWriter*)context, &game->puzzle, &game->solution);
+}
+
+// 并行生成谜题并写入单行格式文件，返回写出的数量（无法打开或写入文件时返回0）
+int generate_puzzle_file(const char* filename, const GeneratorOptions* options, GeneratorReport* report) {
+    if (filename == NULL || options == NULL || report == NULL) {
+        return 0;
+    }
+    
+    PuzzleLineWriter* writer = open_puzzle_writer(filename);
+    if (writer == NULL) {
+        return 0;
+    }
+    
+    int written = run_percent_sudoku_generator(options, write_generated_puzzle, writer, report);
+    if (!close_puzzle_writer(writer)) {
+        return 0;
+    }
+    return written;
+}
+
+// 打印生成报告
+void print_generator_report(const GeneratorReport* report, const GeneratorOptions* options) {
+    if (report == NULL) {
+        return;
+    }
+    
+    printf("=== Puzzle Generation Report ===\n");
+    if (options != NULL) {
+        printf("Difficulty: %d\n", options->difficulty);
+        printf("Seed: %llu\n", (unsigned long long)options->seed);
+        if (options->variants > 1) {
+            printf("Variants per generated puzzle: %d\n", options->variants);
+        }
+    }
+    printf("Worker threads: %d\n", report->num_threads);
+    printf("Puzzles: %d (unique %d, unique solution grids %d)\n",
+           report->generated, report->unique, report->unique_grids);
+    printf("Wall time: %.2f ms\n", report->wall_time_ms);
+    printf("Throughput: %.1f puzzles/sec\n", report->puzzles_per_second);
+    printf("================================\n");
+}
+
+// 只生成完整解答，统计生成速度与互不相同的解答数量
+// 第i个解答使用 derive_seed(seed, i)，与并行生成时的随机数流一致
+int run_complete_grid_stats(const GeneratorOptions* options, GridStatsReport* report) {
+    if (options == NULL || report == NULL || options->count <= 0) {
+        print_error("run_complete_grid_stats", COMMON_ERROR_INVALID_PARAMETER, "Invalid parameters");
+        return 0;
+    }
+    
+    memset(report, 0, sizeof(GridStatsReport));
+    GridHashSet seen;
+    init_grid_hash_set(&seen, options->count);
+    
+    PercentSudokuGrid grid;
+    Rng rng;
+    double start_time = get_monotonic_time_ms();
+    
+    for (int i = 0; i < options->count; i++) {
+        rng_seed(&rng, derive_seed(options->seed, (uint64_t)i));
+        generate_random_complete_percent_sudoku(&grid, &rng);
+        if (!is_complete_percent_sudoku(&grid)) {
+            continue;
+        }
+        report->generated++;
+        report->unique += insert_grid_hash(&seen, &grid);
+    }
+    
+    report->wall_time_ms = get_monotonic_time_ms() - start_time;
+    if (report->wall_time_ms > 0.0) {
+        report->grids_per_second = report->generated * 1000.0 / report->wall_time_ms;
+    }
+    
+    safe_free(seen.keys);
+    return report->generated;
+}
+
+// 打印完整解答生成统计
+void print_grid_stats_report(const GridStatsReport* report, const GeneratorOptions* options) {
+    if (report == NULL) {
+        return;
+    }
+    
+    printf("=== Solution Grid Statistics ===\n");
+    if (options != NULL) {
+        printf("Seed: %llu\n", (unsigned long long)options->seed);
+    }
+    printf("Grids: %d (unique %d, %.2f%%)\n", report->generated, report->unique,
+           report->generated > 0 ? report->unique * 100.0 / report->generated : 0.0);
+    printf("Wall time: %.2f ms\n", report->wall_time_ms);
+    printf("Throughput: %.1f grids/sec\n", report->grids_per_second);
+    printf("================================\n");
+}
@@ -0,0 +1,56 @@
+#ifndef PERCENT_SUDOKU_GENERATOR_H
+#define PERCENT_SUDOKU_GENERATOR_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+#include "percent_sudoku_io.h"
+#include "percent_sudoku_transform.h"
+
+// 多线程谜题生成流水线
+// 工作线程依次领取谜题序号，第i个谜题使用由主种子派生的独立随机数生成器
+// （derive_seed(seed, i)），因此输出只取决于主种子，与线程数和调度无关。
+// 生成的谜题放入固定大小的重排窗口，由调用线程按序号交给输出回调。
+// variants > 1 时，每个求解生成的谜题之后再输出 variants-1 个对称变换得到的谜题
+// （见 percent_sudoku_transform.h），它们的解同样唯一，不需要再次求解。
+
+// 生成选项
+typedef struct {
+    int count;                    // 生成数量
+    int difficulty;               // 难度 (1-5)
+    int num_threads;              // 工作线程数，<=0 表示使用CPU核心数
+    uint64_t seed;                // 主种子
+    int variants;                 // 每个生成的谜题输出的数量（含原谜题），其余为对称变换
+} GeneratorOptions;
+
+// 生成报告
+typedef struct {
+    int generated;                // 生成的谜题数量
+    int unique;                   // 其中互不相同的谜题数量
+    int unique_grids;             // 互不相同的完整解答数量
+    int num_threads;              // 实际使用的工作线程数
+    double wall_time_ms;          // 总墙钟时间
+    double puzzles_per_second;    // 吞吐量
+} GeneratorReport;
+
+// 完整解答生成统计
+typedef struct {
+    int generated;                // 生成的完整解答数量
+    int unique;                   // 其中互不相同的数量
+    double wall_time_ms;          // 总耗时
+    double grids_per_second;      // 吞吐量
+} GridStatsReport;
+
+// 输出回调：按序号顺序调用，game 只在回调期间有效
+typedef void (*GeneratedPuzzleSink)(void* context, int index, const PercentSudokuGame* game);
+
+// 函数声明
+
+void init_generator_options(GeneratorOptions* options);
+int run_percent_sudoku_generator(const GeneratorOptions* options, GeneratedPuzzleSink sink, void* context,
+                                 GeneratorReport* report);
+int generate_puzzle_file(const char* filename, const GeneratorOptions* options, GeneratorReport* report);
+void print_generator_report(const GeneratorReport* report, const GeneratorOptions* options);
+int run_complete_grid_stats(const GeneratorOptions* options, GridStatsReport* report);
+void print_grid_stats_report(const GridStatsReport* report, const GeneratorOptions* options);
+
+#endif // PERCENT_SUDOKU_GENERATOR_H
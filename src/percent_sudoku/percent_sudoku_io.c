@@ -0,0 +1,249 @@
+#include "percent_sudoku_io.h"
+#include <dirent.h>
+
+// 打开读取器，成功返回1
+int open_puzzle_reader(PuzzleLineReader* reader, const char* filename) {
+    if (reader == NULL || filename == NULL) {
+        return 0;
+    }
+    
+    reader->offset = 0;
+    reader->line_number = 0;
+    if (!map_file_readonly(filename, &reader->file)) {
+        print_error("open_puzzle_reader", COMMON_ERROR_FILE_NOT_FOUND, "Cannot map puzzle file");
+        return 0;
+    }
+    
+    return 1;
+}
+
+static int is_field_separator(char ch) {
+    return ch == ' ' || ch == '\t' || ch == ',';
+}
+
+// 读取下一个谜题（solution与has_solution可为NULL）
+int read_next_puzzle(PuzzleLineReader* reader, PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int* has_solution) {
+    if (reader == NULL || puzzle == NULL) {
+        return PUZZLE_READ_END;
+    }
+    
+    const char* data = reader->file.data;
+    size_t size = reader->file.size;
+    
+    while (reader->offset < size) {
+        const char* line = data + reader->offset;
+        const char* newline = (const char*)memchr(line, '\n', size - reader->offset);
+        size_t length = newline != NULL ? (size_t)(newline - line) : size - reader->offset;
+        
+        reader->offset += length + (newline != NULL ? 1 : 0);
+        reader->line_number++;
+        
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        
+        // 跳过空行与注释行
+        size_t pos = 0;
+        while (pos < length && is_field_separator(line[pos])) pos++;
+        if (pos == length || line[pos] == '#') {
+            continue;
+        }
+        
+        // 谜题字段
+        if (length - pos < PERCENT_SUDOKU_LINE_LENGTH || !parse_percent_sudoku_line(line + pos, puzzle)) {
+            return PUZZLE_READ_INVALID;
+        }
+        pos += PERCENT_SUDOKU_LINE_LENGTH;
+        if (has_solution != NULL) {
+            *has_solution = 0;
+        }
+        
+        // 可选的解答字段（与谜题之间至少一个分隔符）
+        size_t field_start = pos;
+        while (pos < length && is_field_separator(line[pos])) pos++;
+        if (pos == length) {
+            return PUZZLE_READ_OK;
+        }
+        if (pos == field_start || length - pos < PERCENT_SUDOKU_LINE_LENGTH) {
+            return PUZZLE_READ_INVALID;
+        }
+        
+        PercentSudokuGrid parsed;
+        if (!parse_percent_sudoku_line(line + pos, solution != NULL ? solution : &parsed)) {
+            return PUZZLE_READ_INVALID;
+        }
+        pos += PERCENT_SUDOKU_LINE_LENGTH;
+        
+        while (pos < length && is_field_separator(line[pos])) pos++;
+        if (pos != length) {
+            return PUZZLE_READ_INVALID;
+        }
+        
+        if (has_solution != NULL) {
+            *has_solution = 1;
+        }
+        return PUZZLE_READ_OK;
+    }
+    
+    return PUZZLE_READ_END;
+}
+
+// 关闭读取器
+void close_puzzle_reader(PuzzleLineReader* reader) {
+    if (reader != NULL) {
+        unmap_file(&reader->file);
+    }
+}
+
+// 打开写出器，filename为"-"时写到标准输出
+PuzzleLineWriter* open_puzzle_writer(const char* filename) {
+    if (filename == NULL) {
+        return NULL;
+    }
+    
+    FILE* file = strcmp(filename, "-") == 0 ? stdout : fopen(filename, "wb");
+    if (file == NULL) {
+        print_error("open_puzzle_writer", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open file for writing");
+        return NULL;
+    }
+    
+    PuzzleLineWriter* writer = (PuzzleLineWriter*)tracked_malloc(MEMORY_SUDOKU, sizeof(PuzzleLineWriter));
+    writer->file = file;
+    writer->used = 0;
+    writer->error = 0;
+    return writer;
+}
+
+// 确保缓冲区还有needed字节的空间
+static void reserve_writer_space(PuzzleLineWriter* writer, size_t needed) {
+    if (writer->used + needed > PUZZLE_WRITER_BUFFER_SIZE) {
+        flush_puzzle_writer(writer);
+    }
+}
+
+// 直接把网格编码进缓冲区
+static void append_grid(PuzzleLineWriter* writer, const PercentSudokuGrid* grid) {
+    char* out = writer->buffer + writer->used;
+    for (int cell = 0; cell < PERCENT_SUDOKU_LINE_LENGTH; cell++) {
+        int num = grid->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+        out[cell] = (num >= PERCENT_SUDOKU_MIN_NUM && num <= PERCENT_SUDOKU_MAX_NUM) ? (char)('0' + num) : '0';
+    }
+    writer->used += PERCENT_SUDOKU_LINE_LENGTH;
+}
+
+// 写出一行（solution为NULL时只写谜题）
+void write_puzzle_line(PuzzleLineWriter* writer, const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution) {
+    if (writer == NULL || puzzle == NULL) {
+        return;
+    }
+    
+    reserve_writer_space(writer, 2 * PERCENT_SUDOKU_LINE_LENGTH + 2);
+    append_grid(writer, puzzle);
+    if (solution != NULL) {
+        writer->buffer[writer->used++] = ' ';
+        append_grid(writer, solution);
+    }
+    writer->buffer[writer->used++] = '\n';
+}
+
+// 写出注释行（自动加上"# "前缀）
+void write_puzzle_comment(PuzzleLineWriter* writer, const char* text) {
+    if (writer == NULL || text == NULL) {
+        return;
+    }
+    
+    flush_puzzle_writer(writer);
+    if (fprintf(writer->file, "# %s\n", text) < 0) {
+        writer->error = 1;
+    }
+}
+
+// 把缓冲区写入文件
+void flush_puzzle_writer(PuzzleLineWriter* writer) {
+    if (writer == NULL || writer->used == 0) {
+        return;
+    }
+    
+    if (fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        writer->error = 1;
+    }
+    writer->used = 0;
+}
+
+// 关闭写出器，之前的写入或最后的刷新、关闭失败时返回0
+int close_puzzle_writer(PuzzleLineWriter* writer) {
+    if (writer == NULL) {
+        return 0;
+    }
+    
+    flush_puzzle_writer(writer);
+    int failed = writer->error;
+    if (writer->file == stdout) {
+        failed |= fflush(stdout) != 0;
+    } else {
+        failed |= fclose(writer->file) != 0;
+    }
+    safe_free(writer);
+    
+    if (failed) {
+        print_error("close_puzzle_writer", COMMON_ERROR_UNKNOWN, "Failed to write output file");
+        return 0;
+    }
+    return 1;
+}
+
+static int compare_file_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// 列出目录中的 .percent_sudoku 文件，返回文件数量（失败返回-1）
+int list_percent_sudoku_files(const char* dir_path, char*** paths) {
+    if (dir_path == NULL || paths == NULL) {
+        return -1;
+    }
+    
+    DIR* dir = opendir(dir_path);
+    if (dir == NULL) {
+        print_error("list_percent_sudoku_files", COMMON_ERROR_FILE_NOT_FOUND, "Cannot open puzzle directory");
+        return -1;
+    }
+    
+    char** names = NULL;
+    int num_names = 0, capacity = 0;
+    size_t ext_length = strlen(PERCENT_SUDOKU_FILE_EXTENSION);
+    size_t dir_length = strlen(dir_path);
+    struct dirent* entry;
+    
+    while ((entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length <= ext_length || strcmp(entry->d_name + length - ext_length, PERCENT_SUDOKU_FILE_EXTENSION) != 0) {
+            continue;
+        }
+        if (num_names == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            names = (char**)tracked_realloc(MEMORY_SUDOKU, names, capacity * sizeof(char*));
+        }
+        names[num_names] = (char*)tracked_malloc(MEMORY_SUDOKU, dir_length + length + 2);
+        snprintf(names[num_names], dir_length + length + 2, "%s/%s", dir_path, entry->d_name);
+        num_names++;
+    }
+    closedir(dir);
+    
+    if (num_names > 0) {
+        qsort(names, num_names, sizeof(char*), compare_file_names);
+    }
+    
+    *paths = names;
+    return num_names;
+}
+
+// 释放文件列表
+void free_file_list(char** paths, int count) {
+    if (paths == NULL) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        safe_free(paths[i]);
+    }
+    safe_free(paths);
+}
@@ -0,0 +1,55 @@
+#ifndef PERCENT_SUDOKU_IO_H
+#define PERCENT_SUDOKU_IO_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// 单行格式的批量读写
+// 每行一个谜题：81个字符的谜题，可选地接一个空白分隔的81字符解答：
+//     <puzzle81>[ <solution81>]
+// '1'-'9'为数字，'0'或'.'为空格；空行与 # 开头的行被忽略，兼容 \r\n 换行。
+// 读取器把整个文件映射到内存，直接从映射区解析到 PercentSudokuGrid，不做逐行拷贝；
+// 写出器自带缓冲区，整块写入文件。
+
+#define PUZZLE_WRITER_BUFFER_SIZE (1 << 16)
+#define PERCENT_SUDOKU_FILE_EXTENSION ".percent_sudoku"
+
+// 读取结果
+#define PUZZLE_READ_END 0         // 文件结束
+#define PUZZLE_READ_OK 1          // 读到一个谜题
+#define PUZZLE_READ_INVALID (-1)  // 该行格式错误（已跳过）
+
+// 内存映射读取器
+typedef struct {
+    MappedFile file;
+    size_t offset;                // 下一行的起始位置
+    int line_number;              // 最近读取的行号（从1开始）
+} PuzzleLineReader;
+
+// 缓冲写出器
+typedef struct {
+    FILE* file;
+    size_t used;
+    int error;                    // 写入失败（如磁盘已满）后置1，关闭时报告
+    char buffer[PUZZLE_WRITER_BUFFER_SIZE];
+} PuzzleLineWriter;
+
+// 函数声明
+
+// 读取
+int open_puzzle_reader(PuzzleLineReader* reader, const char* filename);
+int read_next_puzzle(PuzzleLineReader* reader, PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int* has_solution);
+void close_puzzle_reader(PuzzleLineReader* reader);
+
+// 写出
+PuzzleLineWriter* open_puzzle_writer(const char* filename);
+void write_puzzle_line(PuzzleLineWriter* writer, const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution);
+void write_puzzle_comment(PuzzleLineWriter* writer, const char* text);
+void flush_puzzle_writer(PuzzleLineWriter* writer);
+int close_puzzle_writer(PuzzleLineWriter* writer);   // 所有内容都已成功写出时返回1
+
+// 列出目录中的 .percent_sudoku 文件（完整路径，按文件名排序），失败返回-1
+int list_percent_sudoku_files(const char* dir_path, char*** paths);
+void free_file_list(char** paths, int count);
+
+#endif // PERCENT_SUDOKU_IO_H
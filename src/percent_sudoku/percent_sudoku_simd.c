@@ -0,0 +1,338 @@
+#include "percent_sudoku_simd.h"
+#include "percent_sudoku_bitmask.h"
+#include <pthread.h>
+
+#define SIMD_NUM_CELLS (PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE)
+#define SIMD_MAX_PEERS 40
+
+#if defined(__GNUC__)
+#define SIMD_ALIGNED __attribute__((aligned(32)))
+#define SIMD_HAVE_VECTOR_KERNELS 1
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_HAVE_AVX2_KERNEL 1
+#endif
+#else
+#define SIMD_ALIGNED
+#endif
+
+// 用户指定的内核（默认自动选择）；批量求解可能在多个工作线程中同时读取，按原子变量访问
+static int requested_kernel = SIMD_KERNEL_AUTO;
+
+// 同一单元内的其他格子
+typedef struct {
+    int peers[SIMD_NUM_CELLS][SIMD_MAX_PEERS];
+    int count[SIMD_NUM_CELLS];
+} SimdPeerTable;
+
+// 同伴表与CPU检测结果只与谜题结构和机器有关，首次使用时初始化一次，之后只读共享
+static SimdPeerTable peer_table;
+static int cpu_has_avx2;
+static pthread_once_t simd_tables_once = PTHREAD_ONCE_INIT;
+
+// 构建格子的同伴表（与格子共享任一约束单元的其他格子）
+static void build_peer_table(SimdPeerTable* table) {
+    for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+        int is_peer[SIMD_NUM_CELLS] = {0};
+        int units[5];
+        int num_units = get_cell_units(cell, units);
+        
+        for (int u = 0; u < num_units; u++) {
+            for (int n = 0; n < 9; n++) {
+                is_peer[PERCENT_SUDOKU_UNITS[units[u]][n]] = 1;
+            }
+        }
+        is_peer[cell] = 0;
+        
+        table->count[cell] = 0;
+        for (int other = 0; other < SIMD_NUM_CELLS; other++) {
+            if (is_peer[other]) {
+                table->peers[cell][table->count[cell]++] = other;
+            }
+        }
+    }
+}
+
+static void init_simd_tables(void) {
+    build_peer_table(&peer_table);
+#ifdef SIMD_HAVE_AVX2_KERNEL
+    __builtin_cpu_init();
+    cpu_has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+// 标量内核：逐通道传播，candidates按 [格子][通道] 排列
+static void propagate_scalar(unsigned short* candidates, const SimdPeerTable* table) {
+    for (int lane = 0; lane < SIMD_BATCH_LANES; lane++) {
+        int changed = 1;
+        while (changed) {
+            changed = 0;
+            
+            // 唯一候选数：从同伴中删去已确定的数字
+            for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+                unsigned short m = candidates[cell * SIMD_BATCH_LANES + lane];
+                if (m == 0 || (m & (m - 1)) != 0) continue;
+                
+                for (int p = 0; p < table->count[cell]; p++) {
+                    unsigned short* peer = &candidates[table->peers[cell][p] * SIMD_BATCH_LANES + lane];
+                    if (*peer & m) {
+                        *peer &= (unsigned short)~m;
+                        changed = 1;
+                    }
+                }
+            }
+            
+            // 隐性唯一数：单元中只出现一次的候选数字
+            for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+                unsigned short once = 0, twice = 0;
+                for (int n = 0; n < 9; n++) {
+                    unsigned short m = candidates[PERCENT_SUDOKU_UNITS[u][n] * SIMD_BATCH_LANES + lane];
+                    twice |= once & m;
+                    once |= m;
+                }
+                unsigned short hidden = once & (unsigned short)~twice;
+                if (hidden == 0) continue;
+                
+                for (int n = 0; n < 9; n++) {
+                    unsigned short* m = &candidates[PERCENT_SUDOKU_UNITS[u][n] * SIMD_BATCH_LANES + lane];
+                    unsigned short h = *m & hidden;
+                    if (h != 0 && h != *m) {
+                        *m = h;
+                        changed = 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#ifdef SIMD_HAVE_VECTOR_KERNELS
+
+// 16个通道的16位候选掩码
+typedef unsigned short SimdLanes __attribute__((vector_size(32)));
+
+// 向量内核主体：所有通道同步执行与标量内核相同的推理，直到所有通道都不再变化
+#define PROPAGATE_LANES_BODY                                                       \
+    SimdLanes* cand = (SimdLanes*)candidates;                                      \
+    int changed = 1;                                                               \
+    while (changed) {                                                              \
+        SimdLanes delta = {0};                                                     \
+                                                                                   \
+        for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {                        \
+            SimdLanes m = cand[cell];                                              \
+            SimdLanes single = m & (SimdLanes)((m & (m - 1)) == 0);                \
+            for (int p = 0; p < table->count[cell]; p++) {                         \
+                SimdLanes* peer = &cand[table->peers[cell][p]];                    \
+                SimdLanes updated = *peer & ~single;                               \
+                delta |= *peer ^ updated;                                          \
+                *peer = updated;                                                   \
+            }                                                                      \
+        }                                                                          \
+                                                                                   \
+        for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {                       \
+            SimdLanes once = {0}, twice = {0};                                     \
+            for (int n = 0; n < 9; n++) {                                          \
+                SimdLanes m = cand[PERCENT_SUDOKU_UNITS[u][n]];                    \
+                twice |= once & m;                                                 \
+                once |= m;                                                         \
+            }                                                                      \
+            SimdLanes hidden = once & ~twice;                                      \
+            for (int n = 0; n < 9; n++) {                                          \
+                SimdLanes* m = &cand[PERCENT_SUDOKU_UNITS[u][n]];                  \
+                SimdLanes h = *m & hidden;                                         \
+                SimdLanes has_hidden = (SimdLanes)(h != 0);                        \
+                SimdLanes updated = (h & has_hidden) | (*m & ~has_hidden);         \
+                delta |= *m ^ updated;                                             \
+                *m = updated;                                                      \
+            }                                                                      \
+        }                                                                          \
+                                                                                   \
+        changed = 0;                                                               \
+        for (int lane = 0; lane < SIMD_BATCH_LANES; lane++) {                      \
+            if (delta[lane] != 0) {                                                \
+                changed = 1;                                                       \
+                break;                                                             \
+            }                                                                      \
+        }                                                                          \
+    }
+
+// 基础向量内核（使用编译目标默认的向量指令）
+static void propagate_vector(unsigned short* candidates, const SimdPeerTable* table) {
+    PROPAGATE_LANES_BODY
+}
+
+#ifdef SIMD_HAVE_AVX2_KERNEL
+// AVX2内核：一个256位寄存器容纳全部16个通道
+__attribute__((target("avx2")))
+static void propagate_avx2(unsigned short* candidates, const SimdPeerTable* table) {
+    PROPAGATE_LANES_BODY
+}
+#endif
+
+#endif // SIMD_HAVE_VECTOR_KERNELS
+
+// 内核名称
+const char* simd_kernel_name(SimdKernel kernel) {
+    switch (kernel) {
+        case SIMD_KERNEL_AUTO: return "auto";
+        case SIMD_KERNEL_SCALAR: return "scalar";
+        case SIMD_KERNEL_VECTOR: return "vector";
+        case SIMD_KERNEL_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+// 指定内核（SIMD_KERNEL_AUTO 恢复自动选择）
+void set_simd_kernel(SimdKernel kernel) {
+#if defined(__GNUC__)
+    __atomic_store_n(&requested_kernel, (int)kernel, __ATOMIC_RELAXED);
+#else
+    requested_kernel = (int)kernel;
+#endif
+}
+
+// 当前实际使用的内核：不支持的请求降级到可用的内核
+SimdKernel get_active_simd_kernel(void) {
+#ifdef SIMD_HAVE_VECTOR_KERNELS
+    pthread_once(&simd_tables_once, init_simd_tables);
+    int requested = __atomic_load_n(&requested_kernel, __ATOMIC_RELAXED);
+    if (requested == SIMD_KERNEL_SCALAR) {
+        return SIMD_KERNEL_SCALAR;
+    }
+    if (requested == SIMD_KERNEL_VECTOR) {
+        return SIMD_KERNEL_VECTOR;
+    }
+    return cpu_has_avx2 ? SIMD_KERNEL_AVX2 : SIMD_KERNEL_VECTOR;
+#else
+    return SIMD_KERNEL_SCALAR;
+#endif
+}
+
+// 对一批候选掩码执行传播
+static void run_propagation_kernel(SimdKernel kernel, unsigned short* candidates, const SimdPeerTable* table) {
+    switch (kernel) {
+#ifdef SIMD_HAVE_VECTOR_KERNELS
+#ifdef SIMD_HAVE_AVX2_KERNEL
+        case SIMD_KERNEL_AVX2:
+            propagate_avx2(candidates, table);
+            break;
+#endif
+        case SIMD_KERNEL_VECTOR:
+            propagate_vector(candidates, table);
+            break;
+#endif
+        default:
+            propagate_scalar(candidates, table);
+            break;
+    }
+}
+
+// 检查单个通道的传播结果：0 矛盾，1 已完全确定，2 需要搜索
+static int classify_lane(const unsigned short* candidates, int lane) {
+    int all_single = 1;
+    
+    for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+        unsigned short m = candidates[cell * SIMD_BATCH_LANES + lane];
+        if (m == 0) {
+            return 0;
+        }
+        if (m & (m - 1)) {
+            all_single = 0;
+        }
+    }
+    if (!all_single) {
+        return 2;
+    }
+    
+    for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+        int seen = 0;
+        for (int n = 0; n < 9; n++) {
+            seen |= candidates[PERCENT_SUDOKU_UNITS[u][n] * SIMD_BATCH_LANES + lane];
+        }
+        if (seen != PERCENT_SUDOKU_ALL_DIGITS) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 批量求解
+int solve_percent_sudoku_batch(PercentSudokuGrid* grids, int count, int* solved, SimdBatchStats* stats) {
+    if (grids == NULL || count < 0) {
+        return 0;
+    }
+    
+    SimdBatchStats local_stats = {0, 0, 0, 0};
+    pthread_once(&simd_tables_once, init_simd_tables);
+    const SimdPeerTable* table = &peer_table;
+    SimdKernel kernel = get_active_simd_kernel();
+    
+    static const int digit_of_bit[1 << 10] = {
+        [1 << 1] = 1, [1 << 2] = 2, [1 << 3] = 3, [1 << 4] = 4, [1 << 5] = 5,
+        [1 << 6] = 6, [1 << 7] = 7, [1 << 8] = 8, [1 << 9] = 9
+    };
+    
+    for (int base = 0; base < count; base += SIMD_BATCH_LANES) {
+        int lanes = (count - base < SIMD_BATCH_LANES) ? count - base : SIMD_BATCH_LANES;
+        unsigned short candidates[SIMD_NUM_CELLS * SIMD_BATCH_LANES] SIMD_ALIGNED;
+        int valid[SIMD_BATCH_LANES];
+        
+        // 装载：给定数字为单一候选，空格为全部候选，空闲通道填满全部候选
+        for (int lane = 0; lane < SIMD_BATCH_LANES; lane++) {
+            valid[lane] = 1;
+            for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+                unsigned short m = PERCENT_SUDOKU_ALL_DIGITS;
+                if (lane < lanes) {
+                    int num = grids[base + lane].grid[cell / 9][cell % 9];
+                    if (num >= PERCENT_SUDOKU_MIN_NUM && num <= PERCENT_SUDOKU_MAX_NUM) {
+                        m = (unsigned short)(1 << num);
+                    } else if (num != PERCENT_SUDOKU_EMPTY) {
+                        valid[lane] = 0;
+                    }
+                }
+                candidates[cell * SIMD_BATCH_LANES + lane] = m;
+            }
+        }
+        
+        run_propagation_kernel(kernel, candidates, table);
+        
+        for (int lane = 0; lane < lanes; lane++) {
+            PercentSudokuGrid* grid = &grids[base + lane];
+            int state = valid[lane] ? classify_lane(candidates, lane) : 0;
+            int ok = 0;
+            
+            if (state == 1) {
+                for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+                    grid->grid[cell / 9][cell % 9] = digit_of_bit[candidates[cell * SIMD_BATCH_LANES + lane]];
+                }
+                local_stats.propagated++;
+                ok = 1;
+            } else if (state == 2) {
+                // 从传播结果出发回退到标量搜索
+                PercentSudokuGrid work;
+                copy_percent_sudoku_grid(grid, &work);
+                for (int cell = 0; cell < SIMD_NUM_CELLS; cell++) {
+                    work.grid[cell / 9][cell % 9] = digit_of_bit[candidates[cell * SIMD_BATCH_LANES + lane]];
+                }
+                if (solve_percent_sudoku_bitmask(&work)) {
+                    copy_percent_sudoku_grid(&work, grid);
+                    local_stats.searched++;
+                    ok = 1;
+                }
+            }
+            
+            if (!ok) {
+                local_stats.unsolvable++;
+            }
+            if (solved != NULL) {
+                solved[base + lane] = ok;
+            }
+        }
+    }
+    
+    local_stats.num_puzzles = count;
+    if (stats != NULL) {
+        *stats = local_stats;
+    }
+    
+    return local_stats.propagated + local_stats.searched;
+}
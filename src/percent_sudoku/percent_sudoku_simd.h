@@ -0,0 +1,41 @@
+#ifndef PERCENT_SUDOKU_SIMD_H
+#define PERCENT_SUDOKU_SIMD_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// 位切片批量求解器
+// 一批最多16个谜题：每个格子的候选掩码按"格子 x 通道"排列，16个通道的16位掩码
+// 恰好组成一个256位向量。唯一候选数与隐性唯一数传播对所有通道同步执行，
+// 仍需分支的通道回退到标量的位掩码求解器。
+// 运行时检测CPU，选择AVX2、基础向量（x86-64上为SSE2）或纯标量内核。
+
+#define SIMD_BATCH_LANES 16
+
+// 传播内核
+typedef enum {
+    SIMD_KERNEL_AUTO,       // 运行时自动选择
+    SIMD_KERNEL_SCALAR,     // 逐通道标量实现（可移植）
+    SIMD_KERNEL_VECTOR,     // 编译器基础向量指令（x86-64上为SSE2）
+    SIMD_KERNEL_AVX2        // AVX2
+} SimdKernel;
+
+// 批量求解统计
+typedef struct {
+    int num_puzzles;        // 谜题总数
+    int propagated;         // 仅靠同步传播解出的数量
+    int searched;           // 回退到标量搜索后解出的数量
+    int unsolvable;         // 无解数量
+} SimdBatchStats;
+
+// 函数声明
+
+// 批量求解：grids就地写入解答，solved[i]为1表示第i个谜题有解（可为NULL），返回有解的数量
+int solve_percent_sudoku_batch(PercentSudokuGrid* grids, int count, int* solved, SimdBatchStats* stats);
+
+// 内核选择
+void set_simd_kernel(SimdKernel kernel);
+SimdKernel get_active_simd_kernel(void);
+const char* simd_kernel_name(SimdKernel kernel);
+
+#endif // PERCENT_SUDOKU_SIMD_H
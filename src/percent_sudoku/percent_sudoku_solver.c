@@ -1,17 +1,25 @@
 #include "percent_sudoku_solver.h"
+#include "percent_sudoku_batch.h"
+#include "percent_sudoku_benchmark.h"
+#include "percent_sudoku_transform.h"
+#include "percent_sudoku_cache.h"
+#include "../trace/trace.h"
 #include <time.h>
 #include <sys/stat.h>
+#include "../parser/parser.h"
 
 #ifdef _WIN32
 #include <direct.h>
 #define mkdir(path, mode) _mkdir(path)
 #else
 #include <sys/stat.h>
+#include <unistd.h>
+#include <pthread.h>
 #endif
 
 // 创建求解器配置
 SolverConfig* create_solver_config(void) {
-    SolverConfig* config = (SolverConfig*)safe_malloc(sizeof(SolverConfig));
+    SolverConfig* config = (SolverConfig*)tracked_malloc(MEMORY_SUDOKU, sizeof(SolverConfig));
     
     config->use_backtracking = 1;
     config->use_sat_solver = 1;
@@ -41,7 +49,7 @@ void set_solver_options(SolverConfig* config, int backtracking, int sat_solver,
     config->verbose_output = verbose;
 }
 
-// get_current_time_ms函数已在common模块中定义
+// get_monotonic_time_ms函数已在common模块中定义（计时一律使用单调时钟）
 
 // 初始化求解统计信息
 void initialize_solving_stats(PercentSudokuStats* stats) {
@@ -54,6 +62,7 @@ void initialize_solving_stats(PercentSudokuStats* stats) {
     stats->num_variables = 0;
     stats->num_clauses = 0;
     stats->num_givens = 0;
+    memset(&stats->solver, 0, sizeof(SolverStatistics));
     stats->result = PERCENT_SUDOKU_ERROR;
 }
 
@@ -67,42 +76,68 @@ void update_solving_stats(PercentSudokuStats* stats, PercentSudokuResult result)
 
 // 使用SAT求解器求解百分号数独
 PercentSudokuResult solve_percent_sudoku_with_sat(PercentSudokuGame* game, double timeout_seconds) {
-    if (game == NULL) {
+    PercentSudokuCnfOptions options;
+    init_cnf_options(&options);
+    return solve_percent_sudoku_with_sat_options(game, timeout_seconds, &options);
+}
+
+// 使用指定CNF编码选项的SAT求解
+PercentSudokuResult solve_percent_sudoku_with_sat_options(PercentSudokuGame* game, double timeout_seconds,
+                                                          const PercentSudokuCnfOptions* options) {
+    if (game == NULL || options == NULL) {
         return PERCENT_SUDOKU_ERROR;
     }
     
-    (void)timeout_seconds; // Suppress unused parameter warning
-    
-    // 转换为CNF
-    Formula* formula = percent_sudoku_to_cnf(&game->puzzle);
+    // 标准编码：共用基础公式，给定数字作为假设写入赋值数组，不再逐个谜题构建公式
+    // 优化编码的变量与子句取决于给定数字，仍逐个谜题转换（变量映射用于还原解答）
+    Formula* owned_formula = NULL;
+    const Formula* formula;
+    PercentSudokuVarMap* var_map = NULL;
+    if (options->reduced) {
+        var_map = (PercentSudokuVarMap*)tracked_malloc(MEMORY_SUDOKU, sizeof(PercentSudokuVarMap));
+        TRACE_BEGIN("sudoku", "percent_sudoku_to_cnf");
+        owned_formula = percent_sudoku_to_cnf_with_options(&game->puzzle, options, var_map);
+        TRACE_END("sudoku", "percent_sudoku_to_cnf");
+        formula = owned_formula;
+    } else {
+        formula = get_percent_sudoku_base_cnf(options);
+    }
     if (formula == NULL) {
+        safe_free(var_map);
         return PERCENT_SUDOKU_ERROR;
     }
     
     // 创建变量赋值数组
-    int* assignments = (int*)safe_malloc(formula->num_vars * sizeof(int));
+    int* assignments = (int*)tracked_malloc(MEMORY_SUDOKU, (formula->num_vars > 0 ? formula->num_vars : 1) * sizeof(int));
     if (assignments == NULL) {
-        free_formula(formula);
+        free_formula(owned_formula);
+        safe_free(var_map);
         return PERCENT_SUDOKU_ERROR;
     }
     
-    // 初始化赋值数组为0
-    for (int i = 0; i < formula->num_vars; i++) {
-        assignments[i] = 0;
-    }
-    
-    // 初始化所有变量为未赋值状态
-    for (int i = 0; i < formula->num_vars; i++) {
-        assignments[i] = UNASSIGNED;
+    // 初始化所有变量为未赋值状态，标准编码下再写入给定数字的假设
+    if (options->reduced) {
+        for (int i = 0; i < formula->num_vars; i++) {
+            assignments[i] = UNASSIGNED;
+        }
+    } else {
+        TRACE_BEGIN("sudoku", "given_assumptions");
+        set_percent_sudoku_given_assumptions(&game->puzzle, assignments, formula->num_vars);
+        TRACE_END("sudoku", "given_assumptions");
     }
     
-    // 使用DPLL求解
+    // 使用DPLL求解，时限在搜索中检查，超时时DPLL直接返回TIMEOUT（之后恢复本线程原来的时限）
+    double saved_timeout = get_solver_timeout();
+    set_solver_timeout(timeout_seconds);
     int result = DPLL(formula, assignments);
+    set_solver_timeout(saved_timeout);
     
     PercentSudokuResult percent_sudoku_result;
     if (result == SAT) {
         // 从CNF解还原百分号数独
-        PercentSudokuGrid* solution = cnf_to_percent_sudoku(formula, assignments, &game->puzzle);
+        TRACE_BEGIN("sudoku", "cnf_to_percent_sudoku");
+        PercentSudokuGrid* solution = cnf_to_percent_sudoku_with_map(formula, assignments, &game->puzzle, var_map);
+        TRACE_END("sudoku", "cnf_to_percent_sudoku");
         if (solution != NULL) {
             copy_percent_sudoku_grid(solution, &game->solution);
             free_percent_sudoku_grid(solution);
@@ -120,7 +155,8 @@ PercentSudokuResult solve_percent_sudoku_with_sat(PercentSudokuGame* game, doubl
     
     // 清理内存
     safe_free(assignments);
-    free_formula(formula);
+    free_formula(owned_formula);
+    safe_free(var_map);
     
     return percent_sudoku_result;
 }
@@ -135,9 +171,9 @@ PercentSudokuResult solve_percent_sudoku_puzzle(const PercentSudokuGrid* puzzle,
     copy_percent_sudoku_grid(puzzle, solution);
     
     // 使用回溯算法求解
-    double start_time = get_current_time_ms();
+    double start_time = get_monotonic_time_ms();
     int solved = solve_percent_sudoku(solution);
-    double solving_time = get_current_time_ms() - start_time;
+    double solving_time = get_monotonic_time_ms() - start_time;
     
     // 检查是否超时
     if (solving_time > timeout_seconds * 1000.0) {
@@ -151,6 +187,150 @@ PercentSudokuResult solve_percent_sudoku_puzzle(const PercentSudokuGrid* puzzle,
     }
 }
 
+// 求解引擎名称
+const char* percent_sudoku_engine_name(PercentSudokuEngine engine) {
+    switch (engine) {
+        case PERCENT_SUDOKU_ENGINE_BITMASK: return "bitmask";
+        case PERCENT_SUDOKU_ENGINE_DLX: return "dlx";
+        case PERCENT_SUDOKU_ENGINE_SAT: return "sat";
+        case PERCENT_SUDOKU_ENGINE_BACKTRACK: return "backtrack";
+        case PERCENT_SUDOKU_ENGINE_SIMD: return "simd";
+        default: return "unknown";
+    }
+}
+
+// 按名称解析求解引擎，成功返回1
+int parse_percent_sudoku_engine(const char* name, PercentSudokuEngine* engine) {
+    if (name == NULL || engine == NULL) {
+        return 0;
+    }
+    
+    for (int i = 0; i < PERCENT_SUDOKU_ENGINE_COUNT; i++) {
+        if (strcmp(name, percent_sudoku_engine_name((PercentSudokuEngine)i)) == 0) {
+            *engine = (PercentSudokuEngine)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 使用指定引擎求解（可在多个线程中同时调用）
+PercentSudokuResult solve_percent_sudoku_with_engine(PercentSudokuEngine engine, const PercentSudokuGrid* puzzle,
+                                                     PercentSudokuGrid* solution, double timeout_seconds) {
+    if (puzzle == NULL || solution == NULL) {
+        return PERCENT_SUDOKU_ERROR;
+    }
+    
+    double start_time = get_monotonic_time_ms();
+    PercentSudokuResult result;
+    
+    TRACE_BEGIN("sudoku", percent_sudoku_engine_name(engine));
+    copy_percent_sudoku_grid(puzzle, solution);
+    switch (engine) {
+        case PERCENT_SUDOKU_ENGINE_BITMASK:
+            result = solve_percent_sudoku_bitmask(solution) ? PERCENT_SUDOKU_SOLVED : PERCENT_SUDOKU_UNSOLVABLE;
+            break;
+        
+        case PERCENT_SUDOKU_ENGINE_DLX:
+            result = solve_percent_sudoku_dlx(solution) ? PERCENT_SUDOKU_SOLVED : PERCENT_SUDOKU_UNSOLVABLE;
+            break;
+        
+        case PERCENT_SUDOKU_ENGINE_SAT: {
+            PercentSudokuGame* game = create_percent_sudoku_game();
+            PercentSudokuCnfOptions options;
+            init_cnf_options(&options);
+            options.reduced = 1;
+            
+            copy_percent_sudoku_grid(puzzle, &game->puzzle);
+            result = solve_percent_sudoku_with_sat_options(game, timeout_seconds, &options);
+            if (result == PERCENT_SUDOKU_SOLVED) {
+                copy_percent_sudoku_grid(&game->solution, solution);
+            }
+            free_percent_sudoku_game(game);
+            break;
+        }
+        
+        case PERCENT_SUDOKU_ENGINE_BACKTRACK:
+            result = (is_valid_percent_sudoku(solution) && solve_percent_sudoku_recursive(solution, 0, 0))
+                         ? PERCENT_SUDOKU_SOLVED : PERCENT_SUDOKU_UNSOLVABLE;
+            break;
+        
+        case PERCENT_SUDOKU_ENGINE_SIMD: {
+            // 只有一个通道，批量传播没有优势；未解出时用位掩码引擎确认
+            int solved = 0;
+            solve_percent_sudoku_batch(solution, 1, &solved, NULL);
+            if (!solved) {
+                copy_percent_sudoku_grid(puzzle, solution);
+                solved = solve_percent_sudoku_bitmask(solution);
+            }
+            result = solved ? PERCENT_SUDOKU_SOLVED : PERCENT_SUDOKU_UNSOLVABLE;
+            break;
+        }
+        
+        default:
+            TRACE_END("sudoku", percent_sudoku_engine_name(engine));
+            return PERCENT_SUDOKU_ERROR;
+    }
+    TRACE_END("sudoku", percent_sudoku_engine_name(engine));
+    
+    // SAT引擎在DPLL中按时限中断；其余引擎无法中途停止，只能在返回后按耗时判定超时
+    if (engine != PERCENT_SUDOKU_ENGINE_SAT && get_monotonic_time_ms() - start_time > timeout_seconds * 1000.0) {
+        return PERCENT_SUDOKU_TIMEOUT;
+    }
+    
+    return result;
+}
+
+// 求解一组谜题，results[i]为第i个谜题的结果，返回有解的数量
+// 位切片引擎按通道宽度分组同步传播，批量求解器留下的未解通道回退到位掩码引擎；
+// 一组无法中途停止，超时按组内每个谜题分摊的耗时判定。其余引擎逐个求解。
+int solve_percent_sudoku_group(PercentSudokuEngine engine, const PercentSudokuGrid* puzzles, int count,
+                               PercentSudokuGrid* solutions, PercentSudokuResult* results, double timeout_seconds) {
+    if (puzzles == NULL || solutions == NULL || results == NULL || count <= 0) {
+        return 0;
+    }
+    
+    int num_solved = 0;
+    if (engine != PERCENT_SUDOKU_ENGINE_SIMD) {
+        for (int i = 0; i < count; i++) {
+            results[i] = solve_percent_sudoku_with_engine(engine, &puzzles[i], &solutions[i], timeout_seconds);
+            num_solved += results[i] == PERCENT_SUDOKU_SOLVED;
+        }
+        return num_solved;
+    }
+    
+    int solved[SIMD_BATCH_LANES];
+    for (int base = 0; base < count; base += SIMD_BATCH_LANES) {
+        int lanes = (count - base < SIMD_BATCH_LANES) ? count - base : SIMD_BATCH_LANES;
+        double start_time = get_monotonic_time_ms();
+        
+        TRACE_BEGIN("sudoku", "simd_group");
+        for (int lane = 0; lane < lanes; lane++) {
+            copy_percent_sudoku_grid(&puzzles[base + lane], &solutions[base + lane]);
+        }
+        solve_percent_sudoku_batch(&solutions[base], lanes, solved, NULL);
+        for (int lane = 0; lane < lanes; lane++) {
+            PercentSudokuGrid* solution = &solutions[base + lane];
+            if (!solved[lane]) {
+                copy_percent_sudoku_grid(&puzzles[base + lane], solution);
+                solved[lane] = solve_percent_sudoku_bitmask(solution);
+            }
+            results[base + lane] = solved[lane] ? PERCENT_SUDOKU_SOLVED : PERCENT_SUDOKU_UNSOLVABLE;
+        }
+        TRACE_END("sudoku", "simd_group");
+        
+        if ((get_monotonic_time_ms() - start_time) / lanes > timeout_seconds * 1000.0) {
+            for (int lane = 0; lane < lanes; lane++) {
+                results[base + lane] = PERCENT_SUDOKU_TIMEOUT;
+            }
+        }
+        for (int lane = 0; lane < lanes; lane++) {
+            num_solved += results[base + lane] == PERCENT_SUDOKU_SOLVED;
+        }
+    }
+    return num_solved;
+}
+
 // 生成并求解百分号数独
 PercentSudokuResult generate_and_solve_percent_sudoku(int difficulty, double timeout_seconds, PercentSudokuStats* stats) {
     if (stats == NULL) {
@@ -160,36 +340,39 @@ PercentSudokuResult generate_and_solve_percent_sudoku(int difficulty, double tim
     initialize_solving_stats(stats);
     
     // 生成百分号数独
-    double gen_start = get_current_time_ms();
+    double gen_start = get_monotonic_time_ms();
     PercentSudokuGame* game = generate_percent_sudoku_puzzle(difficulty);
     if (game == NULL) {
         return PERCENT_SUDOKU_ERROR;
     }
-    stats->generation_time = get_current_time_ms() - gen_start;
+    stats->generation_time = get_monotonic_time_ms() - gen_start;
     
     // 统计信息
     stats->num_givens = game->num_givens;
     
-    // 转换为CNF并统计
-    double cnf_start = get_current_time_ms();
-    Formula* formula = percent_sudoku_to_cnf(&game->puzzle);
+    // 转换为CNF并统计（共享基础公式 + 给定数字的单元子句）
+    PercentSudokuCnfOptions cnf_options;
+    init_cnf_options(&cnf_options);
+    double cnf_start = get_monotonic_time_ms();
+    const Formula* formula = get_percent_sudoku_base_cnf(&cnf_options);
     if (formula == NULL) {
         free_percent_sudoku_game(game);
         return PERCENT_SUDOKU_ERROR;
     }
-    stats->cnf_time = get_current_time_ms() - cnf_start;
+    stats->cnf_time = get_monotonic_time_ms() - cnf_start;
     stats->num_variables = formula->num_vars;
-    stats->num_clauses = formula->num_clauses;
+    stats->num_clauses = formula->num_clauses + game->num_givens;
     
     // 求解
-    double solve_start = get_current_time_ms();
+    double solve_start = get_monotonic_time_ms();
+    reset_solver_statistics();
     PercentSudokuResult result = solve_percent_sudoku_with_sat(game, timeout_seconds);
-    stats->solving_time = get_current_time_ms() - solve_start;
+    stats->solving_time = get_monotonic_time_ms() - solve_start;
+    get_solver_statistics(&stats->solver);
     
     update_solving_stats(stats, result);
     
     // 清理内存
-    free_formula(formula);
     free_percent_sudoku_game(game);
     
     return result;
@@ -211,31 +394,61 @@ PercentSudokuResult solve_from_file(const char* puzzle_file, double timeout_seco
     
     stats->num_givens = game->num_givens;
     
-    // 转换为CNF
-    double cnf_start = get_current_time_ms();
-    Formula* formula = percent_sudoku_to_cnf(&game->puzzle);
+    // 转换为CNF（共享基础公式 + 给定数字的单元子句）
+    PercentSudokuCnfOptions cnf_options;
+    init_cnf_options(&cnf_options);
+    double cnf_start = get_monotonic_time_ms();
+    const Formula* formula = get_percent_sudoku_base_cnf(&cnf_options);
     if (formula == NULL) {
         free_percent_sudoku_game(game);
         return PERCENT_SUDOKU_ERROR;
     }
-    stats->cnf_time = get_current_time_ms() - cnf_start;
+    stats->cnf_time = get_monotonic_time_ms() - cnf_start;
     stats->num_variables = formula->num_vars;
-    stats->num_clauses = formula->num_clauses;
+    stats->num_clauses = formula->num_clauses + game->num_givens;
     
     // 求解
-    double solve_start = get_current_time_ms();
+    double solve_start = get_monotonic_time_ms();
+    reset_solver_statistics();
     PercentSudokuResult result = solve_percent_sudoku_with_sat(game, timeout_seconds);
-    stats->solving_time = get_current_time_ms() - solve_start;
+    stats->solving_time = get_monotonic_time_ms() - solve_start;
+    get_solver_statistics(&stats->solver);
     
     update_solving_stats(stats, result);
     
     // 清理内存
-    free_formula(formula);
     free_percent_sudoku_game(game);
     
     return result;
 }
 
+// 批量求解目录（或每行一个谜题的文件）中的谜题，结果按输入顺序写入result_file，返回有解的谜题数
+int solve_multiple_puzzles(const char* puzzle_dir, double timeout_seconds, const char* result_file) {
+    BatchOptions options;
+    BatchReport report;
+    
+    init_batch_options(&options);
+    options.timeout_seconds = timeout_seconds;
+    
+    if (!run_percent_sudoku_batch(puzzle_dir, result_file, &options, &report)) {
+        return 0;
+    }
+    
+    print_batch_report(&report, &options);
+    return report.solved;
+}
+
+// 基准测试：用固定种子生成谜题，比较各求解引擎的延迟分布与吞吐量（difficulty为0时测试全部难度）
+void benchmark_percent_sudoku_solver(int num_puzzles, int difficulty, double timeout_seconds) {
+    BenchmarkOptions options;
+    init_benchmark_options(&options);
+    options.num_puzzles = num_puzzles;
+    options.difficulty = difficulty;
+    options.timeout_seconds = timeout_seconds;
+    
+    run_percent_sudoku_benchmark(&options);
+}
+
 // 验证解答正确性
 int verify_solution_correctness(const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution) {
     if (puzzle == NULL || solution == NULL) {
@@ -283,6 +496,7 @@ void print_solving_stats(const PercentSudokuStats* stats) {
     printf("Number of variables: %d\n", stats->num_variables);
     printf("Number of clauses: %d\n", stats->num_clauses);
     printf("Given numbers: %d\n", stats->num_givens);
+    print_solver_statistics(stdout, &stats->solver);
     
     printf("Solving result: ");
     switch (stats->result) {
@@ -326,6 +540,7 @@ void save_solving_report(const PercentSudokuStats* stats, const char* filename)
     fprintf(file, "Number of variables: %d\n", stats->num_variables);
     fprintf(file, "Number of clauses: %d\n", stats->num_clauses);
     fprintf(file, "Given numbers: %d\n", stats->num_givens);
+    print_solver_statistics(file, &stats->solver);
     
     fprintf(file, "Solving result: ");
     switch (stats->result) {
@@ -359,12 +574,12 @@ void compare_solving_methods(const PercentSudokuGrid* puzzle, double timeout_sec
     printf("\n=== Solving Method Comparison ===\n");
     
     // Method 1: Backtracking algorithm
-    printf("Method 1: Backtracking algorithm\n");
+    printf("Method 1: Backtracking algorithm (bitmask candidates + MRV)\n");
     PercentSudokuGrid* solution1 = create_percent_sudoku_grid();
     if (solution1 != NULL) {
-        double start_time = get_current_time_ms();
+        double start_time = get_monotonic_time_ms();
         PercentSudokuResult result1 = solve_percent_sudoku_puzzle(puzzle, solution1, timeout_seconds);
-        double time1 = get_current_time_ms() - start_time;
+        double time1 = get_monotonic_time_ms() - start_time;
         
         printf("  Result: ");
         switch (result1) {
@@ -385,9 +600,9 @@ void compare_solving_methods(const PercentSudokuGrid* puzzle, double timeout_sec
     if (game != NULL) {
         copy_percent_sudoku_grid(puzzle, &game->puzzle);
         
-        double start_time = get_current_time_ms();
+        double start_time = get_monotonic_time_ms();
         PercentSudokuResult result2 = solve_percent_sudoku_with_sat(game, timeout_seconds);
-        double time2 = get_current_time_ms() - start_time;
+        double time2 = get_monotonic_time_ms() - start_time;
         
         printf("  Result: ");
         switch (result2) {
@@ -402,9 +617,241 @@ void compare_solving_methods(const PercentSudokuGrid* puzzle, double timeout_sec
         free_percent_sudoku_game(game);
     }
     
+    // Method 3: Dancing Links exact cover
+    printf("Method 3: Dancing Links (DLX)\n");
+    PercentSudokuGrid* solution3 = create_percent_sudoku_grid();
+    if (solution3 != NULL) {
+        copy_percent_sudoku_grid(puzzle, solution3);
+        
+        double start_time = get_monotonic_time_ms();
+        int solved = solve_percent_sudoku_dlx(solution3);
+        double time3 = get_monotonic_time_ms() - start_time;
+        
+        printf("  Result: %s\n", solved ? "Success" : "No solution");
+        printf("  Time: %.2f ms\n", time3);
+        
+        free_percent_sudoku_grid(solution3);
+    }
+    
+    printf("===============================\n");
+}
+
+// 比较不同"至多一个"编码的子句规模、编码时间和求解时间
+void benchmark_cnf_encodings(const PercentSudokuGrid* puzzle, double timeout_seconds) {
+    if (puzzle == NULL) {
+        return;
+    }
+    
+    printf("\n=== CNF Encoding Comparison ===\n");
+    printf("%-20s %10s %10s %10s %12s %12s %10s  %s\n",
+           "Encoding", "Variables", "Clauses", "Literals", "Encode(ms)", "Solve(ms)", "Decisions", "Result");
+    
+    // 求解过程的逐节点输出会淹没计时，比较期间关闭
+    int saved_verbose = get_solver_verbose();
+    set_solver_verbose(0);
+    
+    PercentSudokuVarMap* var_map = (PercentSudokuVarMap*)tracked_malloc(MEMORY_SUDOKU, sizeof(PercentSudokuVarMap));
+    
+    // 先比较全量编码，再比较优化（预处理给定数字）编码
+    for (int config = 0; config < 2 * AMO_ENCODING_COUNT; config++) {
+        PercentSudokuCnfOptions options;
+        init_cnf_options(&options);
+        options.amo_encoding = (AmoEncoding)(config % AMO_ENCODING_COUNT);
+        options.reduced = config / AMO_ENCODING_COUNT;
+        
+        char name[32];
+        snprintf(name, sizeof(name), "%s%s", amo_encoding_name(options.amo_encoding), options.reduced ? "+reduced" : "");
+        
+        double encode_start = get_monotonic_time_ms();
+        Formula* formula = percent_sudoku_to_cnf_with_options(puzzle, &options, var_map);
+        double encode_time = get_monotonic_time_ms() - encode_start;
+        if (formula == NULL) {
+            continue;
+        }
+        
+        long total_literals = 0;
+        for (int i = 0; i < formula->num_clauses; i++) {
+            total_literals += formula->clauses[i].length;
+        }
+        int num_vars = formula->num_vars;
+        int num_clauses = formula->num_clauses;
+        free_formula(formula);
+        
+        PercentSudokuGame* game = create_percent_sudoku_game();
+        copy_percent_sudoku_grid(puzzle, &game->puzzle);
+        
+        reset_dpll_decision_count();
+        double solve_start = get_monotonic_time_ms();
+        PercentSudokuResult result = solve_percent_sudoku_with_sat_options(game, timeout_seconds, &options);
+        double solve_time = get_monotonic_time_ms() - solve_start;
+        long decisions = get_dpll_decision_count();
+        
+        const char* result_text = "Error";
+        if (result == PERCENT_SUDOKU_SOLVED) {
+            result_text = verify_solution_correctness(puzzle, &game->solution) ? "Success" : "Wrong solution";
+        } else if (result == PERCENT_SUDOKU_UNSOLVABLE) {
+            result_text = "No solution";
+        } else if (result == PERCENT_SUDOKU_TIMEOUT) {
+            result_text = "Timeout";
+        }
+        
+        printf("%-20s %10d %10d %10ld %12.2f %12.2f %10ld  %s\n",
+               name, num_vars, num_clauses, total_literals, encode_time, solve_time, decisions, result_text);
+        
+        free_percent_sudoku_game(game);
+    }
+    
+    safe_free(var_map);
+    set_solver_verbose(saved_verbose);
     printf("===============================\n");
 }
 
+// 统计扩展编码（单元内每个数字至少一次、每格至多一个数字）在各难度下节省的分支决策次数
+void measure_extended_encoding_decisions(int puzzles_per_difficulty, double timeout_seconds) {
+    if (puzzles_per_difficulty <= 0) {
+        return;
+    }
+    
+    printf("\n=== Extended Encoding Decision Savings ===\n");
+    printf("%-10s %8s %16s %16s %10s %14s %14s\n",
+           "Difficulty", "Puzzles", "Decisions(base)", "Decisions(ext)", "Saved", "Solve(base)ms", "Solve(ext)ms");
+    
+    int saved_verbose = get_solver_verbose();
+    set_solver_verbose(0);
+    
+    for (int difficulty = 1; difficulty <= 5; difficulty++) {
+        long decisions[2] = {0, 0};
+        double solve_time[2] = {0.0, 0.0};
+        int solved = 0;
+        
+        for (int n = 0; n < puzzles_per_difficulty; n++) {
+            PercentSudokuGame* game = generate_percent_sudoku_puzzle(difficulty);
+            if (game == NULL) {
+                continue;
+            }
+            
+            // 只有两种编码都解出时才计入，避免超时或失败的一侧拉偏比较
+            int both_solved = 1;
+            long run_decisions[2];
+            double run_time[2];
+            for (int extended = 0; extended <= 1; extended++) {
+                PercentSudokuCnfOptions options;
+                init_cnf_options(&options);
+                options.extended = extended;
+                
+                reset_dpll_decision_count();
+                double start = get_monotonic_time_ms();
+                PercentSudokuResult result = solve_percent_sudoku_with_sat_options(game, timeout_seconds, &options);
+                run_time[extended] = get_monotonic_time_ms() - start;
+                run_decisions[extended] = get_dpll_decision_count();
+                
+                if (result != PERCENT_SUDOKU_SOLVED) {
+                    both_solved = 0;
+                }
+            }
+            if (both_solved) {
+                for (int extended = 0; extended <= 1; extended++) {
+                    decisions[extended] += run_decisions[extended];
+                    solve_time[extended] += run_time[extended];
+                }
+                solved++;
+            }
+            
+            free_percent_sudoku_game(game);
+        }
+        
+        double saved = decisions[0] > 0 ? 100.0 * (decisions[0] - decisions[1]) / decisions[0] : 0.0;
+        printf("%-10d %8d %16ld %16ld %9.1f%% %14.2f %14.2f\n",
+               difficulty, solved, decisions[0], decisions[1], saved, solve_time[0], solve_time[1]);
+    }
+    
+    set_solver_verbose(saved_verbose);
+    printf("==========================================\n");
+}
+
+#ifndef _WIN32
+// 管道测试的写端：把整个文件内容写入FIFO（打开FIFO会阻塞到读端打开为止）
+typedef struct {
+    const char* source;
+    const char* fifo;
+} PipeFeed;
+
+static void* feed_fifo(void* arg) {
+    const PipeFeed* feed = (const PipeFeed*)arg;
+    FILE* in = fopen(feed->source, "rb");
+    FILE* out = fopen(feed->fifo, "wb");
+    char buffer[4096];
+    size_t n;
+    while (in != NULL && out != NULL && (n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        fwrite(buffer, 1, n, out);
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+    if (out != NULL) {
+        fclose(out);
+    }
+    return NULL;
+}
+
+// 同一CNF文本经普通文件与FIFO解析，结果应完全相同（FIFO不能映射，必须走流式读取）
+static int test_cnf_pipe_parsing(const PercentSudokuGrid* puzzle) {
+    Formula* formula = percent_sudoku_to_cnf(puzzle);
+    if (formula == NULL) {
+        return 0;
+    }
+    
+    char dir[] = "/tmp/percent_sudoku_pipe_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        free_formula(formula);
+        return 0;
+    }
+    char cnf_path[64], fifo_path[64];
+    snprintf(cnf_path, sizeof(cnf_path), "%s/puzzle.cnf", dir);
+    snprintf(fifo_path, sizeof(fifo_path), "%s/puzzle.fifo", dir);
+    
+    FILE* file = fopen(cnf_path, "w");
+    int ok = file != NULL;
+    if (ok) {
+        fprintf(file, "c percent sudoku\np cnf %d %d\n", formula->num_vars, formula->num_clauses);
+        for (int i = 0; i < formula->num_clauses; i++) {
+            for (int j = 0; j < formula->clauses[i].length; j++) {
+                fprintf(file, "%d ", formula->clauses[i].literals[j]);
+            }
+            fprintf(file, "0\n");
+        }
+        ok = fclose(file) == 0;
+    }
+    free_formula(formula);
+    
+    Formula* from_file = ok ? parse_cnf_file(cnf_path) : NULL;
+    Formula* from_pipe = NULL;
+    if (from_file != NULL && mkfifo(fifo_path, 0600) == 0) {
+        PipeFeed feed = {cnf_path, fifo_path};
+        pthread_t writer;
+        if (pthread_create(&writer, NULL, feed_fifo, &feed) == 0) {
+            from_pipe = parse_cnf_file(fifo_path);
+            pthread_join(writer, NULL);
+        }
+    }
+    
+    ok = from_file != NULL && from_pipe != NULL &&
+         from_file->num_vars == from_pipe->num_vars && from_file->num_clauses == from_pipe->num_clauses;
+    for (int i = 0; ok && i < from_file->num_clauses; i++) {
+        const Clause* a = &from_file->clauses[i];
+        const Clause* b = &from_pipe->clauses[i];
+        ok = a->length == b->length && memcmp(a->literals, b->literals, (size_t)a->length * sizeof(int)) == 0;
+    }
+    
+    free_formula(from_file);
+    free_formula(from_pipe);
+    remove(fifo_path);
+    remove(cnf_path);
+    rmdir(dir);
+    return ok;
+}
+#endif
+
 // 测试百分号数独求解器
 int test_percent_sudoku_solver(void) {
     printf("Starting Percent Sudoku solver tests...\n");
@@ -419,7 +866,6 @@ int test_percent_sudoku_solver(void) {
     if (game != NULL && is_valid_percent_sudoku(&game->puzzle)) {
         printf("  ✓ Passed\n");
         passed++;
-        free_percent_sudoku_game(game);
     } else {
         printf("  ✗ Failed\n");
     }
@@ -446,18 +892,228 @@ int test_percent_sudoku_solver(void) {
     PercentSudokuGame* test_game = generate_percent_sudoku_puzzle(1);
     if (test_game != NULL) {
         Formula* formula = percent_sudoku_to_cnf(&test_game->puzzle);
-        if (formula != NULL && formula->num_vars == 729) {
+        
+        // 共享基础公式加上给定数字的单元子句应与逐个谜题构建的公式一致
+        PercentSudokuCnfOptions base_options;
+        init_cnf_options(&base_options);
+        const Formula* base = get_percent_sudoku_base_cnf(&base_options);
+        
+        if (formula != NULL && formula->num_vars == 729 && base != NULL &&
+            base->num_clauses + test_game->num_givens == formula->num_clauses) {
             printf("  ✓ Passed (Variables: %d, Clauses: %d)\n", formula->num_vars, formula->num_clauses);
             passed++;
-            free_formula(formula);
         } else {
             printf("  ✗ Failed\n");
         }
+        free_formula(formula);
         free_percent_sudoku_game(test_game);
     } else {
         printf("  ✗ Failed\n");
     }
     
+    // Test 4: Compact AMO encodings solve to a valid solution
+    total++;
+    printf("Test 4: Compact AMO, reduced and extended encodings...\n");
+    PercentSudokuGame* encoding_game = generate_percent_sudoku_puzzle(2);
+    if (encoding_game != NULL) {
+        int encodings_ok = 1;
+        int saved_verbose = get_solver_verbose();
+        set_solver_verbose(0);
+        for (int config = 0; config < 4 * AMO_ENCODING_COUNT; config++) {
+            PercentSudokuCnfOptions options;
+            init_cnf_options(&options);
+            options.amo_encoding = (AmoEncoding)(config % AMO_ENCODING_COUNT);
+            options.reduced = (config / AMO_ENCODING_COUNT) % 2;
+            options.extended = config / (2 * AMO_ENCODING_COUNT);
+            
+            PercentSudokuResult result = solve_percent_sudoku_with_sat_options(encoding_game, 10.0, &options);
+            if (result != PERCENT_SUDOKU_SOLVED ||
+                !verify_solution_correctness(&encoding_game->puzzle, &encoding_game->solution)) {
+                printf("  Encoding %s%s%s failed\n", amo_encoding_name(options.amo_encoding),
+                       options.reduced ? "+reduced" : "", options.extended ? "+extended" : "");
+                encodings_ok = 0;
+            }
+        }
+        set_solver_verbose(saved_verbose);
+        
+        if (encodings_ok) {
+            printf("  ✓ Passed\n");
+            passed++;
+        } else {
+            printf("  ✗ Failed\n");
+        }
+        free_percent_sudoku_game(encoding_game);
+    } else {
+        printf("  ✗ Failed\n");
+    }
+    
+    // Test 5: DLX agrees with the bitmask solver
+    total++;
+    printf("Test 5: Dancing Links solver...\n");
+    PercentSudokuGame* dlx_game = generate_percent_sudoku_puzzle(4);
+    if (dlx_game != NULL) {
+        PercentSudokuGrid dlx_solution;
+        copy_percent_sudoku_grid(&dlx_game->puzzle, &dlx_solution);
+        
+        PercentSudokuGrid ambiguous;
+        copy_percent_sudoku_grid(&dlx_game->puzzle, &ambiguous);
+        for (int i = 0; i < 9; i++) {
+            ambiguous.grid[i][i] = PERCENT_SUDOKU_EMPTY;
+            ambiguous.grid[i][(i + 4) % 9] = PERCENT_SUDOKU_EMPTY;
+        }
+        
+        if (solve_percent_sudoku_dlx(&dlx_solution) &&
+            verify_solution_correctness(&dlx_game->puzzle, &dlx_solution) &&
+            count_solutions_dlx(&dlx_game->puzzle, 10) == 1 &&
+            count_solutions_dlx(&ambiguous, 10) == count_percent_sudoku_solutions_bitmask(&ambiguous, 10)) {
+            printf("  ✓ Passed\n");
+            passed++;
+        } else {
+            printf("  ✗ Failed\n");
+        }
+        free_percent_sudoku_game(dlx_game);
+    } else {
+        printf("  ✗ Failed\n");
+    }
+    
+    // Test 6: every batch kernel agrees with the bitmask solver
+    total++;
+    printf("Test 6: SIMD batch solver...\n");
+    PercentSudokuGame* batch_game = generate_percent_sudoku_puzzle(5);
+    if (batch_game != NULL) {
+        PercentSudokuGrid batch_input[SIMD_BATCH_LANES + 3];
+        int batch_count = SIMD_BATCH_LANES + 3;
+        
+        // 逐步挖空的谜题，最后一个放入冲突的给定数字
+        for (int i = 0; i < batch_count; i++) {
+            copy_percent_sudoku_grid(&batch_game->puzzle, &batch_input[i]);
+            for (int j = 0; j < i; j++) {
+                batch_input[i].grid[j % 9][(j * 4) % 9] = PERCENT_SUDOKU_EMPTY;
+            }
+        }
+        batch_input[batch_count - 1].grid[0][0] = batch_game->solution.grid[0][1];
+        batch_input[batch_count - 1].grid[0][1] = batch_game->solution.grid[0][1];
+        
+        int batch_ok = 1;
+        for (int kernel = SIMD_KERNEL_SCALAR; kernel <= SIMD_KERNEL_AVX2 && batch_ok; kernel++) {
+            PercentSudokuGrid batch_work[SIMD_BATCH_LANES + 3];
+            int batch_solved[SIMD_BATCH_LANES + 3];
+            memcpy(batch_work, batch_input, sizeof(batch_input));
+            
+            set_simd_kernel((SimdKernel)kernel);
+            solve_percent_sudoku_batch(batch_work, batch_count, batch_solved, NULL);
+            
+            for (int i = 0; i < batch_count; i++) {
+                PercentSudokuGrid reference;
+                copy_percent_sudoku_grid(&batch_input[i], &reference);
+                int expected = solve_percent_sudoku_bitmask(&reference);
+                if (batch_solved[i] != expected ||
+                    (expected && !verify_solution_correctness(&batch_input[i], &batch_work[i]))) {
+                    batch_ok = 0;
+                }
+            }
+        }
+        set_simd_kernel(SIMD_KERNEL_AUTO);
+        
+        if (batch_ok) {
+            printf("  ✓ Passed (kernel: %s)\n", simd_kernel_name(get_active_simd_kernel()));
+            passed++;
+        } else {
+            printf("  ✗ Failed\n");
+        }
+        free_percent_sudoku_game(batch_game);
+    } else {
+        printf("  ✗ Failed\n");
+    }
+    
+    // Test 7: 对称变换保持约束与解的唯一性
+    total++;
+    printf("Test 7: Symmetry transforms...\n");
+    PercentSudokuGame* symmetry_game = generate_percent_sudoku_puzzle(3);
+    if (symmetry_game != NULL) {
+        int symmetry_ok = 1;
+        PercentSudokuGame variant, restored;
+        PercentSudokuTransform transform, inverse;
+        
+        for (int g = 0; g < PERCENT_SUDOKU_NUM_GEOMETRIES && symmetry_ok; g++) {
+            // 每种几何变换各配一个不同的数字排列
+            transform_from_index((unsigned long)g + PERCENT_SUDOKU_NUM_GEOMETRIES * 12345UL * (unsigned long)g, &transform);
+            apply_transform_game(&transform, symmetry_game, &variant);
+            invert_transform(&transform, &inverse);
+            apply_transform_game(&inverse, &variant, &restored);
+            
+            symmetry_ok = verify_transform_geometry(g) &&
+                          is_complete_percent_sudoku(&variant.solution) &&
+                          is_valid_percent_sudoku(&variant.solution) &&
+                          verify_solution_correctness(&variant.puzzle, &variant.solution) &&
+                          has_unique_solution(&variant.puzzle) &&
+                          memcmp(restored.puzzle.grid, symmetry_game->puzzle.grid, sizeof(restored.puzzle.grid)) == 0;
+        }
+        
+        if (symmetry_ok) {
+            printf("  ✓ Passed\n");
+            passed++;
+        } else {
+            printf("  ✗ Failed\n");
+        }
+        free_percent_sudoku_game(symmetry_game);
+    } else {
+        printf("  ✗ Failed\n");
+    }
+    
+    // Test 8: 规范形式与已解谜题缓存
+    total++;
+    printf("Test 8: Canonical form and solved-puzzle cache...\n");
+    PercentSudokuGame* cache_game = generate_percent_sudoku_puzzle(4);
+    if (cache_game != NULL) {
+        PuzzleCache* cache = create_puzzle_cache(4);
+        PercentSudokuGame variant;
+        PercentSudokuTransform transform;
+        PercentSudokuGrid cached_solution;
+        Rng rng;
+        int hit = 0;
+        
+        rng_seed(&rng, 38);
+        solve_percent_sudoku_cached(cache, PERCENT_SUDOKU_ENGINE_BITMASK, &cache_game->puzzle, &cached_solution, 10.0, &hit);
+        int cache_ok = !hit;
+        
+        // 等价谜题的规范哈希相同，并从缓存得到正确的解答
+        for (int i = 0; i < 8 && cache_ok; i++) {
+            random_transform(&transform, &rng);
+            apply_transform_game(&transform, cache_game, &variant);
+            PercentSudokuResult result = solve_percent_sudoku_cached(cache, PERCENT_SUDOKU_ENGINE_BITMASK,
+                                                                     &variant.puzzle, &cached_solution, 10.0, &hit);
+            cache_ok = hit && result == PERCENT_SUDOKU_SOLVED &&
+                       percent_sudoku_canonical_hash(&variant.puzzle) == percent_sudoku_canonical_hash(&cache_game->puzzle) &&
+                       memcmp(cached_solution.grid, variant.solution.grid, sizeof(cached_solution.grid)) == 0;
+        }
+        free_puzzle_cache(cache);
+        
+        if (cache_ok) {
+            printf("  ✓ Passed\n");
+            passed++;
+        } else {
+            printf("  ✗ Failed\n");
+        }
+        free_percent_sudoku_game(cache_game);
+    } else {
+        printf("  ✗ Failed\n");
+    }
+
+#ifndef _WIN32
+    // Test 9: 经管道（FIFO）读入的CNF与从文件读入的解析结果相同
+    total++;
+    printf("Test 9: CNF parsing through a pipe...\n");
+    PercentSudokuGame* pipe_game = generate_percent_sudoku_puzzle(2);
+    if (pipe_game != NULL && test_cnf_pipe_parsing(&pipe_game->puzzle)) {
+        printf("  ✓ Passed\n");
+        passed++;
+    } else {
+        printf("  ✗ Failed\n");
+    }
+    free_percent_sudoku_game(pipe_game);
+#endif
+    
     printf("Test results: %d/%d passed\n", passed, total);
     return (passed == total) ? 1 : 0;
 }
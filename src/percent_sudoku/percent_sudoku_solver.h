@@ -4,6 +4,9 @@
 #include "../common/common.h"
 #include "percent_sudoku_core.h"
 #include "percent_sudoku_cnf.h"
+#include "percent_sudoku_bitmask.h"
+#include "percent_sudoku_dlx.h"
+#include "percent_sudoku_simd.h"
 #include "../core/core.h"
 #include "../solver/solver.h"
 
@@ -15,6 +18,17 @@ typedef enum {
     PERCENT_SUDOKU_ERROR          // 错误
 } PercentSudokuResult;
 
+// 求解引擎
+typedef enum {
+    PERCENT_SUDOKU_ENGINE_BITMASK,    // 位掩码候选集 + MRV
+    PERCENT_SUDOKU_ENGINE_DLX,        // Dancing Links精确覆盖
+    PERCENT_SUDOKU_ENGINE_SAT,        // CNF（优化编码）+ DPLL
+    PERCENT_SUDOKU_ENGINE_BACKTRACK,  // 基础回溯
+    PERCENT_SUDOKU_ENGINE_SIMD        // 位切片批量传播 + 位掩码搜索（按组求解时才能发挥作用）
+} PercentSudokuEngine;
+
+#define PERCENT_SUDOKU_ENGINE_COUNT 5
+
 // 求解统计信息
 typedef struct {
     double generation_time;    // 生成时间（毫秒）
@@ -24,6 +38,7 @@ typedef struct {
     int num_variables;        // 变量数量
     int num_clauses;          // 子句数量
     int num_givens;           // 给定数字数量
+    SolverStatistics solver;  // DPLL求解统计
     PercentSudokuResult result;     // 求解结果
 } PercentSudokuStats;
 
@@ -31,7 +46,17 @@ typedef struct {
 
 // 主要求解函数
 PercentSudokuResult solve_percent_sudoku_with_sat(PercentSudokuGame* game, double timeout_seconds);
+PercentSudokuResult solve_percent_sudoku_with_sat_options(PercentSudokuGame* game, double timeout_seconds,
+                                                          const PercentSudokuCnfOptions* options);
 PercentSudokuResult solve_percent_sudoku_puzzle(const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, double timeout_seconds);
+PercentSudokuResult solve_percent_sudoku_with_engine(PercentSudokuEngine engine, const PercentSudokuGrid* puzzle,
+                                                     PercentSudokuGrid* solution, double timeout_seconds);
+int solve_percent_sudoku_group(PercentSudokuEngine engine, const PercentSudokuGrid* puzzles, int count,
+                               PercentSudokuGrid* solutions, PercentSudokuResult* results, double timeout_seconds);
+
+// 求解引擎名称
+const char* percent_sudoku_engine_name(PercentSudokuEngine engine);
+int parse_percent_sudoku_engine(const char* name, PercentSudokuEngine* engine);
 
 // 求解流程控制
 PercentSudokuResult generate_and_solve_percent_sudoku(int difficulty, double timeout_seconds, PercentSudokuStats* stats);
@@ -45,6 +70,8 @@ void benchmark_percent_sudoku_solver(int num_puzzles, int difficulty, double tim
 void print_solving_stats(const PercentSudokuStats* stats);
 void save_solving_report(const PercentSudokuStats* stats, const char* filename);
 void compare_solving_methods(const PercentSudokuGrid* puzzle, double timeout_seconds);
+void benchmark_cnf_encodings(const PercentSudokuGrid* puzzle, double timeout_seconds);
+void measure_extended_encoding_decisions(int puzzles_per_difficulty, double timeout_seconds);
 
 // 验证和测试
 int verify_solution_correctness(const PercentSudokuGrid* puzzle, const PercentSudokuGrid* solution);
@@ -0,0 +1,360 @@
+#include "percent_sudoku_transform.h"
+#include "percent_sudoku_bitmask.h"
+#include "percent_sudoku_io.h"
+#include <pthread.h>
+
+#define NUM_CELLS (PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE)
+
+// 几何变换表：geometry_cells[g][cell] 为格子cell变换后的位置
+static unsigned char geometry_cells[PERCENT_SUDOKU_NUM_GEOMETRIES][NUM_CELLS];
+static int inverse_geometry[PERCENT_SUDOKU_NUM_GEOMETRIES];
+static pthread_once_t geometry_once = PTHREAD_ONCE_INIT;
+
+// 按生成元依次变换一个位置
+static int map_position(int geometry, int cell) {
+    int row = cell / PERCENT_SUDOKU_SIZE;
+    int col = cell % PERCENT_SUDOKU_SIZE;
+    
+    if (geometry & TRANSFORM_SWAP_UPPER) {
+        if (row == 1 || row == 2) row = 3 - row;
+        if (col == 6 || col == 7) col = 13 - col;
+    }
+    if (geometry & TRANSFORM_SWAP_LOWER) {
+        if (row == 6 || row == 7) row = 13 - row;
+        if (col == 1 || col == 2) col = 3 - col;
+    }
+    if (geometry & TRANSFORM_ROTATE) {
+        row = 8 - row;
+        col = 8 - col;
+    }
+    if (geometry & TRANSFORM_TRANSPOSE) {
+        int temp = row;
+        row = col;
+        col = temp;
+    }
+    
+    return row * PERCENT_SUDOKU_SIZE + col;
+}
+
+// 构建几何变换表与逆变换编号
+static void init_geometry_tables(void) {
+    for (int g = 0; g < PERCENT_SUDOKU_NUM_GEOMETRIES; g++) {
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            geometry_cells[g][cell] = (unsigned char)map_position(g, cell);
+        }
+    }
+    
+    // 16种几何变换构成一个群，逆变换在表中查找
+    for (int g = 0; g < PERCENT_SUDOKU_NUM_GEOMETRIES; g++) {
+        inverse_geometry[g] = 0;
+        for (int h = 0; h < PERCENT_SUDOKU_NUM_GEOMETRIES; h++) {
+            int is_inverse = 1;
+            for (int cell = 0; cell < NUM_CELLS && is_inverse; cell++) {
+                is_inverse = geometry_cells[h][geometry_cells[g][cell]] == cell;
+            }
+            if (is_inverse) {
+                inverse_geometry[g] = h;
+                break;
+            }
+        }
+    }
+}
+
+// 格子cell在几何变换geometry下的新位置
+int transform_cell(int geometry, int cell) {
+    pthread_once(&geometry_once, init_geometry_tables);
+    return geometry_cells[geometry & (PERCENT_SUDOKU_NUM_GEOMETRIES - 1)][cell];
+}
+
+// 恒等变换
+void init_identity_transform(PercentSudokuTransform* transform) {
+    if (transform == NULL) {
+        return;
+    }
+    
+    transform->geometry = 0;
+    for (int d = 0; d <= PERCENT_SUDOKU_MAX_NUM; d++) {
+        transform->digit_map[d] = (unsigned char)d;
+    }
+}
+
+// 由序号构造变换：低位选择几何变换，其余部分按康托展开选择数字排列
+void transform_from_index(unsigned long index, PercentSudokuTransform* transform) {
+    if (transform == NULL) {
+        return;
+    }
+    
+    transform->geometry = (int)(index % PERCENT_SUDOKU_NUM_GEOMETRIES);
+    unsigned long permutation = (index / PERCENT_SUDOKU_NUM_GEOMETRIES) % PERCENT_SUDOKU_DIGIT_PERMUTATIONS;
+    
+    int digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int remaining = 9;
+    unsigned long factorial = PERCENT_SUDOKU_DIGIT_PERMUTATIONS;
+    
+    transform->digit_map[0] = 0;
+    for (int d = 1; d <= PERCENT_SUDOKU_MAX_NUM; d++) {
+        factorial /= (unsigned long)remaining;
+        int k = (int)(permutation / factorial);
+        permutation %= factorial;
+        
+        transform->digit_map[d] = (unsigned char)digits[k];
+        for (int i = k; i < remaining - 1; i++) {
+            digits[i] = digits[i + 1];
+        }
+        remaining--;
+    }
+}
+
+// 随机选取一个变换
+void random_transform(PercentSudokuTransform* transform, Rng* rng) {
+    if (transform == NULL || rng == NULL) {
+        return;
+    }
+    
+    int digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    shuffle_array_with_rng(digits, 9, rng);
+    
+    transform->geometry = rng_range(rng, PERCENT_SUDOKU_NUM_GEOMETRIES);
+    transform->digit_map[0] = 0;
+    for (int d = 1; d <= PERCENT_SUDOKU_MAX_NUM; d++) {
+        transform->digit_map[d] = (unsigned char)digits[d - 1];
+    }
+}
+
+// 求逆变换
+void invert_transform(const PercentSudokuTransform* transform, PercentSudokuTransform* inverse) {
+    if (transform == NULL || inverse == NULL) {
+        return;
+    }
+    
+    pthread_once(&geometry_once, init_geometry_tables);
+    inverse->geometry = inverse_geometry[transform->geometry & (PERCENT_SUDOKU_NUM_GEOMETRIES - 1)];
+    inverse->digit_map[0] = 0;
+    for (int d = 1; d <= PERCENT_SUDOKU_MAX_NUM; d++) {
+        inverse->digit_map[transform->digit_map[d]] = (unsigned char)d;
+    }
+}
+
+// 对网格应用变换（数字与给定标记一起移动）
+void apply_transform_grid(const PercentSudokuTransform* transform, const PercentSudokuGrid* in, PercentSudokuGrid* out) {
+    if (transform == NULL || in == NULL || out == NULL) {
+        return;
+    }
+    
+    pthread_once(&geometry_once, init_geometry_tables);
+    const unsigned char* cells = geometry_cells[transform->geometry & (PERCENT_SUDOKU_NUM_GEOMETRIES - 1)];
+    const int* in_values = &in->grid[0][0];
+    const int* in_given = &in->is_given[0][0];
+    int* out_values = &out->grid[0][0];
+    int* out_given = &out->is_given[0][0];
+    
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int num = in_values[cell];
+        int target = cells[cell];
+        out_values[target] = (num >= PERCENT_SUDOKU_MIN_NUM && num <= PERCENT_SUDOKU_MAX_NUM) ?
+                             transform->digit_map[num] : PERCENT_SUDOKU_EMPTY;
+        out_given[target] = in_given[cell];
+    }
+}
+
+// 对游戏（谜题与解答）应用变换
+void apply_transform_game(const PercentSudokuTransform* transform, const PercentSudokuGame* in, PercentSudokuGame* out) {
+    if (transform == NULL || in == NULL || out == NULL) {
+        return;
+    }
+    
+    apply_transform_grid(transform, &in->puzzle, &out->puzzle);
+    apply_transform_grid(transform, &in->solution, &out->solution);
+    out->difficulty = in->difficulty;
+    out->num_givens = in->num_givens;
+}
+
+// 计算规范形式：16种几何变换各取字典序最小的数字标记，再取其中最小者
+void canonicalize_percent_sudoku(const PercentSudokuGrid* grid, CanonicalPuzzle* canonical) {
+    if (grid == NULL || canonical == NULL) {
+        return;
+    }
+    
+    pthread_once(&geometry_once, init_geometry_tables);
+    
+    // 变换前的格子值（越界值视为空格）
+    unsigned char values[NUM_CELLS];
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int num = grid->grid[cell / PERCENT_SUDOKU_SIZE][cell % PERCENT_SUDOKU_SIZE];
+        values[cell] = (num >= PERCENT_SUDOKU_MIN_NUM && num <= PERCENT_SUDOKU_MAX_NUM) ? (unsigned char)num : 0;
+    }
+    
+    int have_best = 0;
+    for (int g = 0; g < PERCENT_SUDOKU_NUM_GEOMETRIES; g++) {
+        // source[dst] 为变换后位置dst的原格子
+        unsigned char source[NUM_CELLS];
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            source[geometry_cells[g][cell]] = (unsigned char)cell;
+        }
+        
+        unsigned char label[10] = {0};
+        unsigned char candidate[NUM_CELLS];
+        int next_label = 1;
+        int order = have_best ? 0 : -1;  // 与当前最优的比较结果，确定更大后提前放弃
+        
+        for (int pos = 0; pos < NUM_CELLS; pos++) {
+            int num = values[source[pos]];
+            if (num != 0 && label[num] == 0) {
+                label[num] = (unsigned char)next_label++;
+            }
+            candidate[pos] = label[num];
+            
+            if (order == 0 && candidate[pos] != canonical->cells[pos]) {
+                order = candidate[pos] < canonical->cells[pos] ? -1 : 1;
+                if (order > 0) {
+                    break;
+                }
+            }
+        }
+        if (order >= 0) {
+            continue;  // 不比当前最优更小
+        }
+        
+        // 未出现的数字按原数字大小依次取剩余的标记，使数字映射成为完整的排列
+        for (int d = 1; d <= PERCENT_SUDOKU_MAX_NUM; d++) {
+            if (label[d] == 0) {
+                label[d] = (unsigned char)next_label++;
+            }
+        }
+        
+        memcpy(canonical->cells, candidate, NUM_CELLS);
+        canonical->to_canonical.geometry = g;
+        memcpy(canonical->to_canonical.digit_map, label, sizeof(label));
+        have_best = 1;
+    }
+    
+    canonical->hash = hash_fnv1a64(canonical->cells, NUM_CELLS);
+}
+
+// 规范形式的64位哈希，等价的谜题哈希值相同
+uint64_t percent_sudoku_canonical_hash(const PercentSudokuGrid* grid) {
+    CanonicalPuzzle canonical;
+    canonicalize_percent_sudoku(grid, &canonical);
+    return canonical.hash;
+}
+
+// 检查几何变换是否把每个约束单元映射为某个约束单元
+int verify_transform_geometry(int geometry) {
+    if (geometry < 0 || geometry >= PERCENT_SUDOKU_NUM_GEOMETRIES) {
+        return 0;
+    }
+    
+    for (int u = 0; u < PERCENT_SUDOKU_NUM_UNITS; u++) {
+        int mapped[9];
+        for (int i = 0; i < 9; i++) {
+            mapped[i] = transform_cell(geometry, PERCENT_SUDOKU_UNITS[u][i]);
+        }
+        
+        int found = 0;
+        for (int v = 0; v < PERCENT_SUDOKU_NUM_UNITS && !found; v++) {
+            int matches = 0;
+            for (int i = 0; i < 9; i++) {
+                for (int j = 0; j < 9; j++) {
+                    if (mapped[i] == PERCENT_SUDOKU_UNITS[v][j]) {
+                        matches++;
+                        break;
+                    }
+                }
+            }
+            found = (matches == 9);
+        }
+        if (!found) {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+// 校验原始谜题：解唯一时返回1，并在没有解答时求出解答
+static int validate_source_puzzle(const PercentSudokuGrid* puzzle, PercentSudokuGrid* solution, int has_solution) {
+    PercentSudokuGrid unique_solution;
+    copy_percent_sudoku_grid(puzzle, &unique_solution);
+    
+    if (count_percent_sudoku_solutions_bitmask(puzzle, 2) != 1 || !solve_percent_sudoku_bitmask(&unique_solution)) {
+        return 0;
+    }
+    if (has_solution && memcmp(solution->grid, unique_solution.grid, sizeof(unique_solution.grid)) != 0) {
+        return 0;  // 附带的解答与唯一解不符
+    }
+    
+    copy_percent_sudoku_grid(&unique_solution, solution);
+    return 1;
+}
+
+// 扩增单行格式文件中的谜题，返回写出的谜题数量（失败返回-1）
+// 每个原始谜题只校验一次（解唯一），此后的变换只是重排格子与数字
+int multiply_puzzle_file(const char* input_file, const char* output_file, int copies, uint64_t seed,
+                         MultiplyReport* report) {
+    if (input_file == NULL || output_file == NULL || copies <= 0 || report == NULL) {
+        print_error("multiply_puzzle_file", COMMON_ERROR_INVALID_PARAMETER, "Invalid parameters");
+        return -1;
+    }
+    
+    memset(report, 0, sizeof(MultiplyReport));
+    
+    PuzzleLineReader reader;
+    if (!open_puzzle_reader(&reader, input_file)) {
+        return -1;
+    }
+    PuzzleLineWriter* writer = open_puzzle_writer(output_file);
+    if (writer == NULL) {
+        close_puzzle_reader(&reader);
+        return -1;
+    }
+    
+    double start_time = get_monotonic_time_ms();
+    PercentSudokuGame source, variant;
+    PercentSudokuTransform transform;
+    Rng rng;
+    int has_solution;
+    int status;
+    
+    memset(&source, 0, sizeof(PercentSudokuGame));
+    while ((status = read_next_puzzle(&reader, &source.puzzle, &source.solution, &has_solution)) != PUZZLE_READ_END) {
+        if (status != PUZZLE_READ_OK || !validate_source_puzzle(&source.puzzle, &source.solution, has_solution)) {
+            report->rejected++;
+            continue;
+        }
+        
+        write_puzzle_line(writer, &source.puzzle, &source.solution);
+        report->written++;
+        
+        rng_seed(&rng, derive_seed(seed, (uint64_t)report->source_puzzles));
+        for (int i = 1; i < copies; i++) {
+            random_transform(&transform, &rng);
+            apply_transform_game(&transform, &source, &variant);
+            write_puzzle_line(writer, &variant.puzzle, &variant.solution);
+            report->written++;
+        }
+        report->source_puzzles++;
+    }
+    
+    report->wall_time_ms = get_monotonic_time_ms() - start_time;
+    if (report->wall_time_ms > 0.0) {
+        report->puzzles_per_second = report->written * 1000.0 / report->wall_time_ms;
+    }
+    
+    int written = close_puzzle_writer(writer);
+    close_puzzle_reader(&reader);
+    return written ? report->written : -1;
+}
+
+// 打印扩增统计
+void print_multiply_report(const MultiplyReport* report) {
+    if (report == NULL) {
+        return;
+    }
+    
+    printf("=== Puzzle Multiplication Report ===\n");
+    printf("Source puzzles: %d (rejected %d)\n", report->source_puzzles, report->rejected);
+    printf("Puzzles written: %d\n", report->written);
+    printf("Wall time: %.2f ms\n", report->wall_time_ms);
+    printf("Throughput: %.1f puzzles/sec\n", report->puzzles_per_second);
+    printf("====================================\n");
+}
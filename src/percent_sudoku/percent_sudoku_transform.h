@@ -0,0 +1,79 @@
+#ifndef PERCENT_SUDOKU_TRANSFORM_H
+#define PERCENT_SUDOKU_TRANSFORM_H
+
+#include "../common/common.h"
+#include "percent_sudoku_core.h"
+
+// 百分号数独的对称变换
+// 保持全部30个约束单元（行、列、宫、撇对角线、两个窗口）不变的变换，把一个有效谜题
+// 映射为另一个有效谜题，解的个数不变，无需重新求解。变换群由两部分组成：
+//   几何变换（16种），由4个生成元按位组合，依次应用：
+//     bit0  交换第1、2行，同时交换第6、7列
+//     bit1  交换第6、7行，同时交换第1、2列
+//     bit2  旋转180度        (r,c) -> (8-r, 8-c)
+//     bit3  主对角线转置      (r,c) -> (c, r)
+//   （撇对角线反射 (r,c) -> (8-c, 8-r) 即 bit2|bit3，它把上窗口映射到下窗口）
+//   数字重标记（9! 种）
+// 变换群共 16 x 9! 个元素，可用 [0, PERCENT_SUDOKU_SYMMETRY_COUNT) 内的序号枚举。
+//
+// 规范形式：对16种几何变换分别按行优先顺序、以数字首次出现的次序重新标记为1、2、3……
+// （这是该几何变换下字典序最小的数字标记），再取16个结果中字典序最小者。
+// 同一等价类中的谜题（互相可由变换得到）有相同的规范形式与哈希值。
+
+#define PERCENT_SUDOKU_NUM_GEOMETRIES 16
+#define PERCENT_SUDOKU_DIGIT_PERMUTATIONS 362880UL
+#define PERCENT_SUDOKU_SYMMETRY_COUNT (PERCENT_SUDOKU_NUM_GEOMETRIES * PERCENT_SUDOKU_DIGIT_PERMUTATIONS)
+
+#define TRANSFORM_SWAP_UPPER 0x1    // 交换第1、2行与第6、7列
+#define TRANSFORM_SWAP_LOWER 0x2    // 交换第6、7行与第1、2列
+#define TRANSFORM_ROTATE 0x4        // 旋转180度
+#define TRANSFORM_TRANSPOSE 0x8     // 主对角线转置
+
+// 一个对称变换
+typedef struct {
+    int geometry;                   // 几何变换编号（0-15）
+    unsigned char digit_map[10];    // 数字d变换为digit_map[d]，digit_map[0] = 0
+} PercentSudokuTransform;
+
+// 规范形式
+typedef struct {
+    unsigned char cells[PERCENT_SUDOKU_SIZE * PERCENT_SUDOKU_SIZE];  // 规范化后的格子（0为空格）
+    PercentSudokuTransform to_canonical;  // 把原网格变为规范形式的变换
+    uint64_t hash;                        // 规范形式的64位哈希
+} CanonicalPuzzle;
+
+// 谜题扩增统计
+typedef struct {
+    int source_puzzles;             // 读取的有效原始谜题
+    int rejected;                   // 无效或解不唯一而被跳过的谜题
+    int written;                    // 写出的谜题
+    double wall_time_ms;
+    double puzzles_per_second;
+} MultiplyReport;
+
+// 函数声明
+
+// 变换的构造与组合
+void init_identity_transform(PercentSudokuTransform* transform);
+void transform_from_index(unsigned long index, PercentSudokuTransform* transform);
+void random_transform(PercentSudokuTransform* transform, Rng* rng);
+void invert_transform(const PercentSudokuTransform* transform, PercentSudokuTransform* inverse);
+int transform_cell(int geometry, int cell);
+
+// 应用变换（in 与 out 不能相同）
+void apply_transform_grid(const PercentSudokuTransform* transform, const PercentSudokuGrid* in, PercentSudokuGrid* out);
+void apply_transform_game(const PercentSudokuTransform* transform, const PercentSudokuGame* in, PercentSudokuGame* out);
+
+// 规范形式与哈希
+void canonicalize_percent_sudoku(const PercentSudokuGrid* grid, CanonicalPuzzle* canonical);
+uint64_t percent_sudoku_canonical_hash(const PercentSudokuGrid* grid);
+
+// 校验：几何变换是否保持全部约束单元
+int verify_transform_geometry(int geometry);
+
+// 谜题扩增：每个原始谜题写出copies个变换后的谜题（第一个为原谜题）
+int multiply_puzzle_file(const char* input_file, const char* output_file, int copies, uint64_t seed,
+                         MultiplyReport* report);
+void print_multiply_report(const MultiplyReport* report);
+
+#endif // PERCENT_SUDOKU_TRANSFORM_H
@@ -0,0 +1,340 @@
+#include "perf_counters.h"
+
+THREAD_LOCAL int perf_counters_active = 0;
+
+static const char* const perf_phase_names[PERF_PHASE_COUNT] = {
+    "parse", "propagation", "branching"
+};
+
+static const char* const perf_counter_names[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "task_clock_ns"
+};
+
+const char* perf_phase_name(PerfPhase phase) {
+    if (phase < 0 || phase >= PERF_PHASE_COUNT) {
+        return "none";
+    }
+    return perf_phase_names[phase];
+}
+
+const char* perf_counter_name(PerfCounter counter) {
+    if (counter < 0 || counter >= PERF_COUNTER_COUNT) {
+        return "unknown";
+    }
+    return perf_counter_names[counter];
+}
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// 组读数：nr, time_enabled, time_running, 之后按打开顺序排列的各计数器值
+#define PERF_READ_HEADER 3
+#define PERF_READ_WORDS (PERF_READ_HEADER + PERF_COUNTER_COUNT)
+
+typedef struct {
+    int group_fd;                                       // 组长的文件描述符
+    int fds[PERF_COUNTER_COUNT];                        // -1 表示未打开
+    int slots[PERF_COUNTER_COUNT];                      // 在组读数中的位置
+    int num_open;
+    PerfPhase phase;                                    // 当前阶段
+    uint64_t last[PERF_READ_WORDS];                     // 上一次的读数
+    uint64_t raw[PERF_PHASE_COUNT][PERF_COUNTER_COUNT]; // 各阶段累计的原始差值
+    uint64_t time_enabled[PERF_PHASE_COUNT];
+    uint64_t time_running[PERF_PHASE_COUNT];
+    long entries[PERF_PHASE_COUNT];
+} PerfState;
+
+static THREAD_LOCAL PerfState perf_state;
+
+static void init_counter_attr(PerfCounter counter, struct perf_event_attr* attr) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->type = PERF_TYPE_HARDWARE;
+    switch (counter) {
+        case PERF_COUNTER_CYCLES:
+            attr->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_COUNTER_INSTRUCTIONS:
+            attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_COUNTER_L1D_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_COUNTER_LLC_MISSES:
+            // 通用的 cache-misses 事件在多数处理器上即末级缓存缺失，比 HW_CACHE_LL 支持得更广
+            attr->config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PERF_COUNTER_BRANCH_MISSES:
+            attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            attr->type = PERF_TYPE_SOFTWARE;
+            attr->config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+    }
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->inherit = 1;
+    attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+
+static int read_counter_group(uint64_t* values) {
+    ssize_t expected = (ssize_t)((PERF_READ_HEADER + perf_state.num_open) * sizeof(uint64_t));
+    ssize_t bytes = read(perf_state.group_fd, values, PERF_READ_WORDS * sizeof(uint64_t));
+    return bytes >= expected;
+}
+
+int perf_counters_start(void) {
+    if (perf_counters_active) {
+        return 1;
+    }
+    
+    memset(&perf_state, 0, sizeof(PerfState));
+    perf_state.group_fd = -1;
+    perf_state.phase = PERF_PHASE_NONE;
+    
+    int first_error = 0;
+    char missing[256] = "";
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        struct perf_event_attr attr;
+        init_counter_attr((PerfCounter)c, &attr);
+        // 组长先停着，打开完整组后一起启动；组员跟随组长
+        attr.disabled = perf_state.group_fd == -1;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, perf_state.group_fd, 0);
+        if (fd < 0) {
+            if (first_error == 0) {
+                first_error = errno;
+            }
+            perf_state.fds[c] = -1;
+            size_t used = strlen(missing);
+            snprintf(missing + used, sizeof(missing) - used, "%s%s", used > 0 ? ", " : "", perf_counter_names[c]);
+            continue;
+        }
+        if (perf_state.group_fd == -1) {
+            perf_state.group_fd = fd;
+        }
+        perf_state.fds[c] = fd;
+        perf_state.slots[c] = perf_state.num_open++;
+    }
+    
+    if (perf_state.num_open == 0) {
+        fprintf(stderr, "Warning: performance counters unavailable (perf_event_open: %s); "
+                "check /proc/sys/kernel/perf_event_paranoid\n", strerror(first_error));
+        return 0;
+    }
+    if (missing[0] != '\0') {
+        fprintf(stderr, "Warning: performance counters not available: %s (perf_event_open: %s)\n",
+                missing, strerror(first_error));
+    }
+    
+    ioctl(perf_state.group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf_state.group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    read_counter_group(perf_state.last);
+    perf_counters_active = 1;
+    return 1;
+}
+
+void perf_phase_switch(PerfPhase phase) {
+    if (!perf_counters_active || phase == perf_state.phase) {
+        return;
+    }
+    
+    // 一次 read 取得整组读数，与上次的差值记到刚结束的阶段
+    uint64_t now[PERF_READ_WORDS];
+    if (read_counter_group(now)) {
+        PerfPhase previous = perf_state.phase;
+        if (previous != PERF_PHASE_NONE) {
+            perf_state.time_enabled[previous] += now[1] - perf_state.last[1];
+            perf_state.time_running[previous] += now[2] - perf_state.last[2];
+            for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+                if (perf_state.fds[c] >= 0) {
+                    int slot = PERF_READ_HEADER + perf_state.slots[c];
+                    perf_state.raw[previous][c] += now[slot] - perf_state.last[slot];
+                }
+            }
+        }
+        memcpy(perf_state.last, now, sizeof(now));
+    }
+    
+    perf_state.phase = phase;
+    if (phase != PERF_PHASE_NONE) {
+        perf_state.entries[phase]++;
+    }
+}
+
+void perf_counters_stop(PerfReport* report) {
+    memset(report, 0, sizeof(PerfReport));
+    if (!perf_counters_active) {
+        return;
+    }
+    
+    perf_phase_switch(PERF_PHASE_NONE);
+    ioctl(perf_state.group_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (perf_state.fds[c] >= 0) {
+            report->available[c] = 1;
+            if (perf_state.fds[c] != perf_state.group_fd) {
+                close(perf_state.fds[c]);
+            }
+        }
+    }
+    close(perf_state.group_fd);
+    perf_counters_active = 0;
+    
+    // 计数器组与其他事件轮流占用PMU时，按 运行时间/启用时间 的比例换算
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        PerfPhaseCounts* counts = &report->phases[p];
+        counts->entries = perf_state.entries[p];
+        if (perf_state.time_running[p] == 0) {
+            continue;
+        }
+        double scale = 1.0;
+        if (perf_state.time_running[p] < perf_state.time_enabled[p]) {
+            scale = (double)perf_state.time_enabled[p] / (double)perf_state.time_running[p];
+            report->multiplexed = 1;
+        }
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            counts->values[c] = perf_state.raw[p][c] * scale;
+        }
+    }
+}
+
+#else
+
+int perf_counters_start(void) {
+    fprintf(stderr, "Warning: performance counters are only supported on Linux\n");
+    return 0;
+}
+
+void perf_phase_switch(PerfPhase phase) {
+    (void)phase;
+}
+
+void perf_counters_stop(PerfReport* report) {
+    memset(report, 0, sizeof(PerfReport));
+}
+
+#endif
+
+// 比值 numerator/denominator*scale，任一计数器不可用或分母为0时返回负数
+static double perf_ratio(const PerfReport* report, int phase, PerfCounter numerator, PerfCounter denominator, double scale) {
+    const PerfPhaseCounts* counts = &report->phases[phase];
+    if (!report->available[numerator] || !report->available[denominator] || counts->values[denominator] <= 0.0) {
+        return -1.0;
+    }
+    return counts->values[numerator] / counts->values[denominator] * scale;
+}
+
+static int perf_report_has_counters(const PerfReport* report) {
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (report->available[c]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void print_perf_value(FILE* out, double value, int available, int width) {
+    if (available) {
+        fprintf(out, " %*.0f", width, value);
+    } else {
+        fprintf(out, " %*s", width, "n/a");
+    }
+}
+
+static void print_perf_ratio(FILE* out, double value, int width, int precision) {
+    if (value >= 0.0) {
+        fprintf(out, " %*.*f", width, precision, value);
+    } else {
+        fprintf(out, " %*s", width, "n/a");
+    }
+}
+
+// 打印各阶段计数与比值（MPKI = 每千条指令的缺失次数）
+void print_perf_report(FILE* out, const PerfReport* report) {
+    if (!perf_report_has_counters(report)) {
+        fprintf(out, "Performance counters unavailable\n");
+        return;
+    }
+    
+    fprintf(out, "%-12s %9s %14s %14s %12s %12s %12s %10s\n", "Phase", "Entries", "Cycles", "Instructions",
+            "L1D misses", "LLC misses", "Br misses", "Time(ms)");
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        const PerfPhaseCounts* counts = &report->phases[p];
+        fprintf(out, "%-12s %9ld", perf_phase_names[p], counts->entries);
+        print_perf_value(out, counts->values[PERF_COUNTER_CYCLES], report->available[PERF_COUNTER_CYCLES], 14);
+        print_perf_value(out, counts->values[PERF_COUNTER_INSTRUCTIONS], report->available[PERF_COUNTER_INSTRUCTIONS], 14);
+        print_perf_value(out, counts->values[PERF_COUNTER_L1D_MISSES], report->available[PERF_COUNTER_L1D_MISSES], 12);
+        print_perf_value(out, counts->values[PERF_COUNTER_LLC_MISSES], report->available[PERF_COUNTER_LLC_MISSES], 12);
+        print_perf_value(out, counts->values[PERF_COUNTER_BRANCH_MISSES], report->available[PERF_COUNTER_BRANCH_MISSES], 12);
+        print_perf_ratio(out, report->available[PERF_COUNTER_TASK_CLOCK] ?
+                         counts->values[PERF_COUNTER_TASK_CLOCK] / 1e6 : -1.0, 10, 3);
+        fprintf(out, "\n");
+    }
+    
+    fprintf(out, "\n%-12s %8s %10s %10s %12s\n", "Phase", "IPC", "L1D MPKI", "LLC MPKI", "Br-miss MPKI");
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        fprintf(out, "%-12s", perf_phase_names[p]);
+        print_perf_ratio(out, perf_ratio(report, p, PERF_COUNTER_INSTRUCTIONS, PERF_COUNTER_CYCLES, 1.0), 8, 2);
+        print_perf_ratio(out, perf_ratio(report, p, PERF_COUNTER_L1D_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0), 10, 2);
+        print_perf_ratio(out, perf_ratio(report, p, PERF_COUNTER_LLC_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0), 10, 2);
+        print_perf_ratio(out, perf_ratio(report, p, PERF_COUNTER_BRANCH_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0), 12, 2);
+        fprintf(out, "\n");
+    }
+    if (report->multiplexed) {
+        fprintf(out, "(counters were multiplexed; values are scaled estimates)\n");
+    }
+}
+
+// 以JSON对象输出，只包含可用的计数器及能算出的比值，indent 为字段的缩进空格数
+void write_perf_report_json(FILE* out, const PerfReport* report, int indent) {
+    fprintf(out, "{\n");
+    fprintf(out, "%*s\"available\": [", indent, "");
+    int first = 1;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (report->available[c]) {
+            fprintf(out, "%s\"%s\"", first ? "" : ", ", perf_counter_names[c]);
+            first = 0;
+        }
+    }
+    fprintf(out, "],\n");
+    fprintf(out, "%*s\"multiplexed\": %s,\n", indent, "", report->multiplexed ? "true" : "false");
+    fprintf(out, "%*s\"phases\": {\n", indent, "");
+    
+    static const struct {
+        const char* name;
+        PerfCounter numerator;
+        PerfCounter denominator;
+        double scale;
+    } ratios[] = {
+        {"ipc", PERF_COUNTER_INSTRUCTIONS, PERF_COUNTER_CYCLES, 1.0},
+        {"l1d_mpki", PERF_COUNTER_L1D_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0},
+        {"llc_mpki", PERF_COUNTER_LLC_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0},
+        {"branch_miss_mpki", PERF_COUNTER_BRANCH_MISSES, PERF_COUNTER_INSTRUCTIONS, 1000.0}
+    };
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        const PerfPhaseCounts* counts = &report->phases[p];
+        fprintf(out, "%*s\"%s\": {\"entries\": %ld", indent + 2, "", perf_phase_names[p], counts->entries);
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (report->available[c]) {
+                fprintf(out, ", \"%s\": %.0f", perf_counter_names[c], counts->values[c]);
+            }
+        }
+        for (size_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+            double value = perf_ratio(report, p, ratios[r].numerator, ratios[r].denominator, ratios[r].scale);
+            if (value >= 0.0) {
+                fprintf(out, ", \"%s\": %.4f", ratios[r].name, value);
+            }
+        }
+        fprintf(out, "}%s\n", p + 1 < PERF_PHASE_COUNT ? "," : "");
+    }
+    fprintf(out, "%*s}\n", indent, "");
+    fprintf(out, "%*s}", indent > 2 ? indent - 2 : 0, "");
+}
@@ -0,0 +1,69 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "../common/common.h"
+
+// 硬件性能计数器（Linux perf_event_open）
+// 在调用线程上打开一组计数器（周期、指令、L1D读缺失、LLC缺失、分支预测失败，外加任务时钟），
+// 按阶段累计：每次 PERF_PHASE 切换阶段时读一次计数器组，把与上次读数的差记到前一个阶段。
+// 计数器带 inherit 标志，之后创建的线程（如并行解析的工作线程）也计入。
+// 没有权限（perf_event_paranoid）、虚拟机不提供PMU或非Linux平台时，打不开的计数器记为不可用，
+// 全部打不开时给出一条警告并关闭，求解照常进行。
+// 默认关闭：关闭时 PERF_PHASE 只是一次线程局部标志判断。
+
+// 计数的阶段
+typedef enum {
+    PERF_PHASE_NONE = -1,       // 不计入任何阶段
+    PERF_PHASE_PARSE = 0,       // 读取与解析CNF
+    PERF_PHASE_PROPAGATION,     // 单子句传播
+    PERF_PHASE_BRANCHING,       // 选择分支变量、复制赋值、冲突后回溯
+    PERF_PHASE_COUNT
+} PerfPhase;
+
+// 计数器
+typedef enum {
+    PERF_COUNTER_CYCLES = 0,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_L1D_MISSES,
+    PERF_COUNTER_LLC_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_TASK_CLOCK,    // 软件事件（纳秒），没有硬件计数器时也可用
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+// 单个阶段的累计值（已按多路复用比例换算）
+typedef struct {
+    long entries;                           // 进入该阶段的次数
+    double values[PERF_COUNTER_COUNT];      // 各计数器的累计值
+} PerfPhaseCounts;
+
+// 一次测量的结果
+typedef struct {
+    int available[PERF_COUNTER_COUNT];      // 计数器是否成功打开
+    int multiplexed;                        // 计数器组未一直在PMU上运行，数值为按比例估计
+    PerfPhaseCounts phases[PERF_PHASE_COUNT];
+} PerfReport;
+
+extern THREAD_LOCAL int perf_counters_active;
+
+#define PERF_PHASE(phase) do { if (perf_counters_active) perf_phase_switch(phase); } while (0)
+
+// 函数声明
+
+// 为当前线程打开计数器并开始计数，至少一个计数器可用时返回1
+int perf_counters_start(void);
+
+// 切换当前阶段（通常经由 PERF_PHASE 调用）
+void perf_phase_switch(PerfPhase phase);
+
+// 结束计数并关闭计数器，把结果写入 report；未开始时 report 中所有计数器都不可用
+void perf_counters_stop(PerfReport* report);
+
+const char* perf_phase_name(PerfPhase phase);
+const char* perf_counter_name(PerfCounter counter);
+
+// 输出各阶段的计数与比值（IPC、每千条指令缺失数MPKI）
+void print_perf_report(FILE* out, const PerfReport* report);
+void write_perf_report_json(FILE* out, const PerfReport* report, int indent);
+
+#endif // PERF_COUNTERS_H
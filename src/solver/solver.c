@@ -1,7 +1,191 @@
 #include "solver.h"
+#include "../trace/trace.h"
+#include "../perf/perf_counters.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// 是否输出详细求解过程（默认开启）
+// 求解状态均为线程局部，多个线程可以同时运行各自的DPLL
+static THREAD_LOCAL int solver_verbose = 1;
+
+#define SOLVER_LOG(...) do { if (solver_verbose) printf(__VA_ARGS__); } while (0)
+
+// 求解统计
+static THREAD_LOCAL SolverStatistics solver_stats;
+
+// 进度报告状态
+typedef struct {
+    int enabled;
+    long conflict_interval;     // 每隔多少次冲突报告（0表示不按冲突）
+    double time_interval_ms;    // 每隔多少毫秒报告（0表示不按时间）
+    long next_conflicts;        // 下一次按冲突报告的冲突数
+    double next_time_ms;        // 下一次按时间报告的时刻
+    double start_time_ms;       // 本次求解开始时刻
+    int countdown;              // 距下一次查看时钟还剩的事件数
+} SolverProgress;
+
+// 读时钟有开销，每隔这么多次决策或冲突才查看一次是否到了报告时间
+#define PROGRESS_CLOCK_CHECK_EVENTS 64
+
+static THREAD_LOCAL SolverProgress solver_progress;
+
+// 求解时限：每次DPLL开始时按 timeout_ms 定下截止时刻
+typedef struct {
+    double timeout_ms;          // 0表示不限时
+    double deadline_ms;         // 本次求解的截止时刻
+    int countdown;              // 距下一次查看时钟还剩的节点数
+    int expired;
+} SolverDeadline;
+
+// 与进度报告一样，每隔若干个搜索节点才读一次时钟
+#define DEADLINE_CLOCK_CHECK_NODES 64
+
+static THREAD_LOCAL SolverDeadline solver_deadline;
+
+// 各层分支的赋值副本从区域中分配，回溯时回退，一次求解结束后整体释放
+#define DPLL_ARENA_CHUNK_SIZE (256 * 1024)
+static THREAD_LOCAL Arena dpll_arena;
+
+// 设置/获取详细输出开关
+void set_solver_verbose(int verbose) {
+    solver_verbose = verbose;
+}
+
+int get_solver_verbose(void) {
+    return solver_verbose;
+}
+
+// 设置进度报告间隔，两者都为0时关闭
+void set_solver_progress(long conflict_interval, double interval_seconds) {
+    solver_progress.conflict_interval = conflict_interval > 0 ? conflict_interval : 0;
+    solver_progress.time_interval_ms = interval_seconds > 0 ? interval_seconds * 1000.0 : 0.0;
+    solver_progress.enabled = solver_progress.conflict_interval > 0 || solver_progress.time_interval_ms > 0;
+}
+
+// 输出一行进度：先格式化到缓冲区再一次写入标准错误，不经过stdio的锁
+static void report_progress(const Formula* formula, const int* assignments, double now) {
+    int trail = 0;
+    for (int i = 0; i < formula->num_vars; i++) {
+        trail += assignments[i] != UNASSIGNED;
+    }
+    MemoryStats memory;
+    get_total_memory_stats(&memory);
+    
+    double elapsed = (now - solver_progress.start_time_ms) / 1000.0;
+    char line[256];
+    int length = snprintf(line, sizeof(line),
+                          "c progress %8.1fs  conflicts %10ld  decisions/s %10.0f  trail %7d/%-7d  learned %ld  mem %.1f MB\n",
+                          elapsed, solver_stats.conflicts, elapsed > 0 ? solver_stats.decisions / elapsed : 0.0,
+                          trail, formula->num_vars, solver_stats.learned_clauses, memory.current_bytes / (1024.0 * 1024.0));
+    if (length > (int)sizeof(line) - 1) {
+        length = (int)sizeof(line) - 1;
+    }
+#ifdef _WIN32
+    fwrite(line, 1, (size_t)length, stderr);
+#else
+    if (write(STDERR_FILENO, line, (size_t)length) < 0) {
+        solver_progress.enabled = 0;
+    }
+#endif
+}
+
+// 设置/获取求解时限（秒），0 或负数表示不限时
+void set_solver_timeout(double seconds) {
+    solver_deadline.timeout_ms = seconds > 0 ? seconds * 1000.0 : 0.0;
+}
+
+double get_solver_timeout(void) {
+    return solver_deadline.timeout_ms / 1000.0;
+}
+
+// 是否已超过截止时刻（仅在设置了时限时调用）
+static int deadline_expired(void) {
+    if (solver_deadline.expired) {
+        return 1;
+    }
+    if (--solver_deadline.countdown > 0) {
+        return 0;
+    }
+    solver_deadline.countdown = DEADLINE_CLOCK_CHECK_NODES;
+    solver_deadline.expired = get_monotonic_time_ms() >= solver_deadline.deadline_ms;
+    return solver_deadline.expired;
+}
+
+// 在决策和冲突处调用（仅在开启进度报告时），判断是否到了报告的时候
+static void progress_tick(const Formula* formula, const int* assignments) {
+    int due = solver_progress.conflict_interval > 0 && solver_stats.conflicts >= solver_progress.next_conflicts;
+    if (!due) {
+        if (--solver_progress.countdown > 0 || solver_progress.time_interval_ms <= 0) {
+            return;
+        }
+        solver_progress.countdown = PROGRESS_CLOCK_CHECK_EVENTS;
+    }
+    
+    double now = get_monotonic_time_ms();
+    if (!due && now < solver_progress.next_time_ms) {
+        return;
+    }
+    report_progress(formula, assignments, now);
+    solver_progress.next_conflicts = solver_stats.conflicts + solver_progress.conflict_interval;
+    solver_progress.next_time_ms = now + solver_progress.time_interval_ms;
+}
+
+// 获取/清零DPLL分支决策次数
+long get_dpll_decision_count(void) {
+    return solver_stats.decisions;
+}
+
+void reset_dpll_decision_count(void) {
+    solver_stats.decisions = 0;
+}
+
+// 清零/获取求解统计
+void reset_solver_statistics(void) {
+    memset(&solver_stats, 0, sizeof(SolverStatistics));
+}
+
+void get_solver_statistics(SolverStatistics* stats) {
+    *stats = solver_stats;
+}
+
+// 每秒传播次数（耗时为0时返回0）
+double solver_propagations_per_second(const SolverStatistics* stats) {
+    if (stats->solve_time_ms <= 0.0) {
+        return 0.0;
+    }
+    return stats->propagations / (stats->solve_time_ms / 1000.0);
+}
+
+// 打印求解统计摘要
+void print_solver_statistics(FILE* out, const SolverStatistics* stats) {
+    fprintf(out, "Decisions: %ld\n", stats->decisions);
+    fprintf(out, "Propagations: %ld (%.0f/sec)\n", stats->propagations, solver_propagations_per_second(stats));
+    fprintf(out, "Conflicts: %ld\n", stats->conflicts);
+    fprintf(out, "Restarts: %ld\n", stats->restarts);
+    fprintf(out, "Learned clauses: %ld\n", stats->learned_clauses);
+    fprintf(out, "Max depth: %d\n", stats->max_depth);
+    fprintf(out, "Solve time: %.3f ms\n", stats->solve_time_ms);
+    fprintf(out, "Peak memory: %.1f KB\n", stats->peak_memory_bytes / 1024.0);
+}
+
+// 以JSON对象输出求解统计，indent 为字段的缩进空格数
+void write_solver_statistics_json(FILE* out, const SolverStatistics* stats, int indent) {
+    fprintf(out, "{\n");
+    fprintf(out, "%*s\"decisions\": %ld,\n", indent, "", stats->decisions);
+    fprintf(out, "%*s\"propagations\": %ld,\n", indent, "", stats->propagations);
+    fprintf(out, "%*s\"conflicts\": %ld,\n", indent, "", stats->conflicts);
+    fprintf(out, "%*s\"restarts\": %ld,\n", indent, "", stats->restarts);
+    fprintf(out, "%*s\"learned_clauses\": %ld,\n", indent, "", stats->learned_clauses);
+    fprintf(out, "%*s\"max_depth\": %d,\n", indent, "", stats->max_depth);
+    fprintf(out, "%*s\"solve_time_ms\": %.3f,\n", indent, "", stats->solve_time_ms);
+    fprintf(out, "%*s\"propagations_per_second\": %.1f,\n", indent, "", solver_propagations_per_second(stats));
+    fprintf(out, "%*s\"peak_memory_bytes\": %llu\n", indent, "", (unsigned long long)stats->peak_memory_bytes);
+    fprintf(out, "%*s}", indent > 2 ? indent - 2 : 0, "");
+}
 
 // 检查子句是否满足（至少有一个文字为真）
 int is_clause_satisfied(const Clause* clause, const int* assignments) {
@@ -77,16 +261,16 @@ int is_unit_clause(const Clause* clause, const int* assignments, int* unit_liter
 }
 
 // 单子句传播
-int unit_propagation(Formula* formula, int* assignments) {
+int unit_propagation(const Formula* formula, int* assignments) {
     int changed = 1;
     int iteration = 0;
     
-    printf("Starting unit propagation...\n");
+    SOLVER_LOG("Starting unit propagation...\n");
     
     while (changed) {
         changed = 0;
         iteration++;
-        printf("  Propagation iteration %d\n", iteration);
+        SOLVER_LOG("  Propagation iteration %d\n", iteration);
         
         for (int i = 0; i < formula->num_clauses; i++) {
             const Clause* clause = &formula->clauses[i];
@@ -98,7 +282,7 @@ int unit_propagation(Formula* formula, int* assignments) {
             
             // 检查冲突
             if (is_clause_conflict(clause, assignments)) {
-                printf("  Conflict detected! Clause %d all literals are false\n", i);
+                SOLVER_LOG("  Conflict detected! Clause %d all literals are false\n", i);
                 return UNSAT;
             }
             
@@ -108,26 +292,27 @@ int unit_propagation(Formula* formula, int* assignments) {
                 int var = abs(unit_literal);
                 int value = (unit_literal > 0) ? TRUE : FALSE;
                 
-                printf("  Unit clause found! Clause %d: literal %d, variable %d assigned to %s\n", 
+                SOLVER_LOG("  Unit clause found! Clause %d: literal %d, variable %d assigned to %s\n", 
                        i, unit_literal, var, (value == TRUE) ? "TRUE" : "FALSE");
                 
                 assignments[var - 1] = value;
+                solver_stats.propagations++;
                 changed = 1;
                 
                 // 检查是否所有子句都满足
                 if (is_formula_satisfied(formula, assignments)) {
-                    printf("  All clauses are satisfied!\n");
+                    SOLVER_LOG("  All clauses are satisfied!\n");
                     return SAT;
                 }
             }
         }
         
         if (changed) {
-            printf("  Assignment updated, continuing propagation...\n");
+            SOLVER_LOG("  Assignment updated, continuing propagation...\n");
         }
     }
     
-    printf("Unit propagation completed, %d iterations total\n", iteration);
+    SOLVER_LOG("Unit propagation completed, %d iterations total\n", iteration);
     return -1; // 既不是SAT也不是UNSAT，需要继续分支
 }
 
@@ -153,7 +338,7 @@ int select_branching_variable(const Formula* formula, const int* assignments) {
 
 // 创建赋值数组的副本
 int* copy_assignments(const Formula* formula, const int* assignments) {
-    int* new_assignments = (int*)safe_malloc(formula->num_vars * sizeof(int));
+    int* new_assignments = (int*)tracked_malloc(MEMORY_SOLVER, formula->num_vars * sizeof(int));
     
     memcpy(new_assignments, assignments, formula->num_vars * sizeof(int));
     return new_assignments;
@@ -174,23 +359,40 @@ void print_assignments(const Formula* formula, const int* assignments) {
     printf("\n");
 }
 
-// 主要的DPLL函数
-int DPLL(Formula* formula, int* assignments) {
-    static int recursion_depth = 0;
+// DPLL递归搜索
+static int dpll_search(const Formula* formula, int* assignments) {
+    static THREAD_LOCAL int recursion_depth = 0;
     recursion_depth++;
+    if (recursion_depth > solver_stats.max_depth) {
+        solver_stats.max_depth = recursion_depth;
+    }
+    
+    // 超过时限时逐层返回 TIMEOUT
+    if (solver_deadline.timeout_ms > 0 && deadline_expired()) {
+        recursion_depth--;
+        return TIMEOUT;
+    }
     
-    printf("\n=== DPLL Recursive Call %d ===\n", recursion_depth);
-    print_assignments(formula, assignments);
+    SOLVER_LOG("\n=== DPLL Recursive Call %d ===\n", recursion_depth);
+    if (solver_verbose) {
+        print_assignments(formula, assignments);
+    }
     
     // 步骤1: 单子句传播
+    PERF_PHASE(PERF_PHASE_PROPAGATION);
     int propagation_result = unit_propagation(formula, assignments);
+    PERF_PHASE(PERF_PHASE_BRANCHING);
     if (propagation_result == SAT) {
-        printf("=== Solution found! ===\n");
+        SOLVER_LOG("=== Solution found! ===\n");
         recursion_depth--;
         return SAT;
     }
     if (propagation_result == UNSAT) {
-        printf("=== Conflict detected, backtracking ===\n");
+        SOLVER_LOG("=== Conflict detected, backtracking ===\n");
+        solver_stats.conflicts++;
+        if (solver_progress.enabled) {
+            progress_tick(formula, assignments);
+        }
         recursion_depth--;
         return UNSAT;
     }
@@ -198,52 +400,107 @@ int DPLL(Formula* formula, int* assignments) {
     // 步骤2: 选择分支变量
     int branch_var = select_branching_variable(formula, assignments);
     if (branch_var == -1) {
-        printf("=== All variables assigned, checking satisfaction ===\n");
+        SOLVER_LOG("=== All variables assigned, checking satisfaction ===\n");
         if (is_formula_satisfied(formula, assignments)) {
-            printf("=== Solution found! ===\n");
+            SOLVER_LOG("=== Solution found! ===\n");
             recursion_depth--;
             return SAT;
         } else {
-            printf("=== Not satisfied, backtracking ===\n");
+            SOLVER_LOG("=== Not satisfied, backtracking ===\n");
+            solver_stats.conflicts++;
+            if (solver_progress.enabled) {
+                progress_tick(formula, assignments);
+            }
             recursion_depth--;
             return UNSAT;
         }
     }
     
-    printf("Selecting branching variable: %d\n", branch_var);
+    SOLVER_LOG("Selecting branching variable: %d\n", branch_var);
+    solver_stats.decisions++;
+    if (solver_progress.enabled) {
+        progress_tick(formula, assignments);
+    }
     
     // 步骤3: 尝试分支变量为真
-    printf("Trying variable %d = TRUE\n", branch_var);
-    int* new_assignments = copy_assignments(formula, assignments);
+    SOLVER_LOG("Trying variable %d = TRUE\n", branch_var);
+    ArenaMark mark = arena_mark(&dpll_arena);
+    int* new_assignments = (int*)arena_alloc(&dpll_arena, formula->num_vars * sizeof(int));
+    memcpy(new_assignments, assignments, formula->num_vars * sizeof(int));
     new_assignments[branch_var - 1] = TRUE;
     
-    int result = DPLL(formula, new_assignments);
+    int result = dpll_search(formula, new_assignments);
+    PERF_PHASE(PERF_PHASE_BRANCHING);
+    if (result == TIMEOUT) {
+        arena_release(&dpll_arena, mark);
+        recursion_depth--;
+        return TIMEOUT;
+    }
     if (result == SAT) {
         // 复制解到原始赋值数组
         memcpy(assignments, new_assignments, formula->num_vars * sizeof(int));
-        safe_free(new_assignments);
-        printf("=== Variable %d = TRUE found solution! ===\n", branch_var);
+        arena_release(&dpll_arena, mark);
+        SOLVER_LOG("=== Variable %d = TRUE found solution! ===\n", branch_var);
         recursion_depth--;
         return SAT;
     }
     
     // 步骤4: 尝试分支变量为假
-    printf("Variable %d = TRUE failed, trying variable %d = FALSE\n", branch_var, branch_var);
+    SOLVER_LOG("Variable %d = TRUE failed, trying variable %d = FALSE\n", branch_var, branch_var);
+    // 真分支的传播已修改过new_assignments，需从当前节点的赋值重新开始
+    memcpy(new_assignments, assignments, formula->num_vars * sizeof(int));
     new_assignments[branch_var - 1] = FALSE;
     
-    result = DPLL(formula, new_assignments);
+    result = dpll_search(formula, new_assignments);
+    PERF_PHASE(PERF_PHASE_BRANCHING);
+    if (result == TIMEOUT) {
+        arena_release(&dpll_arena, mark);
+        recursion_depth--;
+        return TIMEOUT;
+    }
     if (result == SAT) {
         // 复制解到原始赋值数组
         memcpy(assignments, new_assignments, formula->num_vars * sizeof(int));
-        safe_free(new_assignments);
-        printf("=== Variable %d = FALSE found solution! ===\n", branch_var);
+        arena_release(&dpll_arena, mark);
+        SOLVER_LOG("=== Variable %d = FALSE found solution! ===\n", branch_var);
         recursion_depth--;
         return SAT;
     }
     
     // 两个分支都失败
-    safe_free(new_assignments);
-    printf("=== Both branches of variable %d failed, backtracking ===\n", branch_var);
+    arena_release(&dpll_arena, mark);
+    SOLVER_LOG("=== Both branches of variable %d failed, backtracking ===\n", branch_var);
     recursion_depth--;
     return UNSAT;
 }
+
+// 主要的DPLL函数（设置了时限且超时时返回 TIMEOUT）
+int DPLL(const Formula* formula, int* assignments) {
+    TRACE_BEGIN("solver", "DPLL");
+    double start_time = get_monotonic_time_ms();
+    if (solver_progress.enabled) {
+        solver_progress.start_time_ms = start_time;
+        solver_progress.next_time_ms = start_time + solver_progress.time_interval_ms;
+        solver_progress.next_conflicts = solver_stats.conflicts + solver_progress.conflict_interval;
+        solver_progress.countdown = PROGRESS_CLOCK_CHECK_EVENTS;
+    }
+    if (solver_deadline.timeout_ms > 0) {
+        solver_deadline.deadline_ms = start_time + solver_deadline.timeout_ms;
+        solver_deadline.countdown = 1;
+        solver_deadline.expired = 0;
+    }
+    arena_init(&dpll_arena, MEMORY_SOLVER, DPLL_ARENA_CHUNK_SIZE, 0);
+    int result = dpll_search(formula, assignments);
+    PERF_PHASE(PERF_PHASE_NONE);
+    
+    // 分支赋值区释放前记录内存峰值
+    MemoryStats memory;
+    get_total_memory_stats(&memory);
+    if (memory.peak_bytes > solver_stats.peak_memory_bytes) {
+        solver_stats.peak_memory_bytes = memory.peak_bytes;
+    }
+    arena_destroy(&dpll_arena);
+    solver_stats.solve_time_ms += get_monotonic_time_ms() - start_time;
+    TRACE_END("solver", "DPLL");
+    return result;
+}
@@ -14,11 +14,52 @@
 #define FALSE 0
 #define TRUE 1
 
+// 详细输出开关（关闭后DPLL不再打印每个节点的过程）
+void set_solver_verbose(int verbose);
+int get_solver_verbose(void);
+
+// 求解统计：由DPLL在求解过程中维护（每个线程一份，计数只是普通的自增），
+// 多次调用DPLL时累加，直到 reset_solver_statistics。
+// DPLL不重启、不学习子句，restarts 与 learned_clauses 始终为0，保留是为了与其他求解器的统计口径一致。
+typedef struct {
+    long decisions;             // 分支决策次数
+    long propagations;          // 单子句传播赋值次数
+    long conflicts;             // 冲突次数（回溯次数）
+    long restarts;              // 重启次数
+    long learned_clauses;       // 学习子句数
+    int max_depth;              // 最大递归深度
+    double solve_time_ms;       // DPLL耗时（单调时钟，毫秒）
+    uint64_t peak_memory_bytes; // 求解结束时已统计内存（见 common 的分配统计）的峰值
+} SolverStatistics;
+
+void reset_solver_statistics(void);
+void get_solver_statistics(SolverStatistics* stats);
+double solver_propagations_per_second(const SolverStatistics* stats);
+void print_solver_statistics(FILE* out, const SolverStatistics* stats);
+void write_solver_statistics_json(FILE* out, const SolverStatistics* stats, int indent);
+
+// 进度报告（默认关闭）：求解过程中每隔 conflict_interval 次冲突或 interval_seconds 秒，
+// 向标准错误输出一行状态（已用时间、冲突数、每秒决策数、已赋值变量数、学习子句数、内存）。
+// 两个间隔都为0时关闭；关闭时搜索中只多一次分支判断。设置只对当前线程有效。
+#define SOLVER_PROGRESS_DEFAULT_CONFLICTS 10000
+#define SOLVER_PROGRESS_DEFAULT_SECONDS 1.0
+
+void set_solver_progress(long conflict_interval, double interval_seconds);
+
+// 求解时限（默认不限时）：每次调用DPLL重新计时，超过 seconds 秒后停止搜索并返回 TIMEOUT。
+// 0 表示不限时；设置只对当前线程有效。
+void set_solver_timeout(double seconds);
+double get_solver_timeout(void);
+
+// 分支决策次数统计
+long get_dpll_decision_count(void);
+void reset_dpll_decision_count(void);
+
 // 主要DPLL函数
-int DPLL(Formula* formula, int* assignments);
+int DPLL(const Formula* formula, int* assignments);
 
 // 单子句传播函数
-int unit_propagation(Formula* formula, int* assignments);
+int unit_propagation(const Formula* formula, int* assignments);
 
 // 检查子句是否满足
 int is_clause_satisfied(const Clause* clause, const int* assignments);
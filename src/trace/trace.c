@@ -0,0 +1,201 @@
+#include "trace.h"
+#include <pthread.h>
+
+int trace_enabled = 0;
+
+// 单个事件
+typedef struct {
+    const char* category;
+    const char* name;
+    double timestamp_us;    // 相对 trace_start 的时间（微秒）
+    char phase;             // 'B' 开始，'E' 结束
+} TraceEvent;
+
+#define TRACE_BLOCK_EVENTS 4096
+
+// 事件按块追加，块满后再申请新块，已记录的事件不会移动
+typedef struct TraceBlock {
+    struct TraceBlock* next;
+    int count;
+    TraceEvent events[TRACE_BLOCK_EVENTS];
+} TraceBlock;
+
+// 每个线程一个缓冲区：首次记录时登记到全局链表，线程退出后仍保留，直到输出
+typedef struct TraceBuffer {
+    struct TraceBuffer* next;
+    int thread_id;
+    const char* thread_name;
+    TraceBlock* first;
+    TraceBlock* last;
+    long num_events;
+    long dropped;
+    long open_spans;        // 已记录开始、尚未记录结束的事件数，为它们的结束事件预留位置
+    long skipped_depth;     // 未记录的开始事件嵌套深度，其内部及对应的结束事件一并丢弃
+} TraceBuffer;
+
+static TraceBuffer* trace_buffers = NULL;
+static int trace_next_thread_id = 1;
+static int trace_generation = 0;        // 每次输出后加一，使各线程缓存的缓冲区指针失效
+static double trace_start_ms = 0.0;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static THREAD_LOCAL TraceBuffer* thread_buffer = NULL;
+static THREAD_LOCAL int thread_generation = -1;
+
+// 取得当前线程的缓冲区，没有时创建并登记
+static TraceBuffer* get_thread_buffer(void) {
+    if (thread_buffer != NULL && thread_generation == trace_generation) {
+        return thread_buffer;
+    }
+    
+    TraceBuffer* buffer = (TraceBuffer*)safe_malloc(sizeof(TraceBuffer));
+    memset(buffer, 0, sizeof(TraceBuffer));
+    
+    pthread_mutex_lock(&trace_mutex);
+    buffer->thread_id = trace_next_thread_id++;
+    buffer->next = trace_buffers;
+    trace_buffers = buffer;
+    pthread_mutex_unlock(&trace_mutex);
+    
+    thread_buffer = buffer;
+    thread_generation = trace_generation;
+    return buffer;
+}
+
+// 达到上限时按整个区间丢弃：开始事件只有在连同所有未结束区间的结束事件都放得下时才记录，
+// 这样输出的 B/E 总是成对的
+static void record_event(const char* category, const char* name, char phase) {
+    TraceBuffer* buffer = get_thread_buffer();
+    if (phase == 'B') {
+        if (buffer->skipped_depth > 0 ||
+            buffer->num_events + buffer->open_spans + 2 > TRACE_MAX_EVENTS_PER_THREAD) {
+            buffer->skipped_depth++;
+            buffer->dropped++;
+            return;
+        }
+        buffer->open_spans++;
+    } else if (buffer->skipped_depth > 0) {
+        buffer->skipped_depth--;
+        buffer->dropped++;
+        return;
+    } else if (buffer->open_spans > 0) {
+        buffer->open_spans--;
+    } else if (buffer->num_events >= TRACE_MAX_EVENTS_PER_THREAD) {
+        buffer->dropped++;
+        return;
+    }
+    
+    TraceBlock* block = buffer->last;
+    if (block == NULL || block->count == TRACE_BLOCK_EVENTS) {
+        block = (TraceBlock*)safe_malloc(sizeof(TraceBlock));
+        block->next = NULL;
+        block->count = 0;
+        if (buffer->last != NULL) {
+            buffer->last->next = block;
+        } else {
+            buffer->first = block;
+        }
+        buffer->last = block;
+    }
+    
+    TraceEvent* event = &block->events[block->count++];
+    event->category = category;
+    event->name = name;
+    event->timestamp_us = (get_monotonic_time_ms() - trace_start_ms) * 1000.0;
+    event->phase = phase;
+    buffer->num_events++;
+}
+
+void trace_start(void) {
+    trace_start_ms = get_monotonic_time_ms();
+    trace_enabled = 1;
+    trace_set_thread_name("main");
+}
+
+void trace_begin(const char* category, const char* name) {
+    record_event(category, name, 'B');
+}
+
+void trace_end(const char* category, const char* name) {
+    record_event(category, name, 'E');
+}
+
+void trace_set_thread_name(const char* name) {
+    if (trace_enabled) {
+        get_thread_buffer()->thread_name = name;
+    }
+}
+
+// 释放所有缓冲区（调用方持有 trace_mutex）
+static void free_trace_buffers(void) {
+    TraceBuffer* buffer = trace_buffers;
+    while (buffer != NULL) {
+        TraceBuffer* next_buffer = buffer->next;
+        TraceBlock* block = buffer->first;
+        while (block != NULL) {
+            TraceBlock* next_block = block->next;
+            safe_free(block);
+            block = next_block;
+        }
+        safe_free(buffer);
+        buffer = next_buffer;
+    }
+    trace_buffers = NULL;
+    trace_next_thread_id = 1;
+    trace_generation++;
+}
+
+int trace_write_file(const char* path) {
+    if (path == NULL) {
+        print_error("trace_write_file", COMMON_ERROR_INVALID_PARAMETER, "Trace path is NULL");
+        return 0;
+    }
+    trace_enabled = 0;
+    
+    pthread_mutex_lock(&trace_mutex);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        print_error("trace_write_file", COMMON_ERROR_FILE_NOT_FOUND, "Cannot create trace file");
+        free_trace_buffers();
+        pthread_mutex_unlock(&trace_mutex);
+        return 0;
+    }
+    
+    fprintf(file, "{\"traceEvents\": [\n");
+    int first_event = 1;
+    long dropped = 0;
+    for (TraceBuffer* buffer = trace_buffers; buffer != NULL; buffer = buffer->next) {
+        // 线程名元数据
+        char default_name[32];
+        snprintf(default_name, sizeof(default_name), "thread %d", buffer->thread_id);
+        fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+                first_event ? "" : ",\n", buffer->thread_id);
+        write_json_string(file, buffer->thread_name != NULL ? buffer->thread_name : default_name);
+        fprintf(file, "}}");
+        first_event = 0;
+        
+        for (const TraceBlock* block = buffer->first; block != NULL; block = block->next) {
+            for (int i = 0; i < block->count; i++) {
+                const TraceEvent* event = &block->events[i];
+                fprintf(file, ",\n{\"name\": ");
+                write_json_string(file, event->name);
+                fprintf(file, ", \"cat\": ");
+                write_json_string(file, event->category);
+                fprintf(file, ", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d}",
+                        event->phase, event->timestamp_us, buffer->thread_id);
+            }
+        }
+        dropped += buffer->dropped;
+    }
+    fprintf(file, "\n],\n\"displayTimeUnit\": \"ms\"}\n");
+    int ok = fclose(file) == 0;
+    
+    free_trace_buffers();
+    pthread_mutex_unlock(&trace_mutex);
+    
+    if (dropped > 0) {
+        fprintf(stderr, "Warning: %ld trace events dropped (more than %d per thread)\n",
+                dropped, TRACE_MAX_EVENTS_PER_THREAD);
+    }
+    return ok;
+}
@@ -0,0 +1,35 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "../common/common.h"
+
+// 阶段追踪
+// 记录各阶段的开始/结束事件（单调时钟，微秒），每个线程写自己的缓冲区，不加锁；
+// 结束时整体输出为 Chrome trace-event JSON，可用 chrome://tracing、Perfetto 或
+// speedscope 打开（同一线程内的事件按嵌套关系显示为火焰图）。
+// 默认关闭：关闭时 TRACE_BEGIN/TRACE_END 只是一次全局标志判断。
+// 事件名与类别只保存指针，必须是字符串常量（或在输出前一直有效的字符串）。
+
+#define TRACE_MAX_EVENTS_PER_THREAD (1 << 20)  // 每个线程最多记录的事件数，超出时整个区间丢弃并计数
+
+extern int trace_enabled;
+
+#define TRACE_BEGIN(category, name) do { if (trace_enabled) trace_begin(category, name); } while (0)
+#define TRACE_END(category, name) do { if (trace_enabled) trace_end(category, name); } while (0)
+
+// 函数声明
+
+// 开始记录（须在启动工作线程之前调用），之后的事件时间相对于此刻
+void trace_start(void);
+
+// 记录事件（通常经由 TRACE_BEGIN/TRACE_END 调用）
+void trace_begin(const char* category, const char* name);
+void trace_end(const char* category, const char* name);
+
+// 为当前线程命名，显示在追踪视图中（默认为 "thread N"）
+void trace_set_thread_name(const char* name);
+
+// 把所有线程的事件写成JSON文件并停止记录，成功返回1（须在工作线程结束之后调用）
+int trace_write_file(const char* path);
+
+#endif // TRACE_H